@@ -11,7 +11,9 @@
 
 // ==================== 系统配置 ====================
 
+#ifndef DEBUG_ENABLED
 #define DEBUG_ENABLED 1
+#endif
 
 #if DEBUG_ENABLED
     #define DEBUG_PRINT(x) Serial.print(x)
@@ -64,6 +66,50 @@ const char* const MODE_NAMES[] = {
 
 #define UWB_BAUD_RATE 115200
 
+// UWB串口输出格式 (编译期选择，热路径只运行一种解析器)
+#define UWB_FORMAT_BINARY 0         // MK8000 二进制帧 F0 05 addr dist rssi AA
+#define UWB_FORMAT_ASCII 1          // ASCII 十进制 "d: 120cm"
+#define UWB_FORMAT_HEX 2            // AT 十六进制 "mc 0f 00000a3c"
+#define UWB_FORMAT_MIXED 3          // 旧版兼容: 每字节同时尝试所有格式
+#define UWB_FORMAT_AUTO 4           // 启动时自动检测并锁定
+#define UWB_WIRE_FORMAT UWB_FORMAT_AUTO
+#define UWB_FORMAT_DETECT_FRAMES 5  // 自动检测: 某格式连续成功该次数后锁定
+
+#define UWB_ANCHOR_COUNT 2  // 基站(串口)数量
+
+// 每个基站一路串口，按基站编号排列，行数须等于 UWB_ANCHOR_COUNT:
+//   X(编号, 轮询模式串口对象, 接收任务 UART 端口, RX引脚, TX引脚)
+// ESP32 共 3 路 UART，UART0 为烧录与串口命令/调试输出；第三个基站需改用串口扩展芯片，
+// 或占用 UART0 (Serial, UART_NUM_0) 并放弃串口命令与调试输出
+#define UWB_ANCHOR_PORTS(X) \
+    X(0, Serial2, UART_NUM_2, UWB0_RX_PIN, UWB0_TX_PIN) \
+    X(1, Serial1, UART_NUM_1, UWB1_RX_PIN, UWB1_TX_PIN)
+
+// UWB后台接收任务 (ESP-IDF UART驱动事件队列)
+// 1=独立任务接收，loop阻塞时不丢数据; 0=在loop中轮询Serial1/Serial2 (主机端回放使用)
+#ifndef UWB_RX_TASK_ENABLED
+#define UWB_RX_TASK_ENABLED 1
+#endif
+#define UWB_RX_TASK_CORE 0          // 任务绑定的CPU核 (Arduino loop 在核1)
+#define UWB_RX_TASK_PRIORITY 5
+#define UWB_RX_TASK_STACK 4096
+#define UWB_RX_BUFFER_SIZE 1024     // 每路UART驱动接收缓冲 (字节)
+#define UWB_RX_EVENT_QUEUE_LEN 20
+#define UWB_RX_TIMEOUT_SYMBOLS 2    // 接收超时中断阈值 (字符时间)
+#define UWB_FRAME_TAIL 0xAA         // 二进制帧尾，用于UART模式检测
+#define UWB_SAMPLE_QUEUE_LEN 32     // 距离样本队列长度
+
+// UWB链路健康统计 (U 命令查看)
+#define UWB_LINK_HIST_BIN_MS 10     // 样本间隔直方图每格宽度 (ms)
+#define UWB_LINK_HIST_BINS 16       // 格数，最后一格收集所有更长的间隔
+#define UWB_LINK_RATE_WINDOW_MS 1000 // 帧率统计窗口 (ms)
+
+// UWB飞行记录 (原始串口字节 + 时间戳，G 命令导出，tools/uwb_replay.cpp 回放)
+#ifndef UWB_LOG_ENABLED
+#define UWB_LOG_ENABLED 1
+#endif
+#define UWB_LOG_BUFFER_SIZE 16384   // RAM 环形缓冲 (字节)，二进制帧约可保存 30 s
+
 // --- 电机控制 (L298N 全速模式) ---
 // ⚠️ ENA/ENB 插上跳线帽，不接ESP32
 #define MOTOR_LEFT_IN1  5   // 左电机正转
@@ -106,6 +152,55 @@ const char* const MODE_NAMES[] = {
 #define UWB_HEX_SCALE 0.1f          // 十六进制距离缩放(常见为mm -> cm)
 #define UWB_ANGLE_INVERT 1          // 1=角度取反(左右传感器相反时)
 #define UWB_ANGLE_OFFSET 0.0f       // 角度零点偏置(度)
+#define UWB_PAIR_MAX_SKEW_US 20000  // 两基站样本直接配对的最大时间差 (us)
+#define UWB_PAIR_INTERPOLATE 1      // 1=时间差过大时将较新基站的距离插值到另一基站的采样时刻
+#define UWB_PAIR_MAX_SPAN_US 300000 // 插值所用相邻两样本的最大间隔 (us)
+#define UWB_ANCHOR_TIMEOUT_MS 1000  // 单个基站无数据判定失联 (ms)
+
+// 基站坐标 (cm)，x 向右、y 向前，原点为车中心，个数须等于 UWB_ANCHOR_COUNT
+// 基站共线时无法区分车前/车后 (默认两基站装在 y=0 横轴上，约定目标在车前)；
+// 增加不在同一直线上的第三个基站即可区分，例如 {0.0f, -20.0f} (同时在 UWB_ANCHOR_PORTS 中为其分配串口)
+#define UWB_ANCHOR_POSITIONS { {-UWB_BASELINE / 2, 0.0f}, {UWB_BASELINE / 2, 0.0f} }
+#define UWB_MULTILAT_MAX_ITER 6         // Gauss-Newton 最大迭代次数 (3个及以上基站)
+#define UWB_MULTILAT_TOLERANCE 0.5f     // 迭代步长收敛阈值 (cm)
+#define UWB_MULTILAT_COLLINEAR_CM 1.0f  // 基站偏离基准线小于该值视为共线 (cm)
+
+// 测距预滤波 (每基站 Hampel 离群剔除 + RSSI 门限)
+#define UWB_HAMPEL_WINDOW 7         // 滑动窗口长度 (样本)
+#define UWB_HAMPEL_K 3.0f           // 离群判定阈值 (倍 sigma)
+#define UWB_HAMPEL_MIN_SIGMA 10.0f  // sigma 下限 (cm)，静止时避免误剔除
+#define UWB_RSSI_MIN 0              // 二进制帧 rssi 低于该值丢弃 (0=不限，需按模块实测标定)
+
+// 测距平滑 (每基站 One-Euro): 只用于几何解算，跟踪器、发布的各基站距离与测距变化率使用未平滑的测距
+#ifndef UWB_RANGE_SMOOTH_ENABLED
+#define UWB_RANGE_SMOOTH_ENABLED 1
+#endif
+#define UWB_RANGE_MIN_CUTOFF_HZ 1.0f    // 静止时截止频率 (Hz)
+#define UWB_RANGE_BETA 0.1f             // 截止频率随距离变化率的增量 (Hz / (cm/s))
+#define UWB_RANGE_D_CUTOFF_HZ 1.0f      // 距离变化率低通截止频率 (Hz)
+
+// 多标签 (按二进制帧中的地址区分)
+#define UWB_TAG_CAPACITY 8          // 标签表槽位数 (2 的幂)，最多同时保存 3/4
+#define UWB_TAG_ADDR 0xFFFF         // 上电默认主人标签地址 (0xFFFF=未配对，可用 O 命令配对)
+#define UWB_TAG_SWITCH_MARGIN 30.0f // 未配对时跟随最近的标签，须比当前目标近该值以上才切换 (cm)
+
+// 目标跟踪 (匀速模型卡尔曼滤波)
+#define UWB_TRACKER_ENABLED 1       // 1=跟随使用跟踪器预测位置, 0=直接使用几何解算
+#define UWB_TRACK_ACCEL_NOISE 150.0f    // 目标加速度噪声标准差 (cm/s^2)
+#define UWB_TRACK_RANGE_NOISE 8.0f      // 测距噪声标准差 (cm)
+#define UWB_TRACK_INIT_POS_VAR 400.0f   // 初始位置方差 (cm^2)
+#define UWB_TRACK_INIT_VEL_VAR 10000.0f // 初始速度方差 ((cm/s)^2)
+#define UWB_TRACK_MAX_PREDICT_MS 300    // 最长外推时间 (ms)
+
+// 固定周期控制任务 (跟随/归位/姿态检测, K 命令查看周期抖动与超时统计)
+// 1=独立任务按 CONTROL_RATE_HZ 运行，不受显示刷新/阻塞提示影响; 0=在loop中运行
+#ifndef CONTROL_TASK_ENABLED
+#define CONTROL_TASK_ENABLED 1
+#endif
+#define CONTROL_RATE_HZ 50          // 控制频率 (Hz), 需整除 1000
+#define CONTROL_TASK_CORE 1         // 与 loop 同核, 优先级高于 loop(1) 即可抢占
+#define CONTROL_TASK_PRIORITY 3
+#define CONTROL_TASK_STACK 4096
 
 // 跟随控制参数
 #define FOLLOW_DIST_TARGET 80.0f    // 目标距离 (cm)
@@ -113,11 +208,56 @@ const char* const MODE_NAMES[] = {
 #define FOLLOW_ANGLE_DEADZONE 15.0f // 角度死区 (度)
 #define FOLLOW_ENABLE_DISTANCE 100.0f // 停止距离阈值: <=该值停止 (cm)
 #define FOLLOW_MIN_DISTANCE 40.0f   // 过近停止距离 (cm)
-#define FOLLOW_FILTER_ALPHA 0.1f    // 跟随滤波系数 (0-1)
+#define FOLLOW_FILTER_TAU_MS 190.0f // 跟随滤波时间常数, 只在新定位结果到达时按实际间隔更新 (ms)
 #define FOLLOW_TURN_ON 35.0f        // 开始转向角度 (度)
 #define FOLLOW_TURN_OFF 15.0f       // 结束转向角度 (度)
 #define FOLLOW_CMD_HOLD_MS 300      // 指令最短保持时间 (ms)
 
+// 连续差速控制: 距离误差 -> 前进分量, 角度 -> 转向分量, 左右轮分别输出
+// 0=使用原有的 前进/转向/停止 三态控制 (上面的 TURN_ON/OFF 与 CMD_HOLD 只用于三态)
+#ifndef FOLLOW_CONTINUOUS_ENABLED
+#define FOLLOW_CONTINUOUS_ENABLED 1
+#endif
+#define FOLLOW_KP_DIST 2.0f         // 前进占空比 / 超出停止距离的 cm
+#define FOLLOW_KP_ANGLE 3.0f        // 转向占空比 / 超出角度死区的度数
+#define FOLLOW_KD_ANGLE 0.15f       // 转向阻尼 (占空比 / (度/s))
+#define FOLLOW_KD_TAU_MS 50.0f      // 转向阻尼所用角速度的低通时间常数 (ms)
+#define FOLLOW_SPEED_MAX 200        // 前进分量上限 (0-255)
+#define FOLLOW_TURN_MAX 120         // 转向分量上限 (0-255)
+#define FOLLOW_ARC_ANGLE 60.0f      // 前进分量随角度线性减小, 达到该角度时原地转向 (度)
+
+// 面包屑轨迹跟随: 记录用户走过的位置 (航位推算坐标系)，沿轨迹纯追踪，转角处不抄近路
+#ifndef FOLLOW_TRAIL_ENABLED
+#define FOLLOW_TRAIL_ENABLED 1
+#endif
+#define FOLLOW_TRAIL_CAPACITY 64    // 轨迹点容量 (满时丢弃最旧的点)
+#define FOLLOW_TRAIL_SPACING 10.0f  // 相邻轨迹点最小间距 (cm)
+#define FOLLOW_LOOKAHEAD 60.0f      // 纯追踪前视距离 (cm)
+
+// 用户速度前馈与预测停车: 由带时间戳的距离历史拟合用户径向速度，按比例前馈到前进分量；
+// 按车当前速度的刹停距离预测停下时的距离，用户减速时提前制动
+#ifndef FOLLOW_PREDICT_ENABLED
+#define FOLLOW_PREDICT_ENABLED 1
+#endif
+#define FOLLOW_RANGE_HISTORY 32     // 距离历史样本数 (需覆盖拟合窗口内的定位次数)
+#define FOLLOW_RANGE_WINDOW_MS 600  // 径向速度拟合窗口 (ms)
+#define FOLLOW_RANGE_MIN_SPAN_MS 150 // 窗口内样本跨度不足时不估计速度 (ms)
+#define FOLLOW_FF_GAIN 0.8f         // 前馈系数 (1=按估计的用户速度全量前馈)
+#define FOLLOW_FF_MIN_SPEED 15.0f   // 用户速度低于该值不前馈, 避免静止时噪声使车蠕动 (cm/s)
+#define FOLLOW_BRAKE_LATENCY 0.25f  // 决定停车到开始减速的等效延迟: 滤波 + 控制周期 (s)
+
+// 定位中断滑行: 定位结果中断时沿当前圆弧继续行驶并线性减速，恢复后直接接续跟随；
+// 滑行结束仍未恢复则停车。0=失联即停车
+#ifndef FOLLOW_COAST_ENABLED
+#define FOLLOW_COAST_ENABLED 1
+#endif
+#define FOLLOW_DROPOUT_MS UWB_TRACK_MAX_PREDICT_MS // 定位结果超过该时长未更新视为中断 (跟踪器外推用尽)
+#define FOLLOW_COAST_MS 500         // 滑行时长, 速度在此期间线性减到 0 (ms)
+
+// 底盘参数 (航位推算)
+#define CART_TRACK_WIDTH 30.0f      // 轮距 (cm)
+#define CART_SPEED_PER_DUTY 0.4f    // 每单位占空比对应的轮速 (cm/s)
+
 // 电机PWM参数
 #define MOTOR_PWM_FREQ 2000         // PWM频率 (Hz)
 #define MOTOR_PWM_RESOLUTION 8      // PWM分辨率 (bits)
@@ -127,18 +267,64 @@ const char* const MODE_NAMES[] = {
 #define MOTOR_SPEED_FOLLOW_TURN 80
 #define MOTOR_SPEED_PATH_FORWARD 204
 #define MOTOR_SPEED_PATH_TURN 204
+#define MOTOR_DUTY_MIN 60           // 电机起转最小占空比, 连续控制的非零输出从此值起算
+
+// 电机 PWM 后端 (编译期选择，Motor 接口不变)
+#define MOTOR_BACKEND_LEDC 0        // 4 路独立 LEDC 通道，逐路写入，左右轮两个 LEDC 定时器互不同步
+#define MOTOR_BACKEND_MCPWM 1       // MCPWM0 两个同步定时器，4 路输出在同一次计数器归零时一起生效
+#ifndef MOTOR_BACKEND
+#define MOTOR_BACKEND MOTOR_BACKEND_LEDC
+#endif
+#define MOTOR_MCPWM_BRAKE 0         // 占空比 0 时: 1=两路输入同为高 (制动), 0=同为低 (滑行，L298N 使能端接高时也是制动)
+#define MOTOR_MCPWM_DEADTIME_US 200 // 换向时先保持停止状态的最短时间 (us)，0=不插入；启用斜坡时换向必经 0，不会触发
+
+// 电机加减速斜坡 (由 esp_timer 周期推进, 0=指令立即生效)
+#ifndef MOTOR_RAMP_ENABLED
+#define MOTOR_RAMP_ENABLED 1
+#endif
+#define MOTOR_RAMP_PERIOD_MS 5      // 斜坡推进周期 (ms)
+#define MOTOR_RAMP_ACCEL 600        // 加速斜率 (占空比/s), 0->255 约 0.4 s
+#define MOTOR_RAMP_DECEL 1500       // 减速斜率 (占空比/s), 换向时先减到 0 再加速
+#define MOTOR_RAMP_JERK 8000        // 斜率变化率 (占空比/s²), 斜率逐步建立/撤销 (S 曲线); 0=梯形
 
 // 姿态检测参数
 #define BEND_THRESHOLD 25.0f        // 弯腰阈值
 #define SHOULDER_THRESHOLD 15.0f    // 高低肩阈值
+#define IMU_TILT_CUTOFF_HZ 1.0f     // 俯仰/横滚二阶低通截止频率 (Hz)，滤掉走路时的颠簸
+#define IMU_TILT_MAX_GAP_MS 500     // 两次更新间隔超过该值 (切换模式后) 时低通从当前值重新开始
+
+// 跟随模式陀螺仪航向补偿: 每个控制周期按积分的偏航角旋转 UWB 跟踪器状态与航位推算航向，
+// 原地转向时目标方位角随车身转动立即更新，不必等下一次测距
+#ifndef IMU_GYRO_COMP_ENABLED
+#define IMU_GYRO_COMP_ENABLED 1
+#endif
+#define IMU_GYRO_RATE_HZ 200        // 陀螺仪 Z 轴采样率 (Hz)，写入 MPU6050 FIFO，控制周期批量读出
+#define IMU_YAW_SIGN -1.0f          // 航向角速度 (右转为正) = IMU_YAW_SIGN × gyroZ，芯片 Z 轴朝上时右转 gyroZ 为负
+#define IMU_GYRO_MAX_GAP_MS 100     // 两次读取间隔超过该值 (FIFO 可能已溢出) 时丢弃积压数据重新开始
+
+// 直行航向保持: forward()/backward() 开始时锁定航向，控制任务每周期按陀螺仪转角修正左右轮差速，
+// 抵消左右电机差异、载重偏置与地面造成的跑偏 (手动、示教、归位与跟随三态控制的前进都生效)
+#ifndef HEADING_HOLD_ENABLED
+#define HEADING_HOLD_ENABLED 1
+#endif
+#define HEADING_HOLD_KP 3.0f        // 航向误差 (度) -> 单侧修正占空比
+#define HEADING_HOLD_KI 6.0f        // 积分增益 (占空比 / (度·s))，积分按行驶方向保留到下一段直行
+#define HEADING_HOLD_TRIM_MAX 40    // 单侧修正上限 (占空比)，慢侧不低于 MOTOR_DUTY_MIN
 
 // 称重参数
+#define WEIGHT_READ_INTERVAL_MS 100     // 读数周期 (ms)，HX711 默认 10 次/秒
+#define WEIGHT_FILTER_TAU_MS 450.0f     // 重量一阶低通时间常数 (ms)
 #define WEIGHT_OVERLOAD_THRESHOLD 5000.0f // 5kg
 #define WEIGHT_WARNING_THRESHOLD 1000.0f  // 1kg
 #define WEIGHT_WARNING_COOLDOWN_MS 3000   // 超重提示间隔 (ms)
 
 // 路径记录参数
 #define PATH_MAX_STEPS 100
+// 回放时移动步骤按示教记录的指令行程 (斜坡输出的积分, 见 Motor::getTravel) 结束, 加减速耗时不同也走到相同距离;
+// 0=按示教时长结束。需 MOTOR_RAMP_ENABLED
+#ifndef PATH_REPLAY_BY_TRAVEL
+#define PATH_REPLAY_BY_TRAVEL 1
+#endif
 
 // 蜂鸣器参数
 #define BUZZER_BEEP_DURATION 200    // 蜂鸣持续时间 (ms)
@@ -0,0 +1,150 @@
+/**
+ * @file control.cpp
+ * @brief 固定周期控制任务实现
+ */
+
+#include "control.h"
+#include <math.h>
+#include <freertos/FreeRTOS.h>
+
+#if CONTROL_TASK_ENABLED
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#endif
+
+static_assert(1000 % CONTROL_RATE_HZ == 0, "CONTROL_RATE_HZ 需整除 1000 (FreeRTOS 节拍为 1 ms)");
+
+ControlLoop control;
+
+namespace {
+portMUX_TYPE g_statsMux = portMUX_INITIALIZER_UNLOCKED;
+#if CONTROL_TASK_ENABLED
+SemaphoreHandle_t g_lock = nullptr;
+#endif
+}  // namespace
+
+bool ControlLoop::begin(ControlStepFn step) {
+    _step = step;
+    resetStats();
+#if CONTROL_TASK_ENABLED
+    g_lock = xSemaphoreCreateRecursiveMutex();
+    if (g_lock == nullptr) {
+        DEBUG_PRINTLN("控制任务互斥锁创建失败");
+        return false;
+    }
+    if (xTaskCreatePinnedToCore(taskEntry, "control", CONTROL_TASK_STACK, this,
+                                CONTROL_TASK_PRIORITY, nullptr, CONTROL_TASK_CORE) != pdPASS) {
+        DEBUG_PRINTLN("控制任务创建失败");
+        return false;
+    }
+    DEBUG_PRINTF("控制任务启动: %d Hz, core %d\n", CONTROL_RATE_HZ, CONTROL_TASK_CORE);
+#endif
+    return true;
+}
+
+void ControlLoop::poll() {
+    unsigned long now = micros();
+    if (_started && now - _lastStartUs < CONTROL_PERIOD_US) return;
+    runOnce(now);
+}
+
+void ControlLoop::lock() {
+#if CONTROL_TASK_ENABLED
+    if (g_lock != nullptr) xSemaphoreTakeRecursive(g_lock, portMAX_DELAY);
+#endif
+}
+
+void ControlLoop::unlock() {
+#if CONTROL_TASK_ENABLED
+    if (g_lock != nullptr) xSemaphoreGiveRecursive(g_lock);
+#endif
+}
+
+#if CONTROL_TASK_ENABLED
+void ControlLoop::taskEntry(void* arg) {
+    static_cast<ControlLoop*>(arg)->run();
+}
+
+void ControlLoop::run() {
+    const TickType_t period = pdMS_TO_TICKS(1000 / CONTROL_RATE_HZ);
+    TickType_t wake = xTaskGetTickCount();
+    for (;;) {
+        // 超时一个周期以上时从当前时刻重新排程，不连续补跑积压的周期
+        if ((TickType_t)(xTaskGetTickCount() - wake) > period) {
+            wake = xTaskGetTickCount();
+        }
+        vTaskDelayUntil(&wake, period);
+        runOnce(micros());
+    }
+}
+#endif
+
+void ControlLoop::runOnce(unsigned long startUs) {
+    unsigned long dtUs = _started ? startUs - _lastStartUs : CONTROL_PERIOD_US;
+    _lastStartUs = startUs;
+    bool first = !_started;
+    _started = true;
+
+    // 执行时间包含等待 loop 释放锁的时间，反映实际的输出延迟
+    lock();
+    if (_step != nullptr) _step(dtUs * 1e-6f);
+    unlock();
+    unsigned long execUs = micros() - startUs;
+
+    if (!first) {
+        bool late = dtUs >= 2 * CONTROL_PERIOD_US || execUs > CONTROL_PERIOD_US;
+        record(dtUs, execUs, late);
+    }
+}
+
+void ControlLoop::record(unsigned long dtUs, unsigned long execUs, bool late) {
+    unsigned long jitter = (dtUs > CONTROL_PERIOD_US) ? dtUs - CONTROL_PERIOD_US : CONTROL_PERIOD_US - dtUs;
+    portENTER_CRITICAL(&g_statsMux);
+    if (_cycles == 0 || dtUs < _dtMinUs) _dtMinUs = dtUs;
+    if (dtUs > _dtMaxUs) _dtMaxUs = dtUs;
+    if (jitter > _jitterMaxUs) _jitterMaxUs = jitter;
+    _jitterSqSum += (float)jitter * (float)jitter;
+    if (execUs > _execMaxUs) _execMaxUs = execUs;
+    _execSumUs += execUs;
+    if (late) _missed++;
+    _cycles++;
+    portEXIT_CRITICAL(&g_statsMux);
+}
+
+ControlStats ControlLoop::getStats() {
+    ControlStats st;
+    portENTER_CRITICAL(&g_statsMux);
+    st.cycles = _cycles;
+    st.missed = _missed;
+    st.dtMinUs = _dtMinUs;
+    st.dtMaxUs = _dtMaxUs;
+    st.jitterMaxUs = _jitterMaxUs;
+    st.jitterRmsUs = (_cycles > 0) ? sqrtf(_jitterSqSum / _cycles) : 0;
+    st.execMaxUs = _execMaxUs;
+    st.execAvgUs = (_cycles > 0) ? (uint32_t)(_execSumUs / _cycles) : 0;
+    portEXIT_CRITICAL(&g_statsMux);
+    return st;
+}
+
+void ControlLoop::resetStats() {
+    portENTER_CRITICAL(&g_statsMux);
+    _cycles = 0;
+    _missed = 0;
+    _dtMinUs = 0;
+    _dtMaxUs = 0;
+    _jitterMaxUs = 0;
+    _jitterSqSum = 0;
+    _execMaxUs = 0;
+    _execSumUs = 0;
+    portEXIT_CRITICAL(&g_statsMux);
+}
+
+void ControlLoop::printStats(Print& out) {
+    ControlStats st = getStats();
+    resetStats();
+    out.printf("Control: %d Hz (%s), cycles=%lu missed=%lu\n", CONTROL_RATE_HZ,
+               CONTROL_TASK_ENABLED ? "task" : "loop", (unsigned long)st.cycles, (unsigned long)st.missed);
+    out.printf("  dt=%.2f..%.2f ms jitter max=%lu us rms=%.0f us, exec max=%lu us avg=%lu us\n",
+               st.dtMinUs / 1000.0f, st.dtMaxUs / 1000.0f, (unsigned long)st.jitterMaxUs, st.jitterRmsUs,
+               (unsigned long)st.execMaxUs, (unsigned long)st.execAvgUs);
+}
@@ -0,0 +1,92 @@
+/**
+ * @file control.h
+ * @brief 固定周期控制任务
+ * @details 以 vTaskDelayUntil 按 CONTROL_RATE_HZ 调用控制函数 (UWB 定位、跟随、
+ *          归位、姿态检测)，并把实际周期 dt 传给控制器。记录周期抖动、
+ *          最坏执行时间 (WCET) 与超时次数，K 命令查看。
+ *          loop 中修改控制器状态 (切换模式、手动指令、配对) 时持有 ControlLock
+ */
+
+#ifndef CONTROL_H
+#define CONTROL_H
+
+#include <Arduino.h>
+#include "config.h"
+
+#define CONTROL_PERIOD_US (1000000UL / CONTROL_RATE_HZ)
+
+// 周期统计 (自上次 resetStats 起)
+struct ControlStats {
+    uint32_t cycles;        // 执行次数
+    uint32_t missed;        // 超时次数: 执行时间超过周期，或起始时刻晚于计划一个周期以上
+    uint32_t dtMinUs;       // 实际周期最小值
+    uint32_t dtMaxUs;       // 实际周期最大值
+    uint32_t jitterMaxUs;   // |实际周期 - 标称周期| 最大值
+    float jitterRmsUs;      // |实际周期 - 标称周期| 均方根
+    uint32_t execMaxUs;     // 最坏执行时间
+    uint32_t execAvgUs;     // 平均执行时间
+};
+
+typedef void (*ControlStepFn)(float dt);
+
+class ControlLoop {
+public:
+    /**
+     * @brief 启动控制任务 (CONTROL_TASK_ENABLED=0 时只记录控制函数，由 loop 调用 poll)
+     * @param step 控制函数，参数为距上次调用的实际时间 (s)
+     */
+    bool begin(ControlStepFn step);
+
+    /**
+     * @brief 在 loop 中运行控制函数 (仅 CONTROL_TASK_ENABLED=0 时使用)
+     */
+    void poll();
+
+    void lock();
+    void unlock();
+
+    ControlStats getStats();
+    void resetStats();
+
+    /**
+     * @brief 打印统计并清零，下次打印为这段时间内的值
+     */
+    void printStats(Print& out);
+
+private:
+    ControlStepFn _step = nullptr;
+    unsigned long _lastStartUs = 0;
+    bool _started = false;
+
+    uint32_t _cycles = 0;
+    uint32_t _missed = 0;
+    uint32_t _dtMinUs = 0;
+    uint32_t _dtMaxUs = 0;
+    uint32_t _jitterMaxUs = 0;
+    float _jitterSqSum = 0;
+    uint32_t _execMaxUs = 0;
+    uint64_t _execSumUs = 0;
+
+    void runOnce(unsigned long startUs);
+    void record(unsigned long dtUs, unsigned long execUs, bool late);
+
+#if CONTROL_TASK_ENABLED
+    static void taskEntry(void* arg);
+    void run();
+#endif
+};
+
+extern ControlLoop control;
+
+/**
+ * @brief 作用域锁: 构造时 lock，析构时 unlock
+ */
+class ControlLock {
+public:
+    ControlLock() { control.lock(); }
+    ~ControlLock() { control.unlock(); }
+    ControlLock(const ControlLock&) = delete;
+    ControlLock& operator=(const ControlLock&) = delete;
+};
+
+#endif // CONTROL_H
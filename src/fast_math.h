@@ -0,0 +1,122 @@
+/**
+ * @file fast_math.h
+ * @brief 单精度快速数学函数 (atan2 / 平方根 / 角度换算)
+ * @details ESP32 只有单精度 FPU，double 运算和 libm 的 atan2/sqrt 走软件实现。
+ *          这里的函数只用 float 运算，atan 采用查表 + 线性插值，
+ *          表在编译期由 GCC 内建函数生成，放在 Flash (.rodata) 中。
+ *
+ *          误差上界 (tools/fast_math_bench.cpp 在全定义域扫描验证):
+ *            fastAtan2     |误差| <= 2.5e-5 rad (约 0.0015°)
+ *                          线性插值误差 h²/8·max|atan''| = (1/64)²/8·0.65，另加 float 舍入
+ *            fastRsqrt     相对误差 <= 5e-6 (初值 + 两次牛顿迭代)
+ *            fastSqrt      相对误差 <= 5e-6，x <= 0 返回 0
+ *          角度/距离的测量噪声 (1° / 数 cm 级) 远大于上述误差
+ */
+
+#ifndef FAST_MATH_H
+#define FAST_MATH_H
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#define FAST_ATAN_LUT_SEGMENTS 64  // atan 表分段数 (表长 +1)
+
+// Arduino 的 PI/RAD_TO_DEG 是 double 常量，参与运算会整体提升为 double
+#define FAST_PI          3.14159265f
+#define FAST_HALF_PI     1.57079633f
+#define FAST_RAD_TO_DEG  57.2957795f
+#define FAST_DEG_TO_RAD  0.0174532925f
+
+namespace fast_math_detail {
+
+// C++11 没有 std::index_sequence，自行生成 0..N-1
+template <int... I> struct Seq {};
+template <int N, int... I> struct MakeSeq : MakeSeq<N - 1, N - 1, I...> {};
+template <int... I> struct MakeSeq<0, I...> { typedef Seq<I...> type; };
+
+template <typename S> struct AtanTable;
+template <int... I>
+struct AtanTable<Seq<I...>> {
+    // atan(i / SEGMENTS), i = 0..SEGMENTS，GCC 在编译期折叠 __builtin_atan
+    static constexpr float v[sizeof...(I)] = {
+        (float)__builtin_atan((double)I / FAST_ATAN_LUT_SEGMENTS)...};
+};
+template <int... I>
+constexpr float AtanTable<Seq<I...>>::v[sizeof...(I)];
+
+typedef AtanTable<MakeSeq<FAST_ATAN_LUT_SEGMENTS + 1>::type> Atan;
+
+}  // namespace fast_math_detail
+
+/**
+ * @brief atan(t)，t ∈ [0, 1]
+ */
+inline float fastAtanUnit(float t) {
+    const float* tab = fast_math_detail::Atan::v;
+    float f = t * FAST_ATAN_LUT_SEGMENTS;
+    int i = (int)f;
+    if (i >= FAST_ATAN_LUT_SEGMENTS) i = FAST_ATAN_LUT_SEGMENTS - 1;
+    float frac = f - (float)i;
+    return tab[i] + (tab[i + 1] - tab[i]) * frac;
+}
+
+/**
+ * @brief 四象限反正切 (rad)，与 atan2f 同号同范围 [-π, π]，(0, 0) 返回 0
+ */
+inline float fastAtan2(float y, float x) {
+    float ax = fabsf(x);
+    float ay = fabsf(y);
+    if (ax == 0.0f && ay == 0.0f) return 0.0f;
+
+    // 归约到第一象限的 [0, 45°]，只需一次除法
+    float a;
+    if (ay > ax) {
+        a = FAST_HALF_PI - fastAtanUnit(ax / ay);
+    } else {
+        a = fastAtanUnit(ay / ax);
+    }
+    if (x < 0.0f) a = FAST_PI - a;
+    return (y < 0.0f) ? -a : a;
+}
+
+/**
+ * @brief 四象限反正切 (度)
+ */
+inline float fastAtan2Deg(float y, float x) {
+    return fastAtan2(y, x) * FAST_RAD_TO_DEG;
+}
+
+/**
+ * @brief 1/√x，x > 0
+ */
+inline float fastRsqrt(float x) {
+    // 位运算初值 (相对误差 < 3.5%)，每次牛顿迭代误差约平方
+    uint32_t i;
+    memcpy(&i, &x, sizeof(i));
+    i = 0x5F375A86u - (i >> 1);
+    float r;
+    memcpy(&r, &i, sizeof(r));
+    float half = 0.5f * x;
+    r = r * (1.5f - half * r * r);
+    r = r * (1.5f - half * r * r);
+    return r;
+}
+
+/**
+ * @brief √x，x <= 0 返回 0
+ */
+inline float fastSqrt(float x) {
+    return (x > 0.0f) ? x * fastRsqrt(x) : 0.0f;
+}
+
+/**
+ * @brief 角度归一化到 [-180, 180]
+ */
+inline float wrapDeg(float deg) {
+    while (deg > 180.0f) deg -= 360.0f;
+    while (deg < -180.0f) deg += 360.0f;
+    return deg;
+}
+
+#endif // FAST_MATH_H
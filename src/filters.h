@@ -0,0 +1,276 @@
+/**
+ * @file filters.h
+ * @brief 定长状态数字滤波器: 一阶低通 (按时间常数)、滑动中位数、二阶低通 (biquad)、One-Euro
+ * @details 全部为头文件实现，状态大小编译期确定，不分配内存。系数由 constexpr 函数按
+ *          config.h 中的时间常数/截止频率在编译期算出 (GCC 在常量表达式中折叠
+ *          __builtin_expf/__builtin_tanf)；update() 都带实际样本间隔 dt (s)，
+ *          间隔与名义值不同时才在运行时重算系数，滤波效果不随调用频率变化。
+ *          主机端测试与逐样本耗时见 tools/filters_bench.cpp
+ */
+
+#ifndef FILTERS_H
+#define FILTERS_H
+
+#include <math.h>
+#include <stdint.h>
+
+namespace filters {
+
+constexpr float kPi = 3.14159265f;
+constexpr float kButterworthQ = 0.70710678f;
+
+/**
+ * @brief 一阶低通在间隔 dt 下的系数: alpha = 1 - exp(-dt / tau)
+ */
+constexpr float emaAlpha(float tauS, float dtS) {
+    return (dtS <= 0.0f) ? 0.0f : 1.0f - __builtin_expf(-dtS / tauS);
+}
+
+/**
+ * @brief 截止频率 (Hz) 对应的一阶低通时间常数 (s)
+ */
+constexpr float cutoffToTau(float cutoffHz) {
+    return 1.0f / (2.0f * kPi * cutoffHz);
+}
+
+// 二阶节系数，y = b0 x + b1 x1 + b2 x2 - a1 y1 - a2 y2
+struct BiquadCoeffs {
+    float b0, b1, b2, a1, a2;
+};
+
+namespace detail {
+constexpr BiquadCoeffs lowpassNorm(float k, float q, float norm) {
+    return BiquadCoeffs{k * k * norm, 2.0f * k * k * norm, k * k * norm,
+                        2.0f * (k * k - 1.0f) * norm, (1.0f - k / q + k * k) * norm};
+}
+constexpr BiquadCoeffs lowpassK(float k, float q) {
+    return lowpassNorm(k, q, 1.0f / (1.0f + k / q + k * k));
+}
+}  // namespace detail
+
+/**
+ * @brief 二阶低通系数 (RBJ，双线性变换并预畸变)，截止频率超过 0.45 × 采样率时按 0.45 × 采样率设计
+ * @param q 品质因数，默认 Butterworth (无过冲)
+ */
+constexpr BiquadCoeffs biquadLowpass(float cutoffHz, float dtS, float q = kButterworthQ) {
+    return detail::lowpassK(__builtin_tanf(kPi * ((cutoffHz * dtS < 0.45f) ? cutoffHz * dtS : 0.45f)), q);
+}
+
+}  // namespace filters
+
+/**
+ * @brief 一阶低通 (指数滑动平均)，按时间常数与实际样本间隔计算系数
+ * @details 首个样本直接作为输出；系数按最近一次 dt 缓存，等间隔调用时不重复计算 expf
+ */
+class EmaFilter {
+public:
+    /**
+     * @param tauS 时间常数 (s)
+     * @param nominalDtS 名义样本间隔 (s)，编译期预先算好该间隔下的系数
+     */
+    constexpr explicit EmaFilter(float tauS, float nominalDtS = 0.0f)
+        : _tau(tauS), _dt(nominalDtS), _alpha(filters::emaAlpha(tauS, nominalDtS)) {}
+
+    float update(float x, float dt) {
+        if (!_init) {
+            reset(x);
+            return _y;
+        }
+        if (dt != _dt) {
+            _dt = dt;
+            _alpha = filters::emaAlpha(_tau, dt);
+        }
+        _y += _alpha * (x - _y);
+        return _y;
+    }
+
+    /**
+     * @brief 状态整体平移 (按模型外推或坐标变换)，不改变滤波进度
+     */
+    void shift(float delta) { _y += delta; }
+
+    void setTimeConstant(float tauS) {
+        _tau = tauS;
+        _alpha = filters::emaAlpha(tauS, _dt);
+    }
+
+    void reset() { _init = false; }
+    void reset(float value) {
+        _y = value;
+        _init = true;
+    }
+    float value() const { return _y; }
+    bool initialized() const { return _init; }
+
+private:
+    float _tau;
+    float _dt;
+    float _alpha;
+    float _y = 0.0f;
+    bool _init = false;
+};
+
+/**
+ * @brief 滑动中位数，窗口 N 个样本
+ * @details 取值时复制窗口做插入排序，N 为小常数时每样本 O(N^2) 比较但无分支预测负担；
+ *          两样本间隔超过 maxGapS (>0) 时先清空窗口，中断前的旧样本不参与
+ */
+template <int N>
+class MedianFilter {
+public:
+    static_assert(N >= 1 && N <= 255, "窗口长度 1..255");
+
+    constexpr explicit MedianFilter(float maxGapS = 0.0f) : _maxGap(maxGapS) {}
+
+    float update(float x, float dt) {
+        if (_maxGap > 0 && dt > _maxGap) clear();
+        push(x);
+        return median();
+    }
+
+    void push(float x) {
+        _window[_head] = x;
+        _head = (uint8_t)((_head + 1) % N);
+        if (_size < N) _size++;
+    }
+
+    /**
+     * @brief 窗口中位数，偶数个样本取中间两个的均值；窗口为空时为 0
+     */
+    float median() const {
+        float v[N];
+        for (int i = 0; i < _size; i++) v[i] = _window[i];
+        return medianOf(v, _size);
+    }
+
+    /**
+     * @brief 原地排序后取中位数 (会打乱 v)
+     */
+    static float medianOf(float* v, int n) {
+        if (n <= 0) return 0.0f;
+        for (int i = 1; i < n; i++) {
+            float key = v[i];
+            int j = i - 1;
+            while (j >= 0 && v[j] > key) {
+                v[j + 1] = v[j];
+                j--;
+            }
+            v[j + 1] = key;
+        }
+        return (n & 1) ? v[n / 2] : 0.5f * (v[n / 2 - 1] + v[n / 2]);
+    }
+
+    void clear() {
+        _head = 0;
+        _size = 0;
+    }
+    int size() const { return _size; }
+    bool full() const { return _size == N; }
+    // 按存储顺序访问 (不是时间顺序)，用于统计窗口离散度
+    float at(int i) const { return _window[i]; }
+
+private:
+    float _maxGap;
+    float _window[N] = {0};
+    uint8_t _head = 0;
+    uint8_t _size = 0;
+};
+
+/**
+ * @brief 二阶低通 (直接 II 型转置)，首个样本按稳态初始化，没有从 0 起步的瞬态
+ * @details 系数按名义间隔在编译期设计；实际间隔偏离当前设计值 10% 以上时重新设计
+ *          (一次 tanf)，抖动在 10% 以内时沿用，频率响应误差相应在 10% 以内
+ */
+class BiquadLowpass {
+public:
+    constexpr BiquadLowpass(float cutoffHz, float nominalDtS, float q = filters::kButterworthQ)
+        : _cutoff(cutoffHz), _q(q), _dt(nominalDtS), _c(filters::biquadLowpass(cutoffHz, nominalDtS, q)) {}
+
+    float update(float x, float dt) {
+        if (dt > 0 && (dt > 1.1f * _dt || dt < 0.9f * _dt)) {
+            _dt = dt;
+            _c = filters::biquadLowpass(_cutoff, dt, _q);
+        }
+        if (!_init) reset(x);
+        float y = _c.b0 * x + _z1;
+        _z1 = _c.b1 * x - _c.a1 * y + _z2;
+        _z2 = _c.b2 * x - _c.a2 * y;
+        _y = y;
+        return y;
+    }
+
+    void reset() { _init = false; }
+
+    /**
+     * @brief 按输入输出恒为 value 的稳态设置内部状态 (直流增益为 1)
+     */
+    void reset(float value) {
+        _z2 = (_c.b2 - _c.a2) * value;
+        _z1 = (1.0f - _c.b0) * value;
+        _y = value;
+        _init = true;
+    }
+    float value() const { return _y; }
+    bool initialized() const { return _init; }
+    const filters::BiquadCoeffs& coeffs() const { return _c; }
+
+private:
+    float _cutoff;
+    float _q;
+    float _dt;
+    filters::BiquadCoeffs _c;
+    float _z1 = 0.0f;
+    float _z2 = 0.0f;
+    float _y = 0.0f;
+    bool _init = false;
+};
+
+/**
+ * @brief One-Euro 滤波 (Casiez 2012): 截止频率随信号变化率自适应
+ * @details 静止时按 minCutoff 强平滑抑制抖动，变化快时截止频率升高 (beta × |变化率|) 减小滞后。
+ *          变化率本身按 dCutoff 一阶低通
+ */
+class OneEuroFilter {
+public:
+    /**
+     * @param minCutoffHz 静止时截止频率 (Hz)
+     * @param beta 截止频率随变化率的增量 (Hz / (单位/s))
+     * @param dCutoffHz 变化率低通截止频率 (Hz)
+     */
+    constexpr OneEuroFilter(float minCutoffHz, float beta, float dCutoffHz)
+        : _minCutoff(minCutoffHz), _beta(beta), _dTau(filters::cutoffToTau(dCutoffHz)) {}
+
+    float update(float x, float dt) {
+        if (!_init) {
+            reset(x);
+            return _x;
+        }
+        if (dt <= 0) return _x;
+        float rate = (x - _x) / dt;
+        _dx += dt / (dt + _dTau) * (rate - _dx);
+        float cutoff = _minCutoff + _beta * fabsf(_dx);
+        float tau = 1.0f / (2.0f * filters::kPi * cutoff);
+        _x += dt / (dt + tau) * (x - _x);
+        return _x;
+    }
+
+    void reset() { _init = false; }
+    void reset(float value) {
+        _x = value;
+        _dx = 0;
+        _init = true;
+    }
+    float value() const { return _x; }
+    float rate() const { return _dx; }
+    bool initialized() const { return _init; }
+
+private:
+    float _minCutoff;
+    float _beta;
+    float _dTau;
+    float _x = 0.0f;
+    float _dx = 0.0f;
+    bool _init = false;
+};
+
+#endif // FILTERS_H
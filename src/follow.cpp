@@ -5,35 +5,198 @@
 
 #include "follow.h"
 #include "motor.h"
+#include "uwb.h"
+#include "fast_math.h"
+#include <freertos/FreeRTOS.h>
 
 Follow follow;
 
+namespace {
+portMUX_TYPE g_statsMux = portMUX_INITIALIZER_UNLOCKED;
+
+float clampf(float v, float lo, float hi) {
+    return (v < lo) ? lo : (v > hi) ? hi : v;
+}
+
+// 死区补偿: 非零输出映射到 [MOTOR_DUTY_MIN, MOTOR_DUTY_MAX]，小指令也能起转
+int16_t wheelDuty(float v) {
+    float mag = (v < 0) ? -v : v;
+    if (mag < 1.0f) return 0;
+    if (mag > MOTOR_DUTY_MAX) mag = MOTOR_DUTY_MAX;
+    float duty = MOTOR_DUTY_MIN + mag * (MOTOR_DUTY_MAX - MOTOR_DUTY_MIN) / MOTOR_DUTY_MAX;
+    return (int16_t)((v < 0) ? -duty : duty);
+}
+
+#if FOLLOW_PREDICT_ENABLED
+// 车的前进速度 (cm/s)，按斜坡之后的实际占空比估计；占空比已经过 wheelDuty 映射，
+// 轮速与之成正比 (CART_SPEED_PER_DUTY，与 odometry.h 同一模型)，不再换算
+float cartSpeed() {
+    int16_t left, right;
+    motor.getWheels(left, right);
+    return 0.5f * (left + right) * CART_SPEED_PER_DUTY;
+}
+
+// wheelDuty 的逆映射: 前进速度 (cm/s) -> 控制量，经 wheelDuty 后的实际占空比正好产生该速度；
+// 所需占空比不超过起转值时为 0 (任何非零控制量都已不低于起转值)
+float speedCommand(float speed) {
+    float duty = speed / CART_SPEED_PER_DUTY;
+    if (duty <= MOTOR_DUTY_MIN) return 0;
+    return (duty - MOTOR_DUTY_MIN) * MOTOR_DUTY_MAX / (MOTOR_DUTY_MAX - MOTOR_DUTY_MIN);
+}
+#endif
+}  // namespace
+
 void Follow::begin() {
     stop();
-    _filterInit = false;
+    resetFilters();
     _lastCmd = CMD_STOP;
     _lastCmdTime = 0;
+    _lastAngleValid = false;
+#if FOLLOW_TRAIL_ENABLED
+    resetTrail();
+#endif
+#if FOLLOW_PREDICT_ENABLED
+    resetUserSpeed();
+#endif
+    _tracking = false;
+#if FOLLOW_COAST_ENABLED
+    _coasting = false;
+#endif
 }
 
-void Follow::update(float distance, float angle) {
-    // Bang-bang control with filtering and hysteresis
+void Follow::drive(float distance, float angle, float dt) {
     if (distance <= 0) {
         stop();
         _lastCmd = CMD_STOP;
+        _lastAngleValid = false;
+        return;
+    }
+
+#if FOLLOW_CONTINUOUS_ENABLED
+    driveContinuous(distance, angle, dt);
+#else
+    (void)dt;
+    driveDiscrete(distance, angle, millis());
+#endif
+
+    // Serial.printf("Follow: Dist=%.0f, Ang=%.1f\n", distance, angle);
+}
+
+void Follow::filterSample(const UWBData& fix) {
+    // 跟踪器在定位时刻的估计 (未启用跟踪器时为几何解算结果，变化率为 0)
+    UWBData s = uwb.getPrediction(fix.fixUs);
+    float range = fastSqrt(s.x * s.x + s.y * s.y);
+    float rangeDot = (range > 1.0f) ? (s.x * s.vx + s.y * s.vy) / range : 0.0f;
+
+    long dtUs = (long)(fix.fixUs - _sampleUs);
+    if (!_range.initialized() || dtUs > UWB_TRACK_MAX_PREDICT_MS * 1000L) {
+        // 首个结果或中断后: 外推已不可信，直接取本结果
+        _range.reset(range);
+        _angle.reset(s.angle);
+        _rangeDot.reset(rangeDot);
+        _angleDot.reset(s.angleRate);
+    } else {
+        if (dtUs < 0) dtUs = 0;
+        float dt = (float)dtUs * 1e-6f;
+        _range.shift(_rangeDot.value() * dt);
+        _angle.shift(_angleDot.value() * dt);
+        _range.update(range, dt);
+        _angle.update(s.angle, dt);
+        _rangeDot.update(rangeDot, dt);
+        _angleDot.update(s.angleRate, dt);
+    }
+    _sampleUs = fix.fixUs;
+    _sampleSeq = fix.seq;
+}
+
+void Follow::resetFilters() {
+    _range.reset();
+    _angle.reset();
+    _rangeDot.reset();
+    _angleDot.reset();
+}
+
+void Follow::setParams(const FollowParams& params) {
+    _params = params;
+    float tau = params.filterTauMs * 1e-3f;
+    _range.setTimeConstant(tau);
+    _angle.setTimeConstant(tau);
+    _rangeDot.setTimeConstant(tau);
+    _angleDot.setTimeConstant(tau);
+}
+
+void Follow::driveContinuous(float d, float a, float dt) {
+    // 新定位结果到达的周期角度按滤波修正量阶跃，不对阶跃求微分；
+    // 前视点切换同样使角度阶跃，角速度按实际周期间隔低通
+    if (!_lastAngleValid) {
+        _angleRate.reset(0);
+    } else if (!_newSample && dt > 0) {
+        _angleRate.update((a - _lastAngle) / dt, dt);
+    }
+    float rate = _angleRate.value();
+    _lastAngle = a;
+    _lastAngleValid = true;
+
+    // 停止距离内 (含过近) 两轮都停: 不前进，也不在用户身旁原地转向，与三态控制一致
+    float stopDist = FOLLOW_DIST_TARGET + FOLLOW_DIST_DEADZONE;
+    if (stopDist < FOLLOW_ENABLE_DISTANCE) stopDist = FOLLOW_ENABLE_DISTANCE;
+    if (d < FOLLOW_MIN_DISTANCE || d <= stopDist) {
+        stop();
         return;
     }
 
-    if (!_filterInit) {
-        _distanceFiltered = distance;
-        _angleFiltered = angle;
-        _filterInit = true;
+    // 前进分量: 从停止距离起按比例增加，死区边缘处为 0，没有跳变；
+    // 启用预测时叠加用户速度前馈，距离误差按预测的刹停时距离计算
+    float gap = d;
+    float ff = 0;
+#if FOLLOW_PREDICT_ENABLED
+    // 预测停车: 车从现在起刹停 (延迟 + 斜坡减速) 的过程中用户继续按估计速度移动，
+    // 预测的刹停时距离小于当前距离时按预测值控制，用户停下时提前减速
+    float vCart = cartSpeed();
+    if (vCart > 0) {
+        float tStop = _params.brakeLatency;
+        float brake = vCart * _params.brakeLatency;
+#if MOTOR_RAMP_ENABLED
+        const float decel = MOTOR_RAMP_DECEL * CART_SPEED_PER_DUTY;
+        tStop += vCart / decel;
+        brake += vCart * vCart / (2 * decel);
+#endif
+        // 距离已按变化率外推到当前时刻，不再另补滤波滞后
+        float predicted = d + _userSpeed * tStop - brake;
+        if (predicted < gap) gap = predicted;
+    }
+    // 速度前馈: 用户走开时不必等距离误差积累，过近时不前馈
+    if (_userSpeed > FOLLOW_FF_MIN_SPEED && d > FOLLOW_DIST_TARGET) {
+        ff = speedCommand(_params.ffGain * _userSpeed);
+    }
+#endif
+    float v = clampf(ff + clampf(_params.kpDist * (gap - stopDist), 0, _params.speedMax), 0, _params.speedMax);
+
+    // 转向分量: 角度死区外 PD，死区内不转，避免近处角度噪声引起摆动
+    float absA = (a < 0) ? -a : a;
+    float w = 0;
+    if (absA > _params.angleDeadzone) {
+        float err = (a > 0) ? a - _params.angleDeadzone : a + _params.angleDeadzone;
+        w = clampf(_params.kpAngle * err + _params.kdAngle * rate, -_params.turnMax, _params.turnMax);
     }
 
-    _distanceFiltered += FOLLOW_FILTER_ALPHA * (distance - _distanceFiltered);
-    _angleFiltered += FOLLOW_FILTER_ALPHA * (angle - _angleFiltered);
+    // 角度越大前进越慢: 小角度走弧线，接近 arcAngle 时原地转向
+    v *= clampf(1.0f - absA / _params.arcAngle, 0, 1);
+
+    // 角度为正 (目标偏右) 时左轮快于右轮；超限时等比缩小，保持转弯半径
+    float left = v + w;
+    float right = v - w;
+    float peak = (left > right) ? left : right;
+    if (-left > peak) peak = -left;
+    if (-right > peak) peak = -right;
+    if (peak > MOTOR_DUTY_MAX) {
+        left *= MOTOR_DUTY_MAX / peak;
+        right *= MOTOR_DUTY_MAX / peak;
+    }
+    motor.setWheels(wheelDuty(left), wheelDuty(right));
+}
 
-    float d = _distanceFiltered;
-    float a = _angleFiltered;
+void Follow::driveDiscrete(float d, float a, unsigned long now) {
     float absA = (a < 0) ? -a : a;
 
     if (d <= FOLLOW_ENABLE_DISTANCE) {
@@ -63,7 +226,6 @@ void Follow::update(float distance, float angle) {
         cmd = CMD_STOP;
     }
 
-    unsigned long now = millis();
     if (cmd != _lastCmd && _lastCmd != CMD_STOP && (now - _lastCmdTime) < FOLLOW_CMD_HOLD_MS) {
         cmd = _lastCmd;
     }
@@ -87,9 +249,223 @@ void Follow::update(float distance, float angle) {
         _lastCmd = cmd;
         _lastCmdTime = now;
     }
+}
 
-    // Serial.printf("Follow: Dist=%.0f, Ang=%.1f\n", distance, angle);
+void Follow::updateFromUwb(float dt) {
+    unsigned long now = micros();
+    if (hasFix(now)) {
+#if FOLLOW_COAST_ENABLED
+        if (_coasting) endCoast(now);
+#endif
+        _tracking = true;
+        UWBData fix = uwb.getData();
+#if FOLLOW_PREDICT_ENABLED
+        updateUserSpeed(fix);
+#endif
+        _newSample = !_range.initialized() || fix.seq != _sampleSeq;
+        if (_newSample) filterSample(fix);
+
+        // 两个定位结果之间不再滤波，按结果时刻的变化率外推到当前时刻
+        long ageUs = (long)(now - _sampleUs);
+        if (ageUs < 0) ageUs = 0;
+        if (ageUs > UWB_TRACK_MAX_PREDICT_MS * 1000L) ageUs = UWB_TRACK_MAX_PREDICT_MS * 1000L;
+        float age = (float)ageUs * 1e-6f;
+        float range = _range.value() + _rangeDot.value() * age;
+        float angle = _angle.value() + _angleDot.value() * age;
+        // 控制按前方垂直距离: 用户在正侧方时为 0 (停车)
+        float distance = range * cosf((angle - UWB_ANGLE_OFFSET) * FAST_DEG_TO_RAD);
+#if FOLLOW_TRAIL_ENABLED
+        drive(distance, trailBearing(range, angle, dt), dt);
+#else
+        drive(distance, angle, dt);
+#endif
+        return;
+    }
+#if FOLLOW_COAST_ENABLED
+    if (coast(now, dt)) return;
+#else
+    if (_tracking) {
+        portENTER_CRITICAL(&g_statsMux);
+        _stats.dropouts++;
+        _stats.hardStops++;
+        portEXIT_CRITICAL(&g_statsMux);
+    }
+#endif
+    lose();
+}
+
+bool Follow::hasFix(unsigned long now) {
+    if (!uwb.isConnected()) return false;
+#if FOLLOW_COAST_ENABLED
+    return now - uwb.getData().fixUs < FOLLOW_DROPOUT_MS * 1000UL;
+#else
+    (void)now;
+    return true;
+#endif
+}
+
+void Follow::lose() {
+    motor.stop();
+    _tracking = false;
+    _lastAngleValid = false;
+    resetFilters();
+#if FOLLOW_TRAIL_ENABLED
+    resetTrail();
+#endif
+#if FOLLOW_PREDICT_ENABLED
+    resetUserSpeed();
+#endif
+}
+
+#if FOLLOW_COAST_ENABLED
+bool Follow::coast(unsigned long now, float dt) {
+    if (!_coasting) {
+        // 启动时或停车后尚未定位: 不是中断，直接停车
+        if (!_tracking) return false;
+        _coasting = true;
+        _coastStartUs = now;
+        motor.getWheels(_coastLeft, _coastRight);
+        portENTER_CRITICAL(&g_statsMux);
+        _stats.dropouts++;
+        portEXIT_CRITICAL(&g_statsMux);
+    }
+
+    unsigned long elapsed = now - _coastStartUs;
+    if (elapsed >= _params.coastMs * 1000.0f) {
+        _coasting = false;
+        portENTER_CRITICAL(&g_statsMux);
+        _stats.hardStops++;
+        _stats.coastMs += elapsed / 1000;
+        portEXIT_CRITICAL(&g_statsMux);
+        return false;
+    }
+
+    // 两轮等比减速，保持中断时的转弯半径；低于起转占空比的直接置 0
+    float k = 1.0f - (float)elapsed / (_params.coastMs * 1000.0f);
+    int16_t left = (int16_t)(_coastLeft * k);
+    int16_t right = (int16_t)(_coastRight * k);
+    if (abs(left) < MOTOR_DUTY_MIN) left = 0;
+    if (abs(right) < MOTOR_DUTY_MIN) right = 0;
+    motor.setWheels(left, right);
+
+#if FOLLOW_TRAIL_ENABLED
+    // 航位推算不中断，恢复后轨迹仍与车的位姿一致
+    advanceOdometry(dt);
+#else
+    (void)dt;
+#endif
+    return true;
+}
+
+void Follow::endCoast(unsigned long now) {
+    uint32_t coastMs = (now - _coastStartUs) / 1000;
+    uint32_t gapMs = coastMs + FOLLOW_DROPOUT_MS;
+    _coasting = false;
+    // 中断期间的角度变化不计入微分项
+    _lastAngleValid = false;
+    portENTER_CRITICAL(&g_statsMux);
+    _stats.recovered++;
+    _stats.coastMs += coastMs;
+    if (gapMs > _stats.longestMs) _stats.longestMs = gapMs;
+    portEXIT_CRITICAL(&g_statsMux);
+}
+#endif
+
+FollowStats Follow::getStats() {
+    portENTER_CRITICAL(&g_statsMux);
+    FollowStats st = _stats;
+    portEXIT_CRITICAL(&g_statsMux);
+    return st;
+}
+
+void Follow::printStats(Print& out) {
+    FollowStats st = getStats();
+    out.printf("Follow dropouts: %lu, recovered=%lu hard_stop=%lu coast=%lu ms longest=%lu ms (coast %s, %d ms)\n",
+               (unsigned long)st.dropouts, (unsigned long)st.recovered, (unsigned long)st.hardStops,
+               (unsigned long)st.coastMs, (unsigned long)st.longestMs, FOLLOW_COAST_ENABLED ? "on" : "off",
+               (int)_params.coastMs);
+}
+
+#if FOLLOW_PREDICT_ENABLED
+void Follow::updateUserSpeed(const UWBData& fix) {
+    // 只在新的定位结果到达时记录，按定位时刻而不是控制周期计时
+    if (fix.valid && fix.seq != _lastSeq) {
+        _lastSeq = fix.seq;
+        // 各基站距离的均值即到车中心的斜距，不含横向定位误差 (基线短，横向误差远大于测距误差)
+        _rangeHistory.add(fix.fixUs, fix.meanRange);
+    }
+    if (!_rangeHistory.rate(FOLLOW_RANGE_WINDOW_MS * 1000UL, FOLLOW_RANGE_MIN_SPAN_MS * 1000UL, _rangeRate)) {
+        _rangeRate = 0;
+        _userSpeed = 0;
+        return;
+    }
+    // 距离变化率是相对速度，加上车速在用户方向上的分量得到用户自身的径向速度
+    _userSpeed = _rangeRate + cartSpeed() * cosf((fix.angle - UWB_ANGLE_OFFSET) * FAST_DEG_TO_RAD);
+}
+
+void Follow::resetUserSpeed() {
+    _rangeHistory.clear();
+    _rangeRate = 0;
+    _userSpeed = 0;
+}
+#endif
+
+#if FOLLOW_TRAIL_ENABLED
+float Follow::trailBearing(float range, float angle, float dt) {
+    advanceOdometry(dt);
+
+    // 去掉角度零点偏置后与斜距一起还原用户在车体坐标系中的位置 (与前方垂直距离的换算一致)
+    float a = (angle - UWB_ANGLE_OFFSET) * FAST_DEG_TO_RAD;
+    float ox, oy;
+    _odometry.toOdom(range * sinf(a), range * cosf(a), ox, oy);
+    _trail.push(ox, oy, FOLLOW_TRAIL_SPACING);
+
+    TrailPoint target;
+    const Pose& pose = _odometry.pose();
+    if (!_trail.lookahead(pose.x, pose.y, _params.lookahead, target)) {
+        return angle;
+    }
+    float bx, by;
+    _odometry.toBody(target.x, target.y, bx, by);
+    // 与输入的方位角同一约定 (含零点偏置)
+    return fastAtan2Deg(bx, by) + UWB_ANGLE_OFFSET;
+}
+
+void Follow::resetTrail() {
+    _odometry.reset();
+    _trail.clear();
+#if IMU_GYRO_COMP_ENABLED
+    _gyroYaw = 0;
+    _gyroValid = false;
+#endif
+}
+
+void Follow::advanceOdometry(float dt) {
+    int16_t left, right;
+    motor.getWheels(left, right);
+#if IMU_GYRO_COMP_ENABLED
+    if (_gyroValid) {
+        _odometry.update(left, right, dt, _gyroYaw * FAST_DEG_TO_RAD);
+        _gyroYaw = 0;
+        _gyroValid = false;
+        return;
+    }
+#endif
+    _odometry.update(left, right, dt);
+}
+#endif
+
+#if IMU_GYRO_COMP_ENABLED
+void Follow::rotate(float yawDeg) {
+    uwb.rotateFrame(yawDeg);
+    // 车右转时目标相对车头向左偏
+    _angle.shift(-yawDeg);
+#if FOLLOW_TRAIL_ENABLED
+    _gyroYaw += yawDeg;
+    _gyroValid = true;
+#endif
 }
+#endif
 
 void Follow::stop() {
     motor.stop();
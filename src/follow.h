@@ -8,23 +8,74 @@
 
 #include <Arduino.h>
 #include "config.h"
+#include "odometry.h"
+#include "trail.h"
+#include "range_rate.h"
+#include "filters.h"
+
+struct UWBData;
+
+// 连续控制可调参数，默认值取自 config.h；主机端仿真 (tools/follow_sim.cpp) 在运行时修改做参数扫描
+struct FollowParams {
+    float kpDist = FOLLOW_KP_DIST;
+    float kpAngle = FOLLOW_KP_ANGLE;
+    float kdAngle = FOLLOW_KD_ANGLE;
+    float angleDeadzone = FOLLOW_ANGLE_DEADZONE;
+    float speedMax = FOLLOW_SPEED_MAX;
+    float turnMax = FOLLOW_TURN_MAX;
+    float arcAngle = FOLLOW_ARC_ANGLE;
+    float filterTauMs = FOLLOW_FILTER_TAU_MS;
+    float lookahead = FOLLOW_LOOKAHEAD;
+    float ffGain = FOLLOW_FF_GAIN;
+    float brakeLatency = FOLLOW_BRAKE_LATENCY;
+    float coastMs = FOLLOW_COAST_MS;
+};
+
+// 定位中断统计 (上电起累计)
+struct FollowStats {
+    uint32_t dropouts;      // 跟随中定位中断次数
+    uint32_t recovered;     // 滑行期间恢复的次数
+    uint32_t hardStops;     // 未恢复而停车的次数
+    uint32_t coastMs;       // 累计滑行时长 (ms)
+    uint32_t longestMs;     // 已恢复的中断中最长的一次 (ms, 自最后一次定位起算)
+};
 
 class Follow {
 public:
     void begin();
-    
+
+    /**
+     * @brief 跟随模式每个控制周期的控制: 新定位结果到达时更新滤波，其余周期按变化率外推，失联时停车
+     * @details 滤波只随定位结果序号推进，平滑程度与延迟不受控制周期抖动和其它模块耗时影响。
+     *          固件控制任务与主机端回放工具 (tools/uwb_replay.cpp) 共用此入口
+     * @param dt 距上次调用的时间 (s)
+     */
+    void updateFromUwb(float dt);
+
     /**
-     * @brief 更新跟随控制
-     * @param distance 目标距离 (cm)
-     * @param angle 目标角度 (度)
+     * @brief 估计的用户径向速度 (cm/s)，远离车为正；未启用预测或样本不足时为 0
      */
-    void update(float distance, float angle);
+    float getUserSpeed() const { return _userSpeed; }
     
     /**
      * @brief 停止跟随
      */
     void stop();
 
+    FollowStats getStats();
+    void printStats(Print& out);
+
+#if IMU_GYRO_COMP_ENABLED
+    /**
+     * @brief 陀螺仪测得车身转过 yawDeg (右转为正): 旋转 UWB 跟踪器，航位推算改用该角度
+     * @details 控制任务每个周期在 updateFromUwb 之前调用；IMU 不可用时不调用，航位推算按轮速估计
+     */
+    void rotate(float yawDeg);
+#endif
+
+    const FollowParams& params() const { return _params; }
+    void setParams(const FollowParams& params);
+
 private:
     enum FollowCmd {
         CMD_STOP = 0,
@@ -33,15 +84,103 @@ private:
         CMD_RIGHT
     };
 
-    float _kpDistance = 2.0;
-    float _kpAngle = 3.0;
+    FollowParams _params;
 
-    float _distanceFiltered = 0.0f;
-    float _angleFiltered = 0.0f;
-    bool _filterInit = false;
+    // 滤波状态: 最近一个定位结果时刻的斜距 (cm)、角度 (度) 及跟踪器给出的变化率 (cm/s, 度/s)。
+    // 用极坐标保存: 车身转向时斜距不变，陀螺仪转角直接从角度中扣除
+    EmaFilter _range{FOLLOW_FILTER_TAU_MS * 1e-3f};
+    EmaFilter _angle{FOLLOW_FILTER_TAU_MS * 1e-3f};
+    EmaFilter _rangeDot{FOLLOW_FILTER_TAU_MS * 1e-3f};
+    EmaFilter _angleDot{FOLLOW_FILTER_TAU_MS * 1e-3f};
+    unsigned long _sampleUs = 0;
+    uint32_t _sampleSeq = 0;
     FollowCmd _lastCmd = CMD_STOP;
     unsigned long _lastCmdTime = 0;
-    unsigned long _lastUpdate;
+    float _lastAngle = 0.0f;
+    EmaFilter _angleRate{FOLLOW_KD_TAU_MS * 1e-3f, 1.0f / CONTROL_RATE_HZ};  // 转向微分项用的角速度 (度/s)
+    bool _lastAngleValid = false;
+    bool _newSample = false;    // 本周期有新定位结果
+    float _userSpeed = 0.0f;
+    bool _tracking = false;     // 上个周期在按定位结果跟随
+    FollowStats _stats = {};
+
+    /**
+     * @brief 定位结果是否可用于跟随: 已连接且 (启用滑行时) 未超过 FOLLOW_DROPOUT_MS
+     */
+    bool hasFix(unsigned long now);
+
+    /**
+     * @brief 失去定位: 停车并清除依赖连续定位的状态
+     */
+    void lose();
+
+    /**
+     * @brief 新定位结果: 上一结果按变化率外推到本结果时刻作为先验，按实际间隔 dt 以
+     *        alpha = 1 - exp(-dt / tau) 向本结果修正，变化率同样按 alpha 平滑
+     */
+    void filterSample(const UWBData& fix);
+    void resetFilters();
+
+    /**
+     * @brief 按目标距离 (cm) 与角度 (度) 输出电机指令，距离不大于 0 时停车
+     */
+    void drive(float distance, float angle, float dt);
+
+#if FOLLOW_COAST_ENABLED
+    bool _coasting = false;
+    unsigned long _coastStartUs = 0;
+    int16_t _coastLeft = 0;
+    int16_t _coastRight = 0;
+
+    /**
+     * @brief 中断期间按中断时的左右轮占空比线性减速行驶
+     * @return false 不滑行 (此前未在跟随或已超过滑行时长)，由调用方停车
+     */
+    bool coast(unsigned long now, float dt);
+    void endCoast(unsigned long now);
+#endif
+
+#if FOLLOW_PREDICT_ENABLED
+    RangeRateEstimator<FOLLOW_RANGE_HISTORY> _rangeHistory;
+    uint32_t _lastSeq = 0;
+    float _rangeRate = 0.0f;    // 距离变化率 (cm/s)，远离为正
+
+    /**
+     * @brief 记录新的定位结果并更新用户径向速度: 距离变化率 + 车速在用户方向上的分量
+     */
+    void updateUserSpeed(const UWBData& fix);
+    void resetUserSpeed();
+#endif
+
+#if FOLLOW_TRAIL_ENABLED
+    Odometry _odometry;
+    BreadcrumbTrail<FOLLOW_TRAIL_CAPACITY> _trail;
+
+    /**
+     * @brief 推进航位推算、按斜距与角度记录用户位置，返回前视点的方位角 (度)
+     */
+    float trailBearing(float range, float angle, float dt);
+    void resetTrail();
+
+    /**
+     * @brief 按实际输出占空比推进航位推算 dt 秒，有陀螺仪转角时航向取陀螺仪
+     */
+    void advanceOdometry(float dt);
+#if IMU_GYRO_COMP_ENABLED
+    float _gyroYaw = 0.0f;      // 尚未计入航位推算的陀螺仪转角 (度)
+    bool _gyroValid = false;
+#endif
+#endif
+
+    /**
+     * @brief 连续差速控制: 前进分量按距离误差, 转向分量按角度 PD, 大角度时以转向为主
+     */
+    void driveContinuous(float d, float a, float dt);
+
+    /**
+     * @brief 三态控制: 前进/原地转向/停止, 带角度滞回与指令最短保持时间
+     */
+    void driveDiscrete(float d, float a, unsigned long now);
 };
 
 extern Follow follow;
@@ -5,7 +5,7 @@
 
 #include "imu.h"
 #include <Wire.h>
-#include <math.h>
+#include "fast_math.h"
 
 // 全局IMU对象实例
 IMU imu;
@@ -13,6 +13,42 @@ IMU imu;
 // 第二个I2C总线
 TwoWire I2C_IMU = TwoWire(1);  // 使用I2C1
 
+static_assert(1000 % IMU_GYRO_RATE_HZ == 0, "IMU_GYRO_RATE_HZ 需整除 1000 (启用数字低通时陀螺仪输出率为 1 kHz)");
+
+namespace {
+// Adafruit 库未提供 FIFO 接口，直接读写寄存器
+const uint8_t REG_FIFO_EN = 0x23;
+const uint8_t REG_USER_CTRL = 0x6A;
+const uint8_t REG_FIFO_COUNT_H = 0x72;
+const uint8_t REG_FIFO_R_W = 0x74;
+const uint8_t FIFO_EN_ZG = 0x10;
+const uint8_t USER_CTRL_FIFO_EN = 0x40;
+const uint8_t USER_CTRL_FIFO_RESET = 0x04;
+const uint16_t FIFO_SIZE = 1024;
+const float GYRO_LSB_PER_DPS = 65.5f;   // ±500°/s 量程
+const size_t FIFO_CHUNK = 32;           // 单次 I2C 读取字节数 (小于 Wire 缓冲)
+
+bool writeReg(uint8_t reg, uint8_t value) {
+    I2C_IMU.beginTransmission(MPU6050_ADDR);
+    I2C_IMU.write(reg);
+    I2C_IMU.write(value);
+    return I2C_IMU.endTransmission() == 0;
+}
+
+bool readRegs(uint8_t reg, uint8_t* buf, size_t len) {
+    I2C_IMU.beginTransmission(MPU6050_ADDR);
+    I2C_IMU.write(reg);
+    if (I2C_IMU.endTransmission(false) != 0) return false;
+    if (I2C_IMU.requestFrom((uint8_t)MPU6050_ADDR, (uint8_t)len) != len) return false;
+    for (size_t i = 0; i < len; i++) buf[i] = I2C_IMU.read();
+    return true;
+}
+
+bool resetFifo() {
+    return writeReg(REG_USER_CTRL, USER_CTRL_FIFO_RESET) && writeReg(REG_USER_CTRL, USER_CTRL_FIFO_EN);
+}
+}  // namespace
+
 bool IMU::begin() {
     // 初始化I2C1总线（独立于OLED的I2C0）
     I2C_IMU.begin(I2C1_SDA_PIN, I2C1_SCL_PIN, 400000);  // 400kHz
@@ -41,10 +77,57 @@ bool IMU::begin() {
     // 启动时自动校准
     delay(100);
     calibrate();
+
+    if (!startGyroStream()) {
+        DEBUG_PRINTLN("  陀螺仪 FIFO 配置失败，跟随模式不做航向补偿，直行不做航向保持");
+    }
     
     return true;
 }
 
+bool IMU::startGyroStream() {
+    // 启用数字低通时陀螺仪输出 1 kHz，分频到 IMU_GYRO_RATE_HZ 后只把 Z 轴写入 FIFO
+    _mpu.setSampleRateDivisor(1000 / IMU_GYRO_RATE_HZ - 1);
+    _gyroStream = writeReg(REG_FIFO_EN, FIFO_EN_ZG) && resetFifo();
+    _gyroReadUs = micros();
+    if (_gyroStream) DEBUG_PRINTF("  陀螺仪 Z 轴 FIFO: %d Hz\n", IMU_GYRO_RATE_HZ);
+    return _gyroStream;
+}
+
+bool IMU::readYawDelta(float& yawDeg) {
+    yawDeg = 0;
+    if (!_gyroStream) return false;
+
+    unsigned long now = micros();
+    bool stale = now - _gyroReadUs > IMU_GYRO_MAX_GAP_MS * 1000UL;
+    _gyroReadUs = now;
+
+    uint8_t buf[FIFO_CHUNK];
+    if (!readRegs(REG_FIFO_COUNT_H, buf, 2)) return false;
+    uint16_t count = (uint16_t)buf[0] << 8 | buf[1];
+    // 长时间未读 (不在跟随模式或直行) 或 FIFO 已满溢出时，积压样本的时间不可知，丢弃后重新开始
+    if (stale || count >= FIFO_SIZE) return resetFifo();
+
+    count &= ~1u;   // 每个样本 2 字节，半个样本留到下次
+    int32_t sum = 0;
+    uint16_t samples = count / 2;
+    while (count > 0) {
+        size_t n = (count < FIFO_CHUNK) ? count : FIFO_CHUNK;
+        if (!readRegs(REG_FIFO_R_W, buf, n)) {
+            resetFifo();
+            return false;
+        }
+        for (size_t i = 0; i + 1 < n; i += 2) {
+            sum += (int16_t)((uint16_t)buf[i] << 8 | buf[i + 1]);
+        }
+        count -= n;
+    }
+
+    float rateSumDps = sum / GYRO_LSB_PER_DPS - samples * _gyroBiasZ * FAST_RAD_TO_DEG;
+    yawDeg = IMU_YAW_SIGN * rateSumDps / IMU_GYRO_RATE_HZ;
+    return true;
+}
+
 void IMU::update() {
     sensors_event_t accel, gyro, temp;
     
@@ -69,20 +152,29 @@ void IMU::update() {
     float ay = _data.accelY;
     float az = _data.accelZ;
     
-    // Pitch: 前后倾斜
-    _data.pitch = atan2(ay, sqrt(ax * ax + az * az)) * 180.0f / PI - _pitchOffset;
+    // Pitch: 前后倾斜 (全部单精度，PI 是 double 常量，不参与运算)
+    float pitch = fastAtan2Deg(ay, fastSqrt(ax * ax + az * az)) - _pitchOffset;
     
     // Roll: 左右倾斜
-    _data.roll = atan2(ax, sqrt(ay * ay + az * az)) * 180.0f / PI - _rollOffset;
+    float roll = fastAtan2Deg(ax, fastSqrt(ay * ay + az * az)) - _rollOffset;
+    
+    // 低通按实际更新间隔；间隔过长 (刚进入背负模式) 时从当前值重新开始
+    unsigned long nowUs = micros();
+    float tiltDt = (nowUs - _tiltUs) * 1e-6f;
+    if (tiltDt * 1000.0f > IMU_TILT_MAX_GAP_MS) {
+        _pitchFilter.reset();
+        _rollFilter.reset();
+        tiltDt = 0;
+    }
+    _tiltUs = nowUs;
+    _data.pitch = _pitchFilter.update(pitch, tiltDt);
+    _data.roll = _rollFilter.update(roll, tiltDt);
     
     // Yaw: 简单积分（会漂移）
     unsigned long now = millis();
     if (_lastUpdate > 0) {
         float dt = (now - _lastUpdate) / 1000.0f;
-        _data.yaw += _data.gyroZ * dt * 180.0f / PI;
-        
-        while (_data.yaw > 180) _data.yaw -= 360;
-        while (_data.yaw < -180) _data.yaw += 360;
+        _data.yaw = wrapDeg(_data.yaw + _data.gyroZ * dt * FAST_RAD_TO_DEG);
     }
     _lastUpdate = now;
     
@@ -94,6 +186,7 @@ void IMU::calibrate() {
     
     float pitchSum = 0;
     float rollSum = 0;
+    float gyroZSum = 0;
     const int samples = 20;
     
     for (int i = 0; i < samples; i++) {
@@ -104,18 +197,23 @@ void IMU::calibrate() {
         float ay = accel.acceleration.y;
         float az = accel.acceleration.z;
         
-        pitchSum += atan2(ay, sqrt(ax * ax + az * az)) * 180.0f / PI;
-        rollSum += atan2(ax, sqrt(ay * ay + az * az)) * 180.0f / PI;
+        pitchSum += fastAtan2Deg(ay, fastSqrt(ax * ax + az * az));
+        rollSum += fastAtan2Deg(ax, fastSqrt(ay * ay + az * az));
+        gyroZSum += gyro.gyro.z;
         
         delay(20);
     }
     
     _pitchOffset = pitchSum / samples;
     _rollOffset = rollSum / samples;
+    _pitchFilter.reset();
+    _rollFilter.reset();
+    // 校准时车静止，陀螺仪均值即零偏
+    _gyroBiasZ = gyroZSum / samples;
     _data.yaw = 0;
     
-    DEBUG_PRINTF("IMU 校准完成: pitch_offset=%.1f, roll_offset=%.1f\n", 
-                 _pitchOffset, _rollOffset);
+    DEBUG_PRINTF("IMU 校准完成: pitch_offset=%.1f, roll_offset=%.1f, gyro_z_bias=%.2f deg/s\n", 
+                 _pitchOffset, _rollOffset, _gyroBiasZ * FAST_RAD_TO_DEG);
 }
 
 PostureWarning IMU::checkPosture() {
@@ -10,6 +10,7 @@
 #include <Adafruit_MPU6050.h>
 #include <Adafruit_Sensor.h>
 #include "config.h"
+#include "filters.h"
 
 // 姿态数据结构
 struct IMUData {
@@ -50,12 +51,30 @@ public:
     const char* getWarningText(PostureWarning warning);
     void calibrate();
 
+    /**
+     * @brief 读出上次调用以来 FIFO 中的陀螺仪 Z 轴样本并积分为车身转角
+     * @details 样本按 IMU_GYRO_RATE_HZ 等间隔写入 FIFO，积分不受调用周期抖动影响；
+     *          距上次调用超过 IMU_GYRO_MAX_GAP_MS 时丢弃积压样本，转角记为 0
+     * @param yawDeg 转角 (度，右转为正，已扣除静止时标定的零偏)
+     * @return false IMU 不可用或读取失败
+     */
+    bool readYawDelta(float& yawDeg);
+
 private:
     Adafruit_MPU6050 _mpu;
     IMUData _data;
     float _pitchOffset = 0;
     float _rollOffset = 0;
+    float _gyroBiasZ = 0;           // gyroZ 零偏 (rad/s)
+    bool _gyroStream = false;       // FIFO 已配置为只缓存陀螺仪 Z 轴
+    unsigned long _gyroReadUs = 0;
     unsigned long _lastUpdate = 0;
+    // 加速度计算出的倾角含走路颠簸，按控制周期名义间隔设计二阶低通
+    BiquadLowpass _pitchFilter{IMU_TILT_CUTOFF_HZ, 1.0f / CONTROL_RATE_HZ};
+    BiquadLowpass _rollFilter{IMU_TILT_CUTOFF_HZ, 1.0f / CONTROL_RATE_HZ};
+    unsigned long _tiltUs = 0;
+
+    bool startGyroStream();
 };
 
 extern IMU imu;
@@ -15,8 +15,11 @@
 #include "path.h"
 #include "buzzer.h"
 #include "led.h"
+#include "control.h"
 
 WorkMode currentMode = MODE_STANDBY;
+volatile int pendingMode = -1;              // 控制任务请求的模式切换，由 loop 执行
+volatile PostureWarning postureWarning = POSTURE_OK;  // 控制任务最近一次姿态检测结果
 volatile bool buttonPressed = false;
 unsigned long lastButtonTime = 0;
 unsigned long lastClickTime = 0;
@@ -34,7 +37,8 @@ void handleSerialCommands();
 void handleInput(Stream& stream);
 void handleCommand(char cmd);
 void handleStandbyWeightWarning();
-void runCurrentMode();
+void controlStep(float dt);
+void runModeUi();
 void updateDisplay();
 void setMode(WorkMode nextMode);
 void switchMode();
@@ -74,6 +78,7 @@ void setup() {
     uwb.begin();
     follow.begin();
     path.begin();
+    control.begin(controlStep);
 
     delay(1000);
     Serial.println("System Ready! Current Mode: 0 (Standby)");
@@ -83,18 +88,24 @@ void loop() {
     handleButton();
     handleSerialCommands();
 
-    uwb.update();
+#if !CONTROL_TASK_ENABLED
+    control.poll();
+#endif
     buzzer.update();
     ledStrip.update();
 
     static unsigned long lastSensor = 0;
-    if (millis() - lastSensor > 100) {
-        if (currentMode == MODE_CARRYING) imu.update();
+    if (millis() - lastSensor > WEIGHT_READ_INTERVAL_MS) {
         if (currentMode == MODE_STANDBY) weight.readWeight();
         lastSensor = millis();
     }
 
-    runCurrentMode();
+    if (pendingMode >= 0) {
+        WorkMode next = (WorkMode)pendingMode;
+        pendingMode = -1;
+        setMode(next);
+    }
+    runModeUi();
 
     static unsigned long lastDisplay = 0;
     if (millis() - lastDisplay > 200) {
@@ -103,43 +114,65 @@ void loop() {
     }
 }
 
-void runCurrentMode() {
-    switch (currentMode) {
-        case MODE_STANDBY:
-            handleStandbyWeightWarning();
-            break;
+// 控制任务中按固定周期执行 (CONTROL_TASK_ENABLED=0 时由 loop 调用)，
+// 不做显示/蜂鸣器/串口输出，需要切换模式时通过 pendingMode 交给 loop
+void controlStep(float dt) {
+    uwb.update();
 
-        case MODE_FOLLOWING: {
-            if (uwb.isConnected()) {
-                UWBData data = uwb.getData();
-                follow.update(data.distance, data.angle);
-            } else {
-                motor.stop();
-            }
+#if IMU_GYRO_COMP_ENABLED || HEADING_HOLD_ENABLED
+    // 陀螺仪 FIFO 每周期只读一次，跟随的航向补偿与直行航向保持共用同一转角
+    float yaw = 0;
+    bool gyro = false;
+    if ((IMU_GYRO_COMP_ENABLED && currentMode == MODE_FOLLOWING) ||
+        (HEADING_HOLD_ENABLED && motor.isHoldingHeading())) {
+        gyro = imu.readYawDelta(yaw);
+    }
+#endif
+#if HEADING_HOLD_ENABLED
+    // 先修正正在进行的直行，本周期的模式逻辑再决定是否换成其他指令
+    if (gyro) motor.holdHeading(yaw, dt);
+#endif
+
+    switch (currentMode) {
+        case MODE_FOLLOWING:
+#if IMU_GYRO_COMP_ENABLED
+            if (gyro) follow.rotate(yaw);
+#endif
+            follow.updateFromUwb(dt);
             break;
-        }
 
         case MODE_PULLING:
             motor.stop();
             break;
 
-        case MODE_CARRYING: {
-            PostureWarning w = imu.checkPosture();
-            if (w != POSTURE_OK) {
-                buzzer.startBeeping();
-            } else {
-                buzzer.stopBeeping();
-            }
+        case MODE_CARRYING:
+            postureWarning = imu.checkPosture();
             break;
-        }
 
         case MODE_RETURNING:
             if (!path.updateReturning()) {
-                setMode(MODE_STANDBY);
+                pendingMode = MODE_STANDBY;
             }
             break;
 
-        case MODE_TEACHING:
+        default:
+            break;
+    }
+}
+
+// loop 中的提示类逻辑 (蜂鸣器与提示音)
+void runModeUi() {
+    switch (currentMode) {
+        case MODE_STANDBY:
+            handleStandbyWeightWarning();
+            break;
+
+        case MODE_CARRYING:
+            if (postureWarning != POSTURE_OK) {
+                buzzer.startBeeping();
+            } else {
+                buzzer.stopBeeping();
+            }
             break;
 
         default:
@@ -148,32 +181,40 @@ void runCurrentMode() {
 }
 
 void setMode(WorkMode nextMode) {
-    motor.stop();
-    buzzer.stopBeeping();
-
-    if (nextMode == MODE_FOLLOWING) {
-        motor.setSpeed(MOTOR_SPEED_FOLLOW_FORWARD, MOTOR_SPEED_FOLLOW_TURN);
-    } else if (nextMode == MODE_TEACHING || nextMode == MODE_RETURNING) {
-        motor.setSpeed(MOTOR_SPEED_PATH_FORWARD, MOTOR_SPEED_PATH_TURN);
-    } else {
-        motor.setSpeed(MOTOR_SPEED_FORWARD, MOTOR_SPEED_TURN);
-    }
+    // 模式与路径状态在控制任务中读取，切换期间暂停控制；提示信息在释放后显示
+    {
+        ControlLock guard;
+        motor.stop();
+        buzzer.stopBeeping();
+
+        if (nextMode == MODE_FOLLOWING) {
+            motor.setSpeed(MOTOR_SPEED_FOLLOW_FORWARD, MOTOR_SPEED_FOLLOW_TURN);
+            // 离开跟随期间的轨迹与定位状态已过时
+            follow.begin();
+        } else if (nextMode == MODE_TEACHING || nextMode == MODE_RETURNING) {
+            motor.setSpeed(MOTOR_SPEED_PATH_FORWARD, MOTOR_SPEED_PATH_TURN);
+        } else {
+            motor.setSpeed(MOTOR_SPEED_FORWARD, MOTOR_SPEED_TURN);
+        }
 
-    if (currentMode == MODE_TEACHING && path.isRecording()) {
-        path.stopRecording();
-    }
-    if (currentMode == MODE_RETURNING && path.isReturning()) {
-        path.cancelReturning();
-    }
+        if (currentMode == MODE_TEACHING && path.isRecording()) {
+            path.stopRecording();
+        }
+        if (currentMode == MODE_RETURNING && path.isReturning()) {
+            path.cancelReturning();
+        }
 
-    currentMode = nextMode;
+        currentMode = nextMode;
 
-    if (currentMode == MODE_TEACHING) {
-        path.startRecording();
-    } else if (currentMode == MODE_RETURNING) {
-        if (!path.startReturning()) {
-            currentMode = MODE_STANDBY;
+        if (currentMode == MODE_TEACHING) {
+            path.startRecording();
+        } else if (currentMode == MODE_RETURNING) {
+            if (!path.startReturning()) {
+                currentMode = MODE_STANDBY;
+            }
         }
+        postureWarning = POSTURE_OK;
+        pendingMode = -1;
     }
 
     Serial.print("Switch Mode: ");
@@ -203,13 +244,17 @@ void updateDisplay() {
             break;
 
         case MODE_CARRYING:
-            pw = imu.checkPosture();
+            // 姿态由控制任务读取，这里只取结果，不再访问 I2C
+            pw = postureWarning;
             display.showCarryingScreen(currentMode, imu.getPitch(), imu.getRoll(), imu.getWarningText(pw));
             break;
 
         case MODE_FOLLOWING:
-            ud = uwb.getData();
-            display.showFollowScreen(currentMode, ud.distance, ud.angle, ud.d0, ud.d1);
+            {
+                ControlLock guard;
+                ud = uwb.getData();
+            }
+            display.showFollowScreen(currentMode, ud.distance, ud.angle, ud.range[0], ud.range[1]);
             break;
 
         case MODE_RETURNING:
@@ -323,15 +368,71 @@ void handleCommand(char cmd) {
         case 't': case 'T':
             weight.tare();
             break;
-        case 'c': case 'C':
+        case 'c': case 'C': {
+            ControlLock guard;
             imu.calibrate();
             break;
+        }
+        case 'u': case 'U': {
+            // 标签表由控制任务插入/淘汰，打印期间持锁避免读到移动中的条目 (控制任务等待打印完成)
+            ControlLock guard;
+            uwb.printStats(Serial);
+            follow.printStats(Serial);
+            if (btReady) {
+                uwb.printStats(SerialBT);
+                follow.printStats(SerialBT);
+            }
+            break;
+        }
+        case 'o': case 'O': {
+            bool paired;
+            {
+                ControlLock guard;
+                paired = uwb.pairOwner();
+            }
+            if (paired) {
+                Serial.printf("UWB owner paired: tag 0x%04X\n", uwb.getOwner());
+                if (btReady) {
+                    SerialBT.printf("UWB owner paired: tag 0x%04X\n", uwb.getOwner());
+                }
+                buzzer.beepTimes(1, BUZZER_WARN_DURATION, BUZZER_WARN_INTERVAL);
+            } else {
+                Serial.println("UWB owner pairing failed: no tag in range");
+                if (btReady) {
+                    SerialBT.println("UWB owner pairing failed: no tag in range");
+                }
+            }
+            break;
+        }
+        case 'n': case 'N':
+            {
+                ControlLock guard;
+                uwb.clearOwner();
+            }
+            Serial.println("UWB owner cleared, following nearest tag");
+            if (btReady) {
+                SerialBT.println("UWB owner cleared, following nearest tag");
+            }
+            break;
+        case 'k': case 'K':
+            control.printStats(Serial);
+            break;
+        case 'g': case 'G':
+#if UWB_LOG_ENABLED
+            uwbLog.dump(Serial);
+            if (btReady) {
+                uwbLog.dump(SerialBT);
+            }
+#else
+            Serial.println("UWB log disabled (UWB_LOG_ENABLED=0)");
+#endif
+            break;
         case '?': case 'h': case 'H':
             Serial.println("Commands: W/A/S/D/X or F/B/L/R/X for movement");
-            Serial.println("M: mode, T: tare, C: IMU calibrate, P: teach, E: return");
+            Serial.println("M: mode, T: tare, C: IMU calibrate, P: teach, E: return, U: UWB stats, O/N: pair/clear owner tag, G: dump UWB log, K: control timing");
             if (btReady) {
                 SerialBT.println("Commands: W/A/S/D/X or F/B/L/R/X for movement");
-                SerialBT.println("M: mode, T: tare, C: IMU calibrate, P: teach, E: return");
+                SerialBT.println("M: mode, T: tare, C: IMU calibrate, P: teach, E: return, U: UWB stats, O/N: pair/clear owner tag, G: dump UWB log, K: control timing");
             }
             break;
         case 'p': case 'P':
@@ -0,0 +1,106 @@
+/**
+ * @file motion_profile.h
+ * @brief 单轮运动曲线: 按加速度与加加速度 (jerk) 限制把阶跃的目标占空比变成平滑的逐周期输出
+ * @details 头文件实现，由电机斜坡定时器每周期调用 update()。
+ *          jerk 为 0 时斜率立即到位，即梯形曲线；大于 0 时斜率本身也按 jerk 逐步建立与撤销，
+ *          起步和到达目标处无加速度突变 (S 曲线)，临近目标时按剩余量提前撤销斜率，不过冲。
+ *          幅值增大按加速斜率、减小按减速斜率；换向时先减到 0 并停一个周期再反向；
+ *          从 0 附近起步时直接跳到起转最小占空比 (以下电机不转)。
+ *          主机端检查见 tools/motion_profile_bench.cpp
+ */
+
+#ifndef MOTION_PROFILE_H
+#define MOTION_PROFILE_H
+
+#include <math.h>
+#include <stdint.h>
+
+class MotionProfile {
+public:
+    /**
+     * @param accel 加速斜率 (占空比/s)
+     * @param decel 减速斜率 (占空比/s)
+     * @param jerk 斜率变化率 (占空比/s²)，0 = 不限 (梯形)
+     * @param periodS 推进周期 (s)
+     * @param minDuty 起转最小占空比
+     */
+    constexpr MotionProfile(float accel, float decel, float jerk, float periodS, int16_t minDuty)
+        : _accelStep(accel * periodS), _decelStep(decel * periodS), _jerkStep(jerk * periodS * periodS),
+          _minDuty(minDuty) {}
+
+    /**
+     * @brief 朝目标推进一个周期
+     * @return 本周期输出 (取整后的占空比)
+     */
+    int16_t update(int16_t target) {
+        float goal = target;
+        // 换向: 先减到 0，下一周期再按加速斜率反向
+        if ((_value > 0 && goal < 0) || (_value < 0 && goal > 0)) goal = 0;
+        float err = goal - _value;
+        if (err == 0) {
+            _rate = 0;
+            return _out;
+        }
+        bool accelerating = (_value >= 0 && goal > _value) || (_value <= 0 && goal < _value);
+        if (accelerating && fabsf(_value) < _minDuty) {
+            if (goal >= _minDuty) {
+                _value = _minDuty;
+            } else if (goal <= -_minDuty) {
+                _value = -_minDuty;
+            } else {
+                _value = goal;
+            }
+            _rate = 0;
+            return _out = (int16_t)_value;
+        }
+
+        float limit = accelerating ? _accelStep : _decelStep;
+        float dir = (err > 0) ? 1.0f : -1.0f;
+        if (_jerkStep <= 0) {
+            _rate = dir * limit;
+        } else {
+            // 继续加大斜率后再按 jerk 撤销到 0 期间走过的量 r + r(r - j)/(2j)，超过剩余量则现在开始撤销
+            float next = fminf(_rate * dir + _jerkStep, limit);
+            if (_rate * dir > 0 && next + next * (next - _jerkStep) / (2 * _jerkStep) >= fabsf(err)) {
+                _rate = dir * fmaxf(_rate * dir - _jerkStep, _jerkStep);
+            } else {
+                _rate = dir * next;
+            }
+        }
+        _value += _rate;
+        if ((goal - _value) * dir <= 0) {
+            _value = goal;
+            _rate = 0;
+        }
+        return _out = (int16_t)lroundf(_value);
+    }
+
+    int16_t value() const { return _out; }
+
+    /**
+     * @brief 上一周期的变化量 (未取整，带符号)
+     */
+    float rate() const { return _rate; }
+
+    /**
+     * @brief 已停在 target 且无残余斜率 (update 不会再改变输出)
+     */
+    bool settled(int16_t target) const { return _value == target && _rate == 0; }
+
+    void reset(int16_t value = 0) {
+        _value = value;
+        _rate = 0;
+        _out = value;
+    }
+
+private:
+    float _accelStep;       // 每周期最大变化量
+    float _decelStep;
+    float _jerkStep;        // 每周期变化量的最大变化
+    int16_t _minDuty;
+    float _value = 0;
+    float _rate = 0;        // 上一周期的变化量 (带符号)
+    int16_t _out = 0;
+};
+
+#endif // MOTION_PROFILE_H
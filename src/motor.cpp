@@ -4,31 +4,91 @@
  */
 
 #include "motor.h"
+#include "motor_driver.h"
+#include "motion_profile.h"
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
 
 Motor motor;
 
 namespace {
-constexpr uint8_t CH_LEFT_IN1 = 0;
-constexpr uint8_t CH_LEFT_IN2 = 1;
-constexpr uint8_t CH_RIGHT_IN1 = 2;
-constexpr uint8_t CH_RIGHT_IN2 = 3;
+MotorDriver g_driver;
 uint8_t g_forwardSpeed = MOTOR_SPEED_FORWARD;
 uint8_t g_turnSpeed = MOTOR_SPEED_TURN;
 
-void setupPwm(uint8_t channel, uint8_t pin) {
-    ledcSetup(channel, MOTOR_PWM_FREQ, MOTOR_PWM_RESOLUTION);
-    ledcAttachPin(pin, channel);
+// 目标由调用方写入，当前值只在斜坡定时器中修改；两者之间用临界区交接
+int16_t g_target[2] = {0, 0};
+int16_t g_current[2] = {0, 0};
+MotionProfile g_profile[2] = {
+    {MOTOR_RAMP_ACCEL, MOTOR_RAMP_DECEL, MOTOR_RAMP_JERK, MOTOR_RAMP_PERIOD_MS * 0.001f, MOTOR_DUTY_MIN},
+    {MOTOR_RAMP_ACCEL, MOTOR_RAMP_DECEL, MOTOR_RAMP_JERK, MOTOR_RAMP_PERIOD_MS * 0.001f, MOTOR_DUTY_MIN}};
+// 输出占空比按斜坡周期累计 (指令行程)，只在斜坡定时器中修改；无符号按模回绕，使用者取差值
+uint32_t g_travel[2] = {0, 0};
+MotorStats g_stats = {};
+portMUX_TYPE g_mux = portMUX_INITIALIZER_UNLOCKED;
+#if MOTOR_RAMP_ENABLED
+esp_timer_handle_t g_rampTimer = nullptr;
+#endif
+
+// 直行航向保持: 锁定状态由指令写入 (可能来自 loop)，修正只在控制任务中计算。
+// 每次锁定/取消 g_holdGen 加一，控制任务写回修正时据此丢弃期间已被新指令取代的结果
+int16_t g_holdBase = 0;         // 直行基础占空比，0 = 未锁定
+uint32_t g_holdGen = 0;
+#if HEADING_HOLD_ENABLED
+uint32_t g_holdSeenGen = 0;     // 控制任务最近处理的锁定
+bool g_holdSettled = false;     // 斜坡已把两轮带到同一占空比，开始累计转角
+float g_holdError = 0;          // 锁定以来的累计转角 (度，右偏为正)
+// 积分项按行驶方向保留 (左右电机差异、载重偏置在各段直行之间基本不变)，
+// 以基础占空比的比例存储，前进速度随模式变化时修正量按比例缩放
+float g_holdIntegral[2] = {0, 0};
+#endif
+
+int16_t clampDuty(int16_t duty) {
+    if (duty > MOTOR_DUTY_MAX) return MOTOR_DUTY_MAX;
+    if (duty < -MOTOR_DUTY_MAX) return -MOTOR_DUTY_MAX;
+    return duty;
+}
+
+// 调用方已截断；启用斜坡时只写目标，由定时器逐步逼近
+void setTargets(int16_t left, int16_t right) {
+#if MOTOR_RAMP_ENABLED
+    g_target[0] = left;
+    g_target[1] = right;
+#else
+    g_target[0] = g_current[0] = left;
+    g_target[1] = g_current[1] = right;
+#endif
+}
+
+void writeWheels(int16_t left, int16_t right) {
+    g_driver.write(left, right);
+}
+
+#if MOTOR_RAMP_ENABLED
+void rampTimerCallback(void*) {
+    motor.rampTick();
 }
+#endif
 }  // namespace
 
 void Motor::begin() {
-    setupPwm(CH_LEFT_IN1, MOTOR_LEFT_IN1);
-    setupPwm(CH_LEFT_IN2, MOTOR_LEFT_IN2);
-    setupPwm(CH_RIGHT_IN1, MOTOR_RIGHT_IN1);
-    setupPwm(CH_RIGHT_IN2, MOTOR_RIGHT_IN2);
+    // 配置输出后端，上电立即输出停止，不经过斜坡
+    g_driver.begin();
 
-    stop();
-    DEBUG_PRINTLN("Motor init done (PWM)");
+#if MOTOR_RAMP_ENABLED
+    if (g_rampTimer == nullptr) {
+        esp_timer_create_args_t args = {};
+        args.callback = rampTimerCallback;
+        args.name = "motor_ramp";
+        if (esp_timer_create(&args, &g_rampTimer) == ESP_OK) {
+            esp_timer_start_periodic(g_rampTimer, MOTOR_RAMP_PERIOD_MS * 1000ULL);
+        }
+    }
+    DEBUG_PRINTF("Motor init done (%s, ramp +%d/-%d per s, jerk %d per s^2, every %d ms)\n",
+                 MotorDriver::name(), MOTOR_RAMP_ACCEL, MOTOR_RAMP_DECEL, MOTOR_RAMP_JERK, MOTOR_RAMP_PERIOD_MS);
+#else
+    DEBUG_PRINTF("Motor init done (%s)\n", MotorDriver::name());
+#endif
 }
 
 void Motor::setSpeed(uint8_t forward, uint8_t turn) {
@@ -36,37 +96,150 @@ void Motor::setSpeed(uint8_t forward, uint8_t turn) {
     g_turnSpeed = turn;
 }
 
+void Motor::setWheels(int16_t left, int16_t right) {
+    left = clampDuty(left);
+    right = clampDuty(right);
+    portENTER_CRITICAL(&g_mux);
+    if (g_holdBase != 0) {
+        g_holdBase = 0;
+        g_holdGen++;
+    }
+    setTargets(left, right);
+    portEXIT_CRITICAL(&g_mux);
+#if !MOTOR_RAMP_ENABLED
+    writeWheels(left, right);
+#endif
+}
+
+// 两轮同速直行；已在同一速度直行时保持锁定与当前修正，不重复锁定
+void Motor::straight(int16_t duty) {
+    duty = clampDuty(duty);
+    portENTER_CRITICAL(&g_mux);
+    bool holding = HEADING_HOLD_ENABLED && g_holdBase == duty;
+    if (!holding) {
+        g_holdBase = HEADING_HOLD_ENABLED ? duty : 0;
+        g_holdGen++;
+        setTargets(duty, duty);
+    }
+    portEXIT_CRITICAL(&g_mux);
+#if !MOTOR_RAMP_ENABLED
+    if (!holding) writeWheels(duty, duty);
+#endif
+}
+
+void Motor::holdHeading(float yawDeg, float dt) {
+#if HEADING_HOLD_ENABLED
+    portENTER_CRITICAL(&g_mux);
+    int16_t base = g_holdBase;
+    uint32_t gen = g_holdGen;
+    portEXIT_CRITICAL(&g_mux);
+    if (base == 0) return;
+
+    // 新的一段直行: 从当前航向开始计，本次转角多半发生在锁定之前
+    if (gen != g_holdSeenGen) {
+        g_holdSeenGen = gen;
+        g_holdError = 0;
+        g_holdSettled = !MOTOR_RAMP_ENABLED;
+        return;
+    }
+    // 从转向切换过来时，斜坡把两轮拉到同速之前车身仍在转动，这是示教与回放都会重复的运动，
+    // 不应修正 (否则积分项被带偏并延续到之后的直行)；两轮输出相同后才锁定航向
+    // (从静止或直行起步时两轮斜坡一致，立即锁定)
+    if (!g_holdSettled) {
+        if (g_current[0] != g_current[1]) return;
+        g_holdSettled = true;
+        g_holdError = 0;
+        return;
+    }
+    g_holdError += yawDeg;
+
+    // 慢侧不低于起转占空比，也不反转
+    float magnitude = (float)(base > 0 ? base : -base);
+    float limit = magnitude - MOTOR_DUTY_MIN;
+    if (limit > HEADING_HOLD_TRIM_MAX) limit = HEADING_HOLD_TRIM_MAX;
+    if (limit <= 0) return;
+    float& integral = g_holdIntegral[base > 0 ? 0 : 1];
+    integral += HEADING_HOLD_KI * g_holdError * dt / magnitude;
+    integral = constrain(integral, -limit / magnitude, limit / magnitude);
+    float trim = HEADING_HOLD_KP * g_holdError + integral * magnitude;
+    trim = constrain(trim, -limit, limit);
+
+    // 偏右 (误差为正) 时左轮减速、右轮加速；后退时同样成立 (转向只取决于左右轮速之差)
+    int16_t t = (int16_t)lroundf(trim);
+    int16_t left = clampDuty(base - t);
+    int16_t right = clampDuty(base + t);
+    portENTER_CRITICAL(&g_mux);
+    bool current = (g_holdGen == gen);
+    if (current) setTargets(left, right);
+    portEXIT_CRITICAL(&g_mux);
+#if !MOTOR_RAMP_ENABLED
+    if (current) writeWheels(left, right);
+#endif
+#else
+    (void)yawDeg;
+    (void)dt;
+#endif
+}
+
+bool Motor::isHoldingHeading() const {
+    return g_holdBase != 0;
+}
+
+void Motor::rampTick() {
+    portENTER_CRITICAL(&g_mux);
+    int16_t left = g_target[0];
+    int16_t right = g_target[1];
+    portEXIT_CRITICAL(&g_mux);
+
+    g_stats.rampTicks++;
+    if (!g_profile[0].settled(left) || !g_profile[1].settled(right)) {
+        g_current[0] = g_profile[0].update(left);
+        g_current[1] = g_profile[1].update(right);
+        writeWheels(g_current[0], g_current[1]);
+    }
+    uint32_t travelLeft = g_travel[0] + (uint32_t)(int32_t)g_current[0];
+    uint32_t travelRight = g_travel[1] + (uint32_t)(int32_t)g_current[1];
+    portENTER_CRITICAL(&g_mux);
+    g_travel[0] = travelLeft;
+    g_travel[1] = travelRight;
+    portEXIT_CRITICAL(&g_mux);
+}
+
+void Motor::getWheels(int16_t& left, int16_t& right) const {
+    left = g_current[0];
+    right = g_current[1];
+}
+
+void Motor::getTravel(uint32_t& left, uint32_t& right) const {
+    portENTER_CRITICAL(&g_mux);
+    left = g_travel[0];
+    right = g_travel[1];
+    portEXIT_CRITICAL(&g_mux);
+}
+
+MotorStats Motor::getStats() const {
+    MotorStats stats = g_stats;
+    stats.writes = g_driver.writes();
+    stats.skipped = g_driver.skipped();
+    return stats;
+}
+
 void Motor::forward() {
-    ledcWrite(CH_LEFT_IN1, g_forwardSpeed);
-    ledcWrite(CH_LEFT_IN2, 0);
-    ledcWrite(CH_RIGHT_IN1, g_forwardSpeed);
-    ledcWrite(CH_RIGHT_IN2, 0);
+    straight(g_forwardSpeed);
 }
 
 void Motor::backward() {
-    ledcWrite(CH_LEFT_IN1, 0);
-    ledcWrite(CH_LEFT_IN2, g_forwardSpeed);
-    ledcWrite(CH_RIGHT_IN1, 0);
-    ledcWrite(CH_RIGHT_IN2, g_forwardSpeed);
+    straight(-g_forwardSpeed);
 }
 
 void Motor::turnLeft() {
-    ledcWrite(CH_LEFT_IN1, 0);
-    ledcWrite(CH_LEFT_IN2, g_turnSpeed);
-    ledcWrite(CH_RIGHT_IN1, g_turnSpeed);
-    ledcWrite(CH_RIGHT_IN2, 0);
+    setWheels(-g_turnSpeed, g_turnSpeed);
 }
 
 void Motor::turnRight() {
-    ledcWrite(CH_LEFT_IN1, g_turnSpeed);
-    ledcWrite(CH_LEFT_IN2, 0);
-    ledcWrite(CH_RIGHT_IN1, 0);
-    ledcWrite(CH_RIGHT_IN2, g_turnSpeed);
+    setWheels(g_turnSpeed, -g_turnSpeed);
 }
 
 void Motor::stop() {
-    ledcWrite(CH_LEFT_IN1, 0);
-    ledcWrite(CH_LEFT_IN2, 0);
-    ledcWrite(CH_RIGHT_IN1, 0);
-    ledcWrite(CH_RIGHT_IN2, 0);
+    setWheels(0, 0);
 }
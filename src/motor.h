@@ -1,6 +1,10 @@
 /**
  * @file motor.h
  * @brief Motor driver - PWM speed control
+ * @details 左右轮指令先写入目标值，由 esp_timer 按 MOTOR_RAMP_PERIOD_MS 推进
+ *          motion_profile.h 的运动曲线，以限定斜率与 jerk 逼近 (MOTOR_RAMP_ENABLED)；PWM 输出由 motor_driver.h 中按
+ *          MOTOR_BACKEND 选定的后端完成 (LEDC 或两轮同步更新的 MCPWM)，占空比未变化时不重复写入。forward()/backward() 直行时可由控制任务
+ *          按陀螺仪转角微调左右轮差速，保持开始直行时的航向 (HEADING_HOLD_ENABLED)
  */
 
 #ifndef MOTOR_H
@@ -9,15 +13,73 @@
 #include <Arduino.h>
 #include "config.h"
 
+// 单轮最大占空比 (对应 MOTOR_PWM_RESOLUTION)
+#define MOTOR_DUTY_MAX ((1 << MOTOR_PWM_RESOLUTION) - 1)
+
+// PWM 写入统计
+struct MotorStats {
+    uint32_t writes;        // 实际写入次数 (LEDC: ledcWrite 次数；MCPWM: 两轮同步提交次数)
+    uint32_t skipped;       // 占空比未变化而跳过的写入
+    uint32_t rampTicks;     // 斜坡推进次数 (含已到达目标的空推进)
+};
+
 class Motor {
 public:
     void begin();
     void setSpeed(uint8_t forward, uint8_t turn);
+
+    /**
+     * @brief 分别设置左右轮目标占空比 (启用斜坡时逐步到达)
+     * @param left  左轮, 正值前进、负值后退, 范围 ±MOTOR_DUTY_MAX (超出截断)
+     * @param right 右轮, 同上
+     */
+    void setWheels(int16_t left, int16_t right);
+
+    /**
+     * @brief 当前实际输出的左右轮占空比 (斜坡之后)
+     */
+    void getWheels(int16_t& left, int16_t& right) const;
+
+    /**
+     * @brief 两轮同速直行; 从其他指令切换过来时锁定当前航向 (HEADING_HOLD_ENABLED)
+     */
     void forward();
     void backward();
     void turnLeft();
     void turnRight();
     void stop();
+
+    /**
+     * @brief 直行航向保持，由控制任务每周期调用
+     * @details 累计锁定以来的转角，按 PI 修正左右轮目标占空比 (偏右则左轮减速、右轮加速)。
+     *          未处于直行 (setWheels/转向/停止会取消锁定) 时不做任何事
+     * @param yawDeg 上次调用以来车身转角 (度，右转为正)
+     * @param dt 距上次调用的时间 (s)
+     */
+    void holdHeading(float yawDeg, float dt);
+
+    /**
+     * @brief 当前是否处于锁定航向的直行 (控制任务据此决定是否读取陀螺仪)
+     */
+    bool isHoldingHeading() const;
+
+    /**
+     * @brief 推进一次斜坡 (由定时器回调，主机端工具也可直接调用)
+     */
+    void rampTick();
+
+    /**
+     * @brief 累计指令行程: 斜坡输出的左右轮占空比逐周期相加 (占空比 × 斜坡周期)
+     * @details 反映包括加减速在内实际下发的速度指令，路径回放据此让每步走到示教时的行程。
+     *          未启用斜坡时不累计。计数按 2^32 回绕 (满速约 23 小时)，只用两次读数之差:
+     *          (int32_t)(后 - 前)
+     */
+    void getTravel(uint32_t& left, uint32_t& right) const;
+
+    MotorStats getStats() const;
+
+private:
+    void straight(int16_t duty);
 };
 
 extern Motor motor;
@@ -0,0 +1,194 @@
+/**
+ * @file motor_driver.h
+ * @brief 电机 PWM 输出后端: LEDC / MCPWM
+ * @details 每个后端一个类，统一接口:
+ *            begin()                  配置引脚与 PWM，输出停止
+ *            write(left, right)       输出左右轮占空比 (±MOTOR_DUTY_MAX，正值前进)，与上次相同时跳过
+ *            writes() / skipped()     实际写入与跳过次数
+ *          由 config.h 中的 MOTOR_BACKEND 在编译期选定 MotorDriver。
+ *          L298N 每轮两路输入: 正转 IN1 调制、IN2 低，反转相反
+ */
+
+#ifndef MOTOR_DRIVER_H
+#define MOTOR_DRIVER_H
+
+#include <Arduino.h>
+#include <driver/mcpwm.h>
+#include <soc/mcpwm_reg.h>
+#include <soc/soc.h>
+#include "config.h"
+#include "motor.h"
+
+/**
+ * @brief 4 路独立 LEDC 通道，各通道缓存上次占空比，未变化时不重复调用 ledcWrite
+ * @details 4 次写入依次进行，每路在所属 LEDC 定时器的下一个周期生效 (通道 0/1 与 2/3
+ *          分属两个互不同步的定时器)，换向或两轮同时变化时可能有一个 PWM 周期的中间状态
+ */
+class LedcMotorDriver {
+public:
+    // 通道 0..3 = 左IN1 左IN2 右IN1 右IN2 (主机端回放工具按此读取占空比)
+    static constexpr uint8_t CH_LEFT_IN1 = 0;
+    static constexpr uint8_t CH_LEFT_IN2 = 1;
+    static constexpr uint8_t CH_RIGHT_IN1 = 2;
+    static constexpr uint8_t CH_RIGHT_IN2 = 3;
+
+    void begin() {
+        setupPwm(CH_LEFT_IN1, MOTOR_LEFT_IN1);
+        setupPwm(CH_LEFT_IN2, MOTOR_LEFT_IN2);
+        setupPwm(CH_RIGHT_IN1, MOTOR_RIGHT_IN1);
+        setupPwm(CH_RIGHT_IN2, MOTOR_RIGHT_IN2);
+        _valid = false;
+        write(0, 0);
+    }
+
+    void write(int16_t left, int16_t right) {
+        writeWheel(CH_LEFT_IN1, CH_LEFT_IN2, left);
+        writeWheel(CH_RIGHT_IN1, CH_RIGHT_IN2, right);
+        _valid = true;
+    }
+
+    uint32_t writes() const { return _writes; }
+    uint32_t skipped() const { return _skipped; }
+    static const char* name() { return "LEDC"; }
+
+private:
+    uint32_t _duty[4] = {0, 0, 0, 0};
+    bool _valid = false;
+    uint32_t _writes = 0;
+    uint32_t _skipped = 0;
+
+    static void setupPwm(uint8_t channel, uint8_t pin) {
+        ledcSetup(channel, MOTOR_PWM_FREQ, MOTOR_PWM_RESOLUTION);
+        ledcAttachPin(pin, channel);
+    }
+
+    void writeChannel(uint8_t channel, uint32_t duty) {
+        if (_valid && _duty[channel] == duty) {
+            _skipped++;
+            return;
+        }
+        ledcWrite(channel, duty);
+        _duty[channel] = duty;
+        _writes++;
+    }
+
+    // 先写归零的一路: 换向时两次写入之间若恰好跨过周期边界，中间状态是两路同低而不是同高
+    void writeWheel(uint8_t chIn1, uint8_t chIn2, int16_t duty) {
+        if (duty > 0) {
+            writeChannel(chIn2, 0);
+            writeChannel(chIn1, duty);
+        } else {
+            writeChannel(chIn1, 0);
+            writeChannel(chIn2, -duty);
+        }
+    }
+};
+
+/**
+ * @brief MCPWM0: 左轮 = 定时器 0 (生成器 A/B -> IN1/IN2)，右轮 = 定时器 1，定时器 1 按定时器 0 的
+ *        计数归零同步
+ * @details 占空比写入比较值影子寄存器 (旧版驱动初始化为计数归零时装载)。写入期间清除
+ *          GLOBAL_UP_EN 暂停装载，4 个比较值写完再置位，两轮 4 路输出在同一次计数归零时一起生效，
+ *          不会出现只更新了一路或一个轮子的中间状态。
+ *          占空比 0 按 brake 输出两路同高 (制动) 或同低 (滑行)。
+ *          换向 (同一轮正反转直接切换) 时先提交停止状态并保持 deadtimeUs (外加一个 PWM 周期确保
+ *          停止状态已生效) 再提交新方向；斜坡启用时换向必经 0，不会走到这里的等待
+ */
+class McpwmMotorDriver {
+public:
+    static constexpr uint32_t PERIOD_US = 1000000UL / MOTOR_PWM_FREQ;
+
+    constexpr explicit McpwmMotorDriver(bool brake = MOTOR_MCPWM_BRAKE,
+                                        uint32_t deadtimeUs = MOTOR_MCPWM_DEADTIME_US)
+        : _brake(brake), _deadtimeUs(deadtimeUs) {}
+
+    void begin() {
+        mcpwm_gpio_init(MCPWM_UNIT_0, MCPWM0A, MOTOR_LEFT_IN1);
+        mcpwm_gpio_init(MCPWM_UNIT_0, MCPWM0B, MOTOR_LEFT_IN2);
+        mcpwm_gpio_init(MCPWM_UNIT_0, MCPWM1A, MOTOR_RIGHT_IN1);
+        mcpwm_gpio_init(MCPWM_UNIT_0, MCPWM1B, MOTOR_RIGHT_IN2);
+
+        mcpwm_config_t cfg = {};
+        cfg.frequency = MOTOR_PWM_FREQ;
+        cfg.cmpr_a = 0;
+        cfg.cmpr_b = 0;
+        cfg.duty_mode = MCPWM_DUTY_MODE_0;
+        cfg.counter_mode = MCPWM_UP_COUNTER;
+        mcpwm_init(MCPWM_UNIT_0, MCPWM_TIMER_0, &cfg);
+        mcpwm_init(MCPWM_UNIT_0, MCPWM_TIMER_1, &cfg);
+
+        // 定时器 0 计数归零时输出同步信号，定时器 1 收到后从 0 开始计数，两轮周期边界重合
+        mcpwm_set_timer_sync_output(MCPWM_UNIT_0, MCPWM_TIMER_0, MCPWM_SWSYNC_SOURCE_TEZ);
+        mcpwm_sync_config_t sync = {};
+        sync.sync_sig = MCPWM_SELECT_TIMER0_SYNC;
+        sync.timer_val = 0;
+        sync.count_direction = MCPWM_TIMER_DIRECTION_UP;
+        mcpwm_sync_configure(MCPWM_UNIT_0, MCPWM_TIMER_1, &sync);
+
+        _valid = false;
+        commit(0, 0);
+    }
+
+    void write(int16_t left, int16_t right) {
+        if (_valid && left == _out[0] && right == _out[1]) {
+            _skipped++;
+            return;
+        }
+        bool revLeft = _valid && reverses(_out[0], left);
+        bool revRight = _valid && reverses(_out[1], right);
+        if (_deadtimeUs > 0 && (revLeft || revRight)) {
+            commit(revLeft ? 0 : left, revRight ? 0 : right);
+            delayMicroseconds(_deadtimeUs + PERIOD_US);
+        }
+        commit(left, right);
+    }
+
+    uint32_t writes() const { return _writes; }
+    uint32_t skipped() const { return _skipped; }
+    static const char* name() { return "MCPWM"; }
+
+private:
+    bool _brake;
+    uint32_t _deadtimeUs;
+    int16_t _out[2] = {0, 0};
+    bool _valid = false;
+    uint32_t _writes = 0;
+    uint32_t _skipped = 0;
+
+    static bool reverses(int16_t from, int16_t to) {
+        return (from > 0 && to < 0) || (from < 0 && to > 0);
+    }
+
+    void setWheel(mcpwm_timer_t timer, int16_t duty) {
+        float in1 = 0, in2 = 0;
+        if (duty > 0) {
+            in1 = duty * 100.0f / MOTOR_DUTY_MAX;
+        } else if (duty < 0) {
+            in2 = -duty * 100.0f / MOTOR_DUTY_MAX;
+        } else if (_brake) {
+            in1 = in2 = 100.0f;
+        }
+        mcpwm_set_duty(MCPWM_UNIT_0, timer, MCPWM_GEN_A, in1);
+        mcpwm_set_duty(MCPWM_UNIT_0, timer, MCPWM_GEN_B, in2);
+    }
+
+    void commit(int16_t left, int16_t right) {
+        REG_CLR_BIT(MCPWM_UPDATE_CFG_REG(0), MCPWM_GLOBAL_UP_EN);
+        setWheel(MCPWM_TIMER_0, left);
+        setWheel(MCPWM_TIMER_1, right);
+        REG_SET_BIT(MCPWM_UPDATE_CFG_REG(0), MCPWM_GLOBAL_UP_EN);
+        _out[0] = left;
+        _out[1] = right;
+        _valid = true;
+        _writes++;
+    }
+};
+
+// 编译期选择输出后端
+template <int Backend> struct MotorDriverFor;
+template <> struct MotorDriverFor<MOTOR_BACKEND_LEDC>  { typedef LedcMotorDriver type; };
+template <> struct MotorDriverFor<MOTOR_BACKEND_MCPWM> { typedef McpwmMotorDriver type; };
+
+typedef MotorDriverFor<MOTOR_BACKEND>::type MotorDriver;
+
+#endif // MOTOR_DRIVER_H
@@ -0,0 +1,173 @@
+/**
+ * @file multilat.h
+ * @brief N基站二维多边定位
+ * @details 以基站数量为模板参数，基站坐标取自 config.h (UWB_ANCHOR_POSITIONS)。
+ *          2 个基站用闭式解 (两圆交点)，3 个及以上用 Gauss-Newton 最小二乘，
+ *          并输出残差作为解的质量指标。
+ *          共线布置时目标关于基站连线的镜像解无法区分，由调用方给出的
+ *          参考点 (上一次位置/跟踪器预测) 选择一侧；不共线时分别从两侧
+ *          出发迭代，取残差较小者，从而区分车前与车后
+ */
+
+#ifndef MULTILAT_H
+#define MULTILAT_H
+
+#include <math.h>
+#include <stdint.h>
+#include "config.h"
+#include "fast_math.h"
+
+// 基站在车体坐标系中的位置 (cm)，x 向右、y 向前，原点为车中心
+struct AnchorPos {
+    float x;
+    float y;
+};
+
+// 定位结果
+struct MultilatFix {
+    float x;            // 横向位置 (cm)
+    float y;            // 前向位置 (cm)
+    float residual;     // 测距残差 RMS (cm)，越小越可信
+    uint8_t iterations; // Gauss-Newton 迭代次数 (闭式解为 0)
+    bool ambiguous;     // true=基站共线，前后侧由参考点决定
+};
+
+template <int N>
+class Multilateration {
+public:
+    static_assert(N >= 2, "至少需要 2 个基站");
+
+    /**
+     * @brief 设置基站坐标并预计算几何
+     */
+    void setAnchors(const AnchorPos (&anchors)[N]) {
+        for (int i = 0; i < N; i++) _a[i] = anchors[i];
+
+        // 以距基站0最远的基站确定基准线方向
+        _far = 1;
+        float best = 0;
+        for (int i = 1; i < N; i++) {
+            float d2 = sq(_a[i].x - _a[0].x) + sq(_a[i].y - _a[0].y);
+            if (d2 > best) {
+                best = d2;
+                _far = i;
+            }
+        }
+        _baseline = fastSqrt(best);
+        float inv = (_baseline > 0) ? 1.0f / _baseline : 0;
+        _ux = (_a[_far].x - _a[0].x) * inv;
+        _uy = (_a[_far].y - _a[0].y) * inv;
+
+        // 法向量取 u 逆时针旋转 90°，基站沿 +x 排列时指向车前
+        _nx = -_uy;
+        _ny = _ux;
+
+        _collinear = true;
+        for (int i = 1; i < N; i++) {
+            float off = (_a[i].x - _a[0].x) * _nx + (_a[i].y - _a[0].y) * _ny;
+            if (fabsf(off) > UWB_MULTILAT_COLLINEAR_CM) _collinear = false;
+        }
+    }
+
+    /**
+     * @brief 由各基站测距解算位置
+     * @param d 各基站距离 (cm)
+     * @param hintX, hintY 参考点 (cm)，共线时用于选择前后侧
+     * @return false 距离无效
+     */
+    bool solve(const float (&d)[N], float hintX, float hintY, MultilatFix& out) const {
+        for (int i = 0; i < N; i++) {
+            if (!(d[i] > 0)) return false;
+        }
+        if (_baseline <= 0) return false;
+
+        // 基准线两端基站的两圆交点，前后两侧各一个
+        float s = (sq(d[0]) - sq(d[_far]) + sq(_baseline)) / (2 * _baseline);
+        float hSq = sq(d[0]) - s * s;
+        float h = (hSq > 0) ? fastSqrt(hSq) : 0;
+        float baseX = _a[0].x + s * _ux;
+        float baseY = _a[0].y + s * _uy;
+        float side = ((hintX - _a[0].x) * _nx + (hintY - _a[0].y) * _ny) >= 0 ? 1.0f : -1.0f;
+
+        out.x = baseX + side * h * _nx;
+        out.y = baseY + side * h * _ny;
+        out.iterations = 0;
+        out.ambiguous = _collinear;
+
+        if (N == 2) {
+            out.residual = residualRms(d, out.x, out.y);
+            return true;
+        }
+
+        refine(d, out);
+        if (!_collinear) {
+            MultilatFix mirror = out;
+            mirror.x = baseX - side * h * _nx;
+            mirror.y = baseY - side * h * _ny;
+            refine(d, mirror);
+            uint8_t total = (uint8_t)(out.iterations + mirror.iterations);
+            if (mirror.residual < out.residual) out = mirror;
+            out.iterations = total;
+        }
+        return true;
+    }
+
+    bool isCollinear() const { return _collinear; }
+
+private:
+    AnchorPos _a[N] = {};
+    int _far = 1;
+    float _baseline = 0;
+    float _ux = 1, _uy = 0;
+    float _nx = 0, _ny = 1;
+    bool _collinear = true;
+
+    static float sq(float v) { return v * v; }
+
+    float residualRms(const float (&d)[N], float x, float y) const {
+        float acc = 0;
+        for (int i = 0; i < N; i++) {
+            float e = fastSqrt(sq(x - _a[i].x) + sq(y - _a[i].y)) - d[i];
+            acc += e * e;
+        }
+        return fastSqrt(acc / N);
+    }
+
+    // Gauss-Newton: 最小化 sum(|p - a_i| - d_i)^2
+    void refine(const float (&d)[N], MultilatFix& fix) const {
+        float x = fix.x;
+        float y = fix.y;
+        uint8_t it = 0;
+        while (it < UWB_MULTILAT_MAX_ITER) {
+            it++;
+            float jxx = 0, jxy = 0, jyy = 0, gx = 0, gy = 0;
+            for (int i = 0; i < N; i++) {
+                float dx = x - _a[i].x;
+                float dy = y - _a[i].y;
+                float r = fastSqrt(dx * dx + dy * dy);
+                if (r < 1e-3f) continue;
+                float jx = dx / r;
+                float jy = dy / r;
+                float e = r - d[i];
+                jxx += jx * jx;
+                jxy += jx * jy;
+                jyy += jy * jy;
+                gx += jx * e;
+                gy += jy * e;
+            }
+            float det = jxx * jyy - jxy * jxy;
+            if (fabsf(det) < 1e-6f) break;
+            float stepX = -(jyy * gx - jxy * gy) / det;
+            float stepY = -(jxx * gy - jxy * gx) / det;
+            x += stepX;
+            y += stepY;
+            if (stepX * stepX + stepY * stepY < sq(UWB_MULTILAT_TOLERANCE)) break;
+        }
+        fix.x = x;
+        fix.y = y;
+        fix.iterations = it;
+        fix.residual = residualRms(d, x, y);
+    }
+};
+
+#endif // MULTILAT_H
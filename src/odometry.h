@@ -0,0 +1,82 @@
+/**
+ * @file odometry.h
+ * @brief 差速底盘航位推算
+ * @details 底盘没有编码器，按电机实际输出占空比 (斜坡之后) 估计轮速：
+ *          v = 占空比 × CART_SPEED_PER_DUTY。只用于短时间内的相对位姿
+ *          (面包屑轨迹跟随)，长时间会漂移
+ */
+
+#ifndef ODOMETRY_H
+#define ODOMETRY_H
+
+#include <math.h>
+#include <stdint.h>
+#include "config.h"
+
+// 里程计坐标系位姿: 原点为开始推算时的车中心，y 为当时车头方向，x 向右
+struct Pose {
+    float x;            // cm
+    float y;            // cm
+    float heading;      // rad, 0 = 初始车头方向, 正值向右转
+};
+
+class Odometry {
+public:
+    void reset() { _pose = Pose{0, 0, 0}; }
+
+    /**
+     * @brief 按左右轮占空比推进 dt 秒
+     */
+    void update(int16_t leftDuty, int16_t rightDuty, float dt) {
+        float vl = leftDuty * CART_SPEED_PER_DUTY;
+        float vr = rightDuty * CART_SPEED_PER_DUTY;
+        float w = (vl - vr) / CART_TRACK_WIDTH;   // 左轮快 -> 向右转
+        advance(0.5f * (vl + vr) * dt, w * dt);
+    }
+
+    /**
+     * @brief 同上，航向变化取陀螺仪测得的转角 (rad, 右转为正)，不受轮子打滑与左右轮差异影响
+     */
+    void update(int16_t leftDuty, int16_t rightDuty, float dt, float yawRad) {
+        advance(0.5f * (leftDuty + rightDuty) * CART_SPEED_PER_DUTY * dt, yawRad);
+    }
+
+    const Pose& pose() const { return _pose; }
+
+    /**
+     * @brief 车体坐标 (x 右, y 前) -> 里程计坐标
+     */
+    void toOdom(float bx, float by, float& ox, float& oy) const {
+        float s = sinf(_pose.heading);
+        float c = cosf(_pose.heading);
+        ox = _pose.x + bx * c + by * s;
+        oy = _pose.y - bx * s + by * c;
+    }
+
+    /**
+     * @brief 里程计坐标 -> 车体坐标
+     */
+    void toBody(float ox, float oy, float& bx, float& by) const {
+        float s = sinf(_pose.heading);
+        float c = cosf(_pose.heading);
+        float dx = ox - _pose.x;
+        float dy = oy - _pose.y;
+        bx = dx * c - dy * s;
+        by = dx * s + dy * c;
+    }
+
+private:
+    Pose _pose = {0, 0, 0};
+
+    // 中点航向积分，转弯时比欧拉法误差小
+    void advance(float distance, float turn) {
+        float mid = _pose.heading + 0.5f * turn;
+        _pose.x += distance * sinf(mid);
+        _pose.y += distance * cosf(mid);
+        _pose.heading += turn;
+        if (_pose.heading > (float)M_PI) _pose.heading -= 2.0f * (float)M_PI;
+        if (_pose.heading < -(float)M_PI) _pose.heading += 2.0f * (float)M_PI;
+    }
+};
+
+#endif // ODOMETRY_H
@@ -21,6 +21,7 @@ void Path::startRecording() {
     _isRecording = true;
     _lastAction = ACTION_STOP;
     _lastActionTime = millis();
+    motor.getTravel(_lastTravel[0], _lastTravel[1]);
     DEBUG_PRINTLN("ʼ·¼");
 }
 
@@ -42,17 +43,28 @@ void Path::recordStep(PathActionType action) {
     // ı䣬һζĳʱ
     if (action != _lastAction) {
         unsigned long duration = millis() - _lastActionTime;
+        uint32_t left, right;
+        motor.getTravel(left, right);
 
         // ̵̫Ķ (<100ms)
         if (duration > 100 && _stepCount < PATH_MAX_STEPS) {
             _steps[_stepCount].action = _lastAction;
             _steps[_stepCount].duration = duration;
+#if PATH_REPLAY_BY_TRAVEL && MOTOR_RAMP_ENABLED
+            _steps[_stepCount].travel = stepTravel(_lastAction, (int32_t)(left - _lastTravel[0]),
+                                                  (int32_t)(right - _lastTravel[1]));
+#else
+            _steps[_stepCount].travel = 0;
+#endif
             _stepCount++;
-            DEBUG_PRINTF("¼ %d: Act=%d, Time=%lu\n", _stepCount, _lastAction, duration);
+            DEBUG_PRINTF("¼ %d: Act=%d, Time=%lu, Travel=%ld\n", _stepCount, _lastAction, duration,
+                         (long)_steps[_stepCount - 1].travel);
         }
 
         _lastAction = action;
         _lastActionTime = millis();
+        _lastTravel[0] = left;
+        _lastTravel[1] = right;
     }
 }
 
@@ -69,10 +81,7 @@ bool Path::startReturning() {
 
     _isReturning = true;
     _currentReturnStep = 0; // ????????
-    _returnStepStartTime = millis();
-
-    PathStep step = _steps[_currentReturnStep];
-    executeAction(step.action);
+    beginReturnStep();
 
     DEBUG_PRINTLN("????????..");
     return true;
@@ -103,15 +112,13 @@ bool Path::updateReturning() {
     PathStep currentStep = _steps[_currentReturnStep];
 
     // ????????????
-    if (millis() - _returnStepStartTime >= currentStep.duration) {
+    if (returnStepDone(currentStep)) {
         _currentReturnStep++;
 
         if (_currentReturnStep < _stepCount) {
-            _returnStepStartTime = millis();
-            PathStep nextStep = _steps[_currentReturnStep];
-            executeAction(nextStep.action);
+            beginReturnStep();
 
-            DEBUG_PRINTF("???? %d: Act=%d\n", _currentReturnStep, nextStep.action);
+            DEBUG_PRINTF("???? %d: Act=%d\n", _currentReturnStep, _steps[_currentReturnStep].action);
         }
     }
 
@@ -122,6 +129,43 @@ bool Path::updateReturning() {
 
 
 
+void Path::beginReturnStep() {
+    _returnStepStartTime = millis();
+    motor.getTravel(_returnTravel[0], _returnTravel[1]);
+    _returnProgress = 0;
+    executeAction(_steps[_currentReturnStep].action);
+}
+
+bool Path::returnStepDone(const PathStep& step) {
+    unsigned long elapsed = millis() - _returnStepStartTime;
+#if PATH_REPLAY_BY_TRAVEL && MOTOR_RAMP_ENABLED
+    if (step.travel > 0) {
+        uint32_t left, right;
+        motor.getTravel(left, right);
+        // ۼƼƣ޷Ųֵȡг
+        int32_t progress = stepTravel(step.action, (int32_t)(left - _returnTravel[0]),
+                                      (int32_t)(right - _returnTravel[1]));
+        // ϴμĽȹ´μʱг̣Ĵθӽʾг̾Ĵν
+        int32_t next = 2 * progress - _returnProgress;
+        _returnProgress = progress;
+        // ָгбƽᳬʱʱ׷ֹͣڸò
+        return next - step.travel >= step.travel - progress || elapsed >= 2 * step.duration;
+    }
+#endif
+    return elapsed >= step.duration;
+}
+
+// ֱȡƽԭתȡֲһ (ȡֵ)
+int32_t Path::stepTravel(PathActionType action, int32_t left, int32_t right) {
+    switch (action) {
+        case ACTION_FORWARD:
+        case ACTION_BACKWARD: return abs(left + right) / 2;
+        case ACTION_LEFT:
+        case ACTION_RIGHT:    return abs(right - left) / 2;
+        default:              return 0;
+    }
+}
+
 void Path::executeAction(PathActionType action) {
     switch (action) {
         case ACTION_FORWARD:  motor.forward(); break;
@@ -21,6 +21,7 @@ enum PathActionType {
 struct PathStep {
     PathActionType action;
     unsigned long duration; // ms
+    int32_t travel;         // 示教时的指令行程 (见 Motor::getTravel)，0 = 回放按时长
 };
 
 class Path {
@@ -74,9 +75,16 @@ private:
     PathActionType _lastAction = ACTION_STOP;
     unsigned long _lastActionTime = 0;
     
+    uint32_t _lastTravel[2] = {0, 0};   // 当前录制步骤开始时的累计行程
+
     int _currentReturnStep = -1;
     unsigned long _returnStepStartTime = 0;
-    
+    uint32_t _returnTravel[2] = {0, 0}; // 当前回放步骤开始时的累计行程
+    int32_t _returnProgress = 0;        // 上次检查时本步已走的行程
+
+    void beginReturnStep();
+    bool returnStepDone(const PathStep& step);
+    static int32_t stepTravel(PathActionType action, int32_t left, int32_t right);
     void executeAction(PathActionType action);
     PathActionType getReverseAction(PathActionType action);
 };
@@ -0,0 +1,65 @@
+/**
+ * @file range_rate.h
+ * @brief 由带时间戳的距离序列估计距离变化率
+ * @details 保存最近 N 个 (时刻, 距离) 样本，对窗口内的样本做最小二乘直线拟合，
+ *          斜率即距离变化率 (cm/s)。样本按真实到达时刻计算，
+ *          不受调用频率与样本间隔不均匀的影响
+ */
+
+#ifndef RANGE_RATE_H
+#define RANGE_RATE_H
+
+#include <stdint.h>
+
+template <int N>
+class RangeRateEstimator {
+public:
+    void clear() { _size = 0; }
+
+    void add(unsigned long timeUs, float range) {
+        _time[_next] = timeUs;
+        _range[_next] = range;
+        _next = (_next + 1) % N;
+        if (_size < N) _size++;
+        _latestUs = timeUs;
+    }
+
+    /**
+     * @brief 窗口内样本的距离变化率
+     * @param windowUs 只使用最新样本之前 windowUs 内的样本
+     * @param minSpanUs 样本时间跨度小于该值时认为不可靠
+     * @return false 样本不足 (少于 3 个或跨度不够)
+     */
+    bool rate(unsigned long windowUs, unsigned long minSpanUs, float& out) const {
+        // 以最新样本为时间原点，避免 micros 的大数值损失 float 精度
+        float st = 0, sr = 0, stt = 0, str = 0;
+        int n = 0;
+        float span = 0;
+        for (int i = 0; i < _size; i++) {
+            unsigned long age = _latestUs - _time[i];
+            if (age > windowUs) continue;
+            float t = -(float)age * 1e-6f;
+            float r = _range[i];
+            st += t;
+            sr += r;
+            stt += t * t;
+            str += t * r;
+            if (-t > span) span = -t;
+            n++;
+        }
+        if (n < 3 || span * 1e6f < (float)minSpanUs) return false;
+        float den = n * stt - st * st;
+        if (den <= 0) return false;
+        out = (n * str - st * sr) / den;
+        return true;
+    }
+
+private:
+    unsigned long _time[N];
+    float _range[N];
+    unsigned long _latestUs = 0;
+    int _next = 0;
+    int _size = 0;
+};
+
+#endif // RANGE_RATE_H
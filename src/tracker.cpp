@@ -0,0 +1,150 @@
+/**
+ * @file tracker.cpp
+ * @brief 目标跟踪器实现 - 匀速模型 EKF，全部使用单精度浮点
+ */
+
+#include "tracker.h"
+#include "fast_math.h"
+
+void TargetTracker::init(float x, float y, unsigned long timeUs) {
+    _s[0] = x;
+    _s[1] = y;
+    _s[2] = 0;
+    _s[3] = 0;
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            _p[i][j] = 0;
+        }
+    }
+    _p[0][0] = UWB_TRACK_INIT_POS_VAR;
+    _p[1][1] = UWB_TRACK_INIT_POS_VAR;
+    _p[2][2] = UWB_TRACK_INIT_VEL_VAR;
+    _p[3][3] = UWB_TRACK_INIT_VEL_VAR;
+    _timeUs = timeUs;
+    _initialized = true;
+}
+
+void TargetTracker::propagate(float dt) {
+    // 状态: x += vx*dt, y += vy*dt
+    _s[0] += _s[2] * dt;
+    _s[1] += _s[3] * dt;
+
+    // P = F P F^T, F 仅在 (0,2)/(1,3) 处为 dt
+    for (int j = 0; j < 4; j++) {
+        _p[0][j] += dt * _p[2][j];
+        _p[1][j] += dt * _p[3][j];
+    }
+    for (int i = 0; i < 4; i++) {
+        _p[i][0] += dt * _p[i][2];
+        _p[i][1] += dt * _p[i][3];
+    }
+
+    // 白噪声加速度模型的过程噪声
+    const float q = UWB_TRACK_ACCEL_NOISE * UWB_TRACK_ACCEL_NOISE;
+    float dt2 = dt * dt;
+    float qPos = 0.25f * dt2 * dt2 * q;
+    float qCross = 0.5f * dt2 * dt * q;
+    float qVel = dt2 * q;
+    _p[0][0] += qPos;
+    _p[1][1] += qPos;
+    _p[0][2] += qCross;
+    _p[2][0] += qCross;
+    _p[1][3] += qCross;
+    _p[3][1] += qCross;
+    _p[2][2] += qVel;
+    _p[3][3] += qVel;
+}
+
+void TargetTracker::updateRange(float anchorX, float anchorY, float distance, unsigned long timeUs) {
+    if (!_initialized) return;
+
+    // 乱序到达的样本不回退时间，直接按当前时刻观测
+    long elapsedUs = (long)(timeUs - _timeUs);
+    if (elapsedUs > 0) {
+        propagate((float)elapsedUs * 1e-6f);
+        _timeUs = timeUs;
+    }
+
+    float dx = _s[0] - anchorX;
+    float dy = _s[1] - anchorY;
+    float h = fastSqrt(dx * dx + dy * dy);
+    if (h < 1.0f) return;
+
+    // H = [dx/h, dy/h, 0, 0]
+    float h0 = dx / h;
+    float h1 = dy / h;
+    float pht[4];
+    for (int i = 0; i < 4; i++) {
+        pht[i] = _p[i][0] * h0 + _p[i][1] * h1;
+    }
+    float s = h0 * pht[0] + h1 * pht[1] + UWB_TRACK_RANGE_NOISE * UWB_TRACK_RANGE_NOISE;
+    float innovation = distance - h;
+
+    float k[4];
+    for (int i = 0; i < 4; i++) {
+        k[i] = pht[i] / s;
+        _s[i] += k[i] * innovation;
+    }
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            _p[i][j] -= k[i] * pht[j];
+        }
+    }
+
+    // 基站共线，前后不可区分，约定目标在车前方 (与几何解算一致)
+    if (_frontOnly && _s[1] < 0) {
+        _s[1] = -_s[1];
+        _s[3] = -_s[3];
+        const float sign[4] = {1, -1, 1, -1};
+        for (int i = 0; i < 4; i++) {
+            for (int j = 0; j < 4; j++) {
+                _p[i][j] *= sign[i] * sign[j];
+            }
+        }
+    }
+}
+
+void TargetTracker::rotate(float rad) {
+    if (!_initialized) return;
+    float c = cosf(rad);
+    float s = sinf(rad);
+    // 状态 (x, y) 与 (vx, vy) 各自旋转
+    for (int k = 0; k < 4; k += 2) {
+        float a = _s[k];
+        float b = _s[k + 1];
+        _s[k] = c * a - s * b;
+        _s[k + 1] = s * a + c * b;
+    }
+    // P = T P T^T, T = diag(R, R): 先旋转行，再旋转列
+    for (int j = 0; j < 4; j++) {
+        for (int k = 0; k < 4; k += 2) {
+            float a = _p[k][j];
+            float b = _p[k + 1][j];
+            _p[k][j] = c * a - s * b;
+            _p[k + 1][j] = s * a + c * b;
+        }
+    }
+    for (int i = 0; i < 4; i++) {
+        for (int k = 0; k < 4; k += 2) {
+            float a = _p[i][k];
+            float b = _p[i][k + 1];
+            _p[i][k] = c * a - s * b;
+            _p[i][k + 1] = s * a + c * b;
+        }
+    }
+}
+
+bool TargetTracker::predict(unsigned long timeUs, TrackState& out) const {
+    if (!_initialized) return false;
+
+    long elapsedUs = (long)(timeUs - _timeUs);
+    if (elapsedUs < 0) elapsedUs = 0;
+    if (elapsedUs > UWB_TRACK_MAX_PREDICT_MS * 1000L) elapsedUs = UWB_TRACK_MAX_PREDICT_MS * 1000L;
+    float dt = (float)elapsedUs * 1e-6f;
+
+    out.x = _s[0] + _s[2] * dt;
+    out.y = _s[1] + _s[3] * dt;
+    out.vx = _s[2];
+    out.vy = _s[3];
+    return true;
+}
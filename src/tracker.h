@@ -0,0 +1,75 @@
+/**
+ * @file tracker.h
+ * @brief 目标跟踪器 - 匀速模型卡尔曼滤波 (EKF)
+ * @details 状态为车体坐标系下的 (x, y, vx, vy)，单位 cm 与 cm/s。
+ *          每个基站的带时间戳测距单独作为一次标量观测更新，
+ *          可在任意时刻查询预测位置与速度，控制频率可高于测距频率
+ */
+
+#ifndef TRACKER_H
+#define TRACKER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// 跟踪器输出
+struct TrackState {
+    float x;    // 横向位置 (cm)
+    float y;    // 前向位置 (cm)
+    float vx;   // 横向速度 (cm/s)
+    float vy;   // 前向速度 (cm/s)
+};
+
+class TargetTracker {
+public:
+    /**
+     * @brief 清空状态，等待重新初始化
+     */
+    void reset() { _initialized = false; }
+
+    /**
+     * @brief 用一次几何解算位置初始化，速度置零
+     * @param timeUs 位置对应的时刻 (micros)
+     */
+    void init(float x, float y, unsigned long timeUs);
+
+    /**
+     * @brief 用单个基站的测距更新
+     * @param anchorX, anchorY 基站在车体坐标系中的位置 (cm)
+     * @param distance 测距 (cm)
+     * @param timeUs 测距到达时刻 (micros)
+     */
+    void updateRange(float anchorX, float anchorY, float distance, unsigned long timeUs);
+
+    /**
+     * @brief 基站共线 (装在 y=0 横轴上) 时前后不可区分，约定目标在车前方
+     */
+    void setFrontOnly(bool frontOnly) { _frontOnly = frontOnly; }
+
+    /**
+     * @brief 预测指定时刻的状态（不修改滤波器）
+     * @return false 未初始化
+     */
+    bool predict(unsigned long timeUs, TrackState& out) const;
+
+    /**
+     * @brief 位置与速度向量绕原点从 +x 向 +y 旋转 rad，协方差一起旋转
+     * @details 坐标系反向转过 rad 时调用 (车身转动，由陀螺仪积分角度得到)；
+     *          匀速模型是线性的，旋转与外推可交换，与转动发生在上次测距之后的哪个时刻无关
+     */
+    void rotate(float rad);
+
+    bool isInitialized() const { return _initialized; }
+    unsigned long lastUpdateUs() const { return _timeUs; }
+
+private:
+    float _s[4] = {0};      // x, y, vx, vy
+    float _p[4][4] = {{0}}; // 协方差
+    unsigned long _timeUs = 0;
+    bool _initialized = false;
+    bool _frontOnly = true;
+
+    void propagate(float dt);
+};
+
+#endif // TRACKER_H
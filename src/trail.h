@@ -0,0 +1,92 @@
+/**
+ * @file trail.h
+ * @brief 面包屑轨迹与纯追踪前视点
+ * @details 用户在里程计坐标系中的位置按最小间距写入定长环形缓冲，
+ *          车沿这些点行进而不是直接朝用户当前位置走，转角和门口处不抄近路。
+ *          追踪时丢弃车已到达 (距离小于前视距离) 的点，取第一个不小于
+ *          前视距离的点作为前视点。写入和追踪都不分配内存，
+ *          追踪的均摊代价为 O(1) (每个点只被丢弃一次)
+ */
+
+#ifndef TRAIL_H
+#define TRAIL_H
+
+#include <stdint.h>
+#include "config.h"
+
+struct TrailPoint {
+    float x;
+    float y;
+};
+
+template <int N>
+class BreadcrumbTrail {
+public:
+    static_assert(N >= 2, "轨迹容量至少为 2");
+
+    void clear() {
+        _head = 0;
+        _size = 0;
+    }
+
+    int size() const { return _size; }
+
+    /**
+     * @brief 写入用户位置，与上一点距离小于 spacing 时忽略；缓冲满时丢弃最旧的点
+     * @return true 已写入
+     */
+    bool push(float x, float y, float spacing) {
+        if (_size > 0) {
+            const TrailPoint& last = at(_size - 1);
+            float dx = x - last.x;
+            float dy = y - last.y;
+            if (dx * dx + dy * dy < spacing * spacing) return false;
+        }
+        if (_size == N) {
+            popFront();
+            _overflows++;
+        }
+        _points[(_head + _size) % N] = TrailPoint{x, y};
+        _size++;
+        return true;
+    }
+
+    /**
+     * @brief 求前视点
+     * @param cx, cy 车在里程计坐标系中的位置
+     * @param lookahead 前视距离
+     * @param out 前视点；所有点都在前视距离内时为最新的点 (用户附近)
+     * @return false 轨迹为空
+     */
+    bool lookahead(float cx, float cy, float lookahead, TrailPoint& out) {
+        if (_size == 0) return false;
+        float l2 = lookahead * lookahead;
+        while (_size > 1 && dist2(at(0), cx, cy) < l2) {
+            popFront();
+        }
+        out = at(0);
+        return true;
+    }
+
+    const TrailPoint& at(int i) const { return _points[(_head + i) % N]; }
+    uint32_t overflows() const { return _overflows; }
+
+private:
+    TrailPoint _points[N];
+    int _head = 0;
+    int _size = 0;
+    uint32_t _overflows = 0;
+
+    void popFront() {
+        _head = (_head + 1) % N;
+        _size--;
+    }
+
+    static float dist2(const TrailPoint& p, float x, float y) {
+        float dx = p.x - x;
+        float dy = p.y - y;
+        return dx * dx + dy * dy;
+    }
+};
+
+#endif // TRAIL_H
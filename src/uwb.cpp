@@ -1,376 +1,424 @@
 /**
  * @file uwb.cpp
  * @brief UWB定位模块实现
- * 双基站定位算法
+ * 多基站定位算法
  */
 
 #include "uwb.h"
+#include "fast_math.h"
 
 UWB uwb;
 
-struct FrameParser {
-    uint8_t state = 0;  // 0=wait header, 1=len, 2=payload, 3=tail
-    uint8_t len = 0;
-    uint8_t index = 0;
-    uint8_t payload[8] = {0};
-};
-
-static int hexDigitValue(char c) {
-    if (c >= '0' && c <= '9') return c - '0';
-    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
-    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
-    return -1;
-}
+static const AnchorPos kAnchors[] = UWB_ANCHOR_POSITIONS;
+static_assert(sizeof(kAnchors) / sizeof(kAnchors[0]) == UWB_ANCHOR_COUNT,
+              "UWB_ANCHOR_POSITIONS 个数须等于 UWB_ANCHOR_COUNT");
+#define UWB_PORT_ONE(id, serial, uart, rx, tx) +1
+static_assert((0 UWB_ANCHOR_PORTS(UWB_PORT_ONE)) == UWB_ANCHOR_COUNT,
+              "UWB_ANCHOR_PORTS 行数须等于 UWB_ANCHOR_COUNT");
+#undef UWB_PORT_ONE
 
 void UWB::begin() {
-    // 开启两个串口
-    // Serial2 (UWB0): 可配置引脚
-    Serial2.begin(UWB_BAUD_RATE, SERIAL_8N1, UWB0_RX_PIN, UWB0_TX_PIN);
-    
-    // Serial1 (UWB1): 重映射引脚 RX=27, TX=13
-    Serial1.begin(UWB_BAUD_RATE, SERIAL_8N1, UWB1_RX_PIN, UWB1_TX_PIN);
+    _data = UWBData();
+    _solver.setAnchors(kAnchors);
+#if UWB_TRACKER_ENABLED
+    _tracker.setFrontOnly(_solver.isCollinear());
+#endif
     
-    _data = {0, 0, 0, 0, false, 0};
+#if UWB_RX_TASK_ENABLED
+    // 各基站串口 (UWB_ANCHOR_PORTS) 由后台任务通过 ESP-IDF 驱动接收
+    if (!_rx.begin()) {
+        DEBUG_PRINTLN("UWB接收任务启动失败");
+    }
+#else
+    // 逐个开启基站串口，引脚见 UWB_ANCHOR_PORTS
+#define UWB_PORT_BEGIN(id, serial, uart, rx, tx) serial.begin(UWB_BAUD_RATE, SERIAL_8N1, rx, tx);
+    UWB_ANCHOR_PORTS(UWB_PORT_BEGIN)
+#undef UWB_PORT_BEGIN
+#endif
     
     DEBUG_PRINTLN("UWB模块初始化完成");
-    DEBUG_PRINTF("  UWB0: RX=16, TX=17 (Serial2)\n");
-    DEBUG_PRINTF("  UWB1: RX=%d, TX=%d (Serial1)\n", UWB1_RX_PIN, UWB1_TX_PIN);
-}
-
-static bool parseFrame(FrameParser& p, uint8_t b, uint16_t& addr, uint16_t& dist, uint8_t& rssi) {
-    switch (p.state) {
-        case 0:
-            if (b == 0xF0) {
-                p.state = 1;
-            }
-            break;
-        case 1:
-            p.len = b;
-            if (p.len == 0x05) {
-                p.index = 0;
-                p.state = 2;
-            } else {
-                p.state = 0;
-            }
-            break;
-        case 2:
-            p.payload[p.index++] = b;
-            if (p.index >= p.len) {
-                p.state = 3;
-            }
-            break;
-        case 3:
-            if (b == 0xAA) {
-                addr = (uint16_t)p.payload[0] | ((uint16_t)p.payload[1] << 8);
-                dist = (uint16_t)p.payload[2] | ((uint16_t)p.payload[3] << 8);
-                rssi = p.payload[4];
-                p.state = 0;
-                return true;
-            }
-            p.state = 0;
-            break;
-        default:
-            p.state = 0;
-            break;
-    }
-    return false;
-}
-
-static bool isPrintableAscii(uint8_t b) {
-    return b >= 0x20 && b <= 0x7E;
+#define UWB_PORT_PRINT(id, serial, uart, rx, tx) DEBUG_PRINTF("  UWB%d: RX=%d, TX=%d (%s)\n", id, rx, tx, #serial);
+    UWB_ANCHOR_PORTS(UWB_PORT_PRINT)
+#undef UWB_PORT_PRINT
 }
 
 void UWB::update() {
-    bool newData = false;
-    static FrameParser parser0;
-    static FrameParser parser1;
-    static unsigned long lastAscii0 = 0;
-    static unsigned long lastAscii1 = 0;
     unsigned long now = millis();
     
-    // 读取 UWB0 数据 (Serial2)
-    while (Serial2.available()) {
-        uint8_t b = (uint8_t)Serial2.read();
-        uint16_t addr = 0;
-        uint16_t dist = 0;
-        uint8_t rssi = 0;
-        if (parseFrame(parser0, b, addr, dist, rssi)) {
-            if (dist > 0) {
-                _data.d0 = (float)dist * UWB_DISTANCE_SCALE;
-                newData = true;
-            }
-        } else if (parser0.state == 0) {
-            if (b == '\n' || b == '\r') {
-                if (_buffer0.length() > 0) {
-                    float d = parseDistance(_buffer0);
-                    if (d > 0) {
-                        _data.d0 = d;
-                        newData = true;
-                    } else {
-                        DEBUG_PRINTF("UWB0 raw: %s\n", _buffer0.c_str());
-                    }
-                    _buffer0 = "";
-                }
-            } else if (isPrintableAscii(b)) {
-                lastAscii0 = now;
-                _buffer0 += (char)b;
-                if (_buffer0.length() > 200) {
-                    float d = parseDistance(_buffer0);
-                    if (d > 0) {
-                        _data.d0 = d;
-                        newData = true;
-                    } else {
-                        DEBUG_PRINTF("UWB0 raw: %s\n", _buffer0.c_str());
-                    }
-                    _buffer0 = "";
-                }
-            } else if (_buffer0.length() > 0) {
-                _buffer0 = "";
-            }
-        }
+#if UWB_TRACKER_ENABLED
+    // 失联后旧轨迹不再可信，重新捕获时从几何解算重新初始化
+    if (_tracker.isInitialized() && !isConnected()) {
+        _tracker.reset();
     }
+#endif
     
-    // 读取 UWB1 数据 (Serial1)
-    while (Serial1.available()) {
-        uint8_t b = (uint8_t)Serial1.read();
-        uint16_t addr = 0;
-        uint16_t dist = 0;
-        uint8_t rssi = 0;
-        if (parseFrame(parser1, b, addr, dist, rssi)) {
-            if (dist > 0) {
-                _data.d1 = (float)dist * UWB_DISTANCE_SCALE;
-                newData = true;
-            }
-        } else if (parser1.state == 0) {
-            if (b == '\n' || b == '\r') {
-                if (_buffer1.length() > 0) {
-                    float d = parseDistance(_buffer1);
-                    if (d > 0) {
-                        _data.d1 = d;
-                        newData = true;
-                    } else {
-                        DEBUG_PRINTF("UWB1 raw: %s\n", _buffer1.c_str());
-                    }
-                    _buffer1 = "";
-                }
-            } else if (isPrintableAscii(b)) {
-                lastAscii1 = now;
-                _buffer1 += (char)b;
-                if (_buffer1.length() > 200) {
-                    float d = parseDistance(_buffer1);
-                    if (d > 0) {
-                        _data.d1 = d;
-                        newData = true;
-                    } else {
-                        DEBUG_PRINTF("UWB1 raw: %s\n", _buffer1.c_str());
-                    }
-                    _buffer1 = "";
-                }
-            } else if (_buffer1.length() > 0) {
-                _buffer1 = "";
-            }
-        }
+#if UWB_RX_TASK_ENABLED
+    // 取出后台任务发布的全部样本，整批处理后每个标签只计算一次位置
+    (void)now;
+    UwbRangeSample sample;
+    while (_rx.receive(sample)) {
+        onRange(sample.anchor, sample.reading, sample.timeUs);
     }
-
-    // Fallback: no newline, flush after short idle
-    if (_buffer0.length() > 0 && (now - lastAscii0) > 30) {
-        float dist = parseDistance(_buffer0);
-        if (dist > 0) {
-            _data.d0 = dist;
-            newData = true;
-        } else {
-            DEBUG_PRINTF("UWB0 raw(noeol): %s\n", _buffer0.c_str());
-        }
-        _buffer0 = "";
+#else
+    // 逐路读空串口，整批解析后每个标签只计算一次位置
+    for (uint8_t i = 0; i < UWB_ANCHOR_COUNT; i++) {
+        // 时刻由通道按帧在读出块中的位置倒推到达时刻，同一批的多帧不共用时刻
+        _channels[i].poll(now, [&](const UwbReading& r, unsigned long timeUs) {
+            _health[i].onSample(timeUs);
+            onRange(i, r, timeUs);
+        });
     }
-    if (_buffer1.length() > 0 && (now - lastAscii1) > 30) {
-        float dist = parseDistance(_buffer1);
-        if (dist > 0) {
-            _data.d1 = dist;
-            newData = true;
-        } else {
-            DEBUG_PRINTF("UWB1 raw(noeol): %s\n", _buffer1.c_str());
+#endif
+    
+    for (uint8_t i = 0; i < UWB_TAG_CAPACITY; i++) {
+        UwbTag* tag = _tags.slot(i);
+        if (tag != nullptr && tag->pairReady) {
+            tag->pairReady = false;
+            calculatePosition(*tag);
         }
-        _buffer1 = "";
     }
     
-    if (newData) {
-        calculatePosition();
-        _data.lastUpdate = millis();
-        _data.valid = true;
-        
-        // 调试输出（限制频率）
-        static unsigned long lastPrint = 0;
-        if (millis() - lastPrint > 500) {
-            DEBUG_PRINTF("UWB: d0=%.0f, d1=%.0f -> Dist=%.0f, Ang=%.1f\n", 
-                         _data.d0, _data.d1, _data.distance, _data.angle);
-            lastPrint = millis();
-        }
+    selectTarget();
+    
+    UwbTag* target = _hasTarget ? _tags.find(_target) : nullptr;
+    if (target != nullptr && target->newFix) {
+        publish(*target);
+    }
+    for (uint8_t i = 0; i < UWB_TAG_CAPACITY; i++) {
+        UwbTag* tag = _tags.slot(i);
+        if (tag != nullptr) tag->newFix = false;
     }
 }
 
-float UWB::parseDistance(String& line) {
-    // 假设数据格式为 "D:123.45" 或类似
-    // 需要根据实际UWB模块输出格式调整
-    // 这里假设格式为: "DIST: 1.23m" 或纯数字或 "mc 0f 00000xxx" (如果是AT命令模式)
+void UWB::onRange(uint8_t anchor, const UwbReading& reading, unsigned long timeUs) {
+    if (anchor >= UWB_ANCHOR_COUNT) return;
     
-    // 简化处理：查找数字
-    // 如果是 "mid 0x0000xxxx ..." 这种十六进制格式，需要专门解析
-    // 假设是LinkTrack或通常的 "Distance: 120 cm"
+    // 按地址分到各自的标签，其它学生的标签不会混入跟随目标的距离
+    uint16_t addr = reading.hasMeta ? reading.addr : UWB_ADDR_UNKNOWN;
+    UwbTag* tag = _tags.acquire(addr, _target);
+    if (tag == nullptr) return;
+    tag->lastSeenUs = timeUs;
     
-    // ⚠️ 临时方案：模拟解析，期待格式中直接包含距离数值
-    // 这里需要根据您实际的UWB输出格式来写
-    // 假设格式是 "d: 120"
+    // 多径尖峰和弱信号的测距在进入定位前剔除
+    if (!tag->filters[anchor].accept(reading)) return;
+    float distance = reading.distance;
     
-    // Extract the last numeric token and convert to cm
-    line.trim();
-    if (line.length() == 0) return 0;
-
-    int len = line.length();
-    float value = 0;
-    bool found = false;
-    int lastEnd = -1;
-
-    for (int i = 0; i < len; i++) {
-        char c = line.charAt(i);
-        if ((c >= '0' && c <= '9') || c == '.' || c == '-' || c == '+') {
-            int j = i;
-            bool hasDigit = false;
-            if (line.charAt(j) == '-' || line.charAt(j) == '+') j++;
-            while (j < len) {
-                char cj = line.charAt(j);
-                if (cj >= '0' && cj <= '9') {
-                    hasDigit = true;
-                    j++;
-                } else if (cj == '.') {
-                    j++;
-                } else {
-                    break;
-                }
-            }
-            if (hasDigit) {
-                value = line.substring(i, j).toFloat();
-                found = true;
-                lastEnd = j;
-            }
-            i = j - 1;
+    AnchorTrack& a = tag->anchors[anchor];
+    a.raw = distance;
+    a.prevDistance = a.distance;
+#if UWB_RANGE_SMOOTH_ENABLED
+    // 该基站失联后重新出现时不沿用旧的平滑状态
+    float gapS = (timeUs - a.timeUs) * 1e-6f;
+    if (a.count == 0 || gapS * 1000.0f >= UWB_ANCHOR_TIMEOUT_MS) a.smooth.reset();
+    a.distance = a.smooth.update(distance, gapS);
+#else
+    a.distance = distance;
+#endif
+    a.prevTimeUs = a.timeUs;
+    a.timeUs = timeUs;
+    if (a.count < 2) a.count++;
+    
+#if UWB_TRACKER_ENABLED
+    // 跟随目标的每个测距在自己的到达时刻单独更新跟踪器
+    if (_hasTarget && addr == _target) {
+        const AnchorPos& pos = anchorPos(anchor);
+        _tracker.updateRange(pos.x, pos.y, distance, timeUs);
+    }
+#endif
+    
+    float ranges[UWB_ANCHOR_COUNT];
+    unsigned long fixUs = 0;
+    if (pairRanges(*tag, anchor, ranges, fixUs)) {
+        for (uint8_t i = 0; i < UWB_ANCHOR_COUNT; i++) {
+            tag->pairRanges[i] = ranges[i];
         }
+        tag->pairUs = fixUs;
+        tag->pairReady = true;
     }
+}
 
-    if (found && value > 0) {
-        float scale = 1.0f;
-        bool unitFound = false;
-        int k = lastEnd;
-        while (k < len) {
-            char ck = line.charAt(k);
-            if (ck != ' ' && ck != '\t' && ck != '\r' && ck != '\n') break;
-            k++;
-        }
-        if (k < len) {
-            char c0 = line.charAt(k);
-            if (c0 >= 'A' && c0 <= 'Z') c0 = (char)(c0 - 'A' + 'a');
-            char c1 = (k + 1 < len) ? line.charAt(k + 1) : '\0';
-            if (c1 >= 'A' && c1 <= 'Z') c1 = (char)(c1 - 'A' + 'a');
-            if (c0 == 'm' && c1 == 'm') {
-                scale = 0.1f; // mm -> cm
-                unitFound = true;
-            } else if (c0 == 'c' && c1 == 'm') {
-                scale = 1.0f; // cm
-                unitFound = true;
-            } else if (c0 == 'm') {
-                scale = 100.0f; // m -> cm
-                unitFound = true;
-            }
+bool UWB::pairRanges(const UwbTag& tag, uint8_t anchor, float (&ranges)[UWB_ANCHOR_COUNT], unsigned long& fixUs) {
+    // 新样本只与其它基站的最近样本配对，避免新旧距离混用导致角度跳变
+    const AnchorTrack& cur = tag.anchors[anchor];
+    bool aligned = true;
+    fixUs = cur.timeUs;
+    for (uint8_t i = 0; i < UWB_ANCHOR_COUNT; i++) {
+        const AnchorTrack& other = tag.anchors[i];
+        if (other.count == 0) return false;
+        long skew = (long)(cur.timeUs - other.timeUs);
+        if (skew < -UWB_PAIR_MAX_SKEW_US) return false;  // 本样本已过时
+        if (skew > UWB_PAIR_MAX_SKEW_US) aligned = false;
+        // 对齐时刻取各基站最近样本中最旧的一个
+        if ((long)(fixUs - other.timeUs) > 0) fixUs = other.timeUs;
+    }
+    
+    if (aligned) {
+        for (uint8_t i = 0; i < UWB_ANCHOR_COUNT; i++) {
+            ranges[i] = tag.anchors[i].distance;
         }
-
-        if (unitFound) {
-            return value * scale;
+        fixUs = cur.timeUs;
+        return true;
+    }
+    
+#if UWB_PAIR_INTERPOLATE
+    // 将较新基站的距离线性插值到对齐时刻
+    for (uint8_t i = 0; i < UWB_ANCHOR_COUNT; i++) {
+        const AnchorTrack& a = tag.anchors[i];
+        if ((long)(a.timeUs - fixUs) <= UWB_PAIR_MAX_SKEW_US) {
+            ranges[i] = a.distance;
+            continue;
         }
+        if (a.count < 2) return false;
+        long span = (long)(a.timeUs - a.prevTimeUs);
+        long back = (long)(fixUs - a.prevTimeUs);
+        if (span <= 0 || span > UWB_PAIR_MAX_SPAN_US || back < 0) return false;
+        float k = (float)back / (float)span;
+        ranges[i] = a.prevDistance + (a.distance - a.prevDistance) * k;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
 
-        return value * UWB_DISTANCE_SCALE;
+void UWB::calculatePosition(UwbTag& tag) {
+    // 所有的计算单位为 cm
+    
+    // 参考点用于基站共线时选择前后侧: 优先跟踪器预测，其次上一次位置，首次默认车前方
+    float hintX = tag.x;
+    float hintY = tag.hasFix ? tag.y : 1.0f;
+#if UWB_TRACKER_ENABLED
+    TrackState st;
+    if (_hasTarget && tag.addr == _target && _tracker.predict(tag.pairUs, st)) {
+        hintX = st.x;
+        hintY = st.y;
     }
+#endif
+    
+    MultilatFix fix;
+    if (!_solver.solve(tag.pairRanges, hintX, hintY, fix)) return;
+    
+    tag.x = fix.x;
+    tag.y = fix.y;
+    tag.residual = fix.residual;
+    tag.fixUs = tag.pairUs;
+    tag.hasFix = true;
+    tag.newFix = true;
+}
 
-    // Hex fallback: find last hex token (e.g., "0f 00000a3c")
-    unsigned long hexValue = 0;
-    bool hexFound = false;
-    for (int i = 0; i < len; i++) {
-        int j = i;
-        if (line.charAt(j) == '0' && (j + 1 < len)) {
-            char nx = line.charAt(j + 1);
-            if (nx == 'x' || nx == 'X') {
-                j += 2;
+void UWB::selectTarget() {
+    uint16_t next = _target;
+    bool has = _hasTarget;
+    
+    if (_ownerLocked) {
+        // 已配对: 只跟随主人，主人离开时停车而不是改跟别人
+        next = _owner;
+        has = true;
+    } else {
+        // 未配对: 跟随最近的标签，带切换余量避免在两人之间来回跳
+        UwbTag* cur = _hasTarget ? _tags.find(_target) : nullptr;
+        UwbTag* nearest = nearestTag();
+        if (nearest != nullptr && nearest != cur) {
+            bool curUsable = cur != nullptr && cur->hasFix && isTagFresh(*cur);
+            if (!curUsable ||
+                hypotf(nearest->x, nearest->y) < hypotf(cur->x, cur->y) - UWB_TAG_SWITCH_MARGIN) {
+                next = nearest->addr;
+                has = true;
             }
         }
+    }
+    
+    if (has == _hasTarget && next == _target) return;
+    _target = next;
+    _hasTarget = has;
+    _data = UWBData();
+    _data.addr = next;
+#if UWB_TRACKER_ENABLED
+    _tracker.reset();
+#endif
+    DEBUG_PRINTF("UWB target -> tag 0x%04X\n", next);
+}
 
-        unsigned long v = 0;
-        bool hasHex = false;
-        while (j < len) {
-            int hv = hexDigitValue(line.charAt(j));
-            if (hv >= 0) {
-                v = (v << 4) + (unsigned long)hv;
-                hasHex = true;
-                j++;
-            } else {
-                break;
-            }
-        }
+void UWB::publish(const UwbTag& tag) {
+    _data.addr = tag.addr;
+    float sum = 0;
+    for (uint8_t i = 0; i < UWB_ANCHOR_COUNT; i++) {
+        // 平滑只服务于角度/位置解算，发布未平滑的距离，测距变化率不带平滑滞后
+        _data.range[i] = tag.anchors[i].raw;
+        _data.rangeUs[i] = tag.anchors[i].timeUs;
+        sum += _data.range[i];
+    }
+    _data.meanRange = sum / UWB_ANCHOR_COUNT;
+    _data.x = tag.x;
+    _data.y = tag.y;
+    _data.residual = tag.residual;
+    _data.distance = tag.y;  // 前方垂直距离
+    _data.angle = bearingDeg(tag.x, tag.y);
+    _data.fixUs = tag.fixUs;
+    _data.seq = ++_seq;
+#if UWB_TRACKER_ENABLED
+    if (!_tracker.isInitialized()) {
+        _tracker.init(tag.x, tag.y, tag.fixUs);
+    }
+#endif
+    _data.lastUpdate = millis();
+    _data.valid = true;
+    
+    // 调试输出（限制频率）
+    static unsigned long lastPrint = 0;
+    if (millis() - lastPrint > 500) {
+        DEBUG_PRINTF("UWB[%04X]: R=%.0f -> Dist=%.0f, Ang=%.1f, Res=%.1f\n", 
+                     tag.addr, _data.meanRange, _data.distance, _data.angle, _data.residual);
+        lastPrint = millis();
+    }
+}
 
-        if (hasHex) {
-            hexValue = v;
-            hexFound = true;
-            i = j - 1;
+UwbTag* UWB::nearestTag() {
+    UwbTag* best = nullptr;
+    float bestRange = 0;
+    for (uint8_t i = 0; i < UWB_TAG_CAPACITY; i++) {
+        UwbTag* tag = _tags.slot(i);
+        if (tag == nullptr || !tag->hasFix || !isTagFresh(*tag)) continue;
+        float r = hypotf(tag->x, tag->y);
+        if (best == nullptr || r < bestRange) {
+            best = tag;
+            bestRange = r;
         }
     }
+    return best;
+}
 
-    if (!hexFound || hexValue == 0) return 0;
-    return (float)hexValue * UWB_HEX_SCALE;
+bool UWB::isTagFresh(const UwbTag& tag) const {
+    // 任一基站失联都不能继续使用其冻结的旧距离
+    unsigned long nowUs = micros();
+    for (uint8_t i = 0; i < UWB_ANCHOR_COUNT; i++) {
+        const AnchorTrack& a = tag.anchors[i];
+        if (a.count == 0) return false;
+        if ((nowUs - a.timeUs) >= (unsigned long)UWB_ANCHOR_TIMEOUT_MS * 1000UL) return false;
+    }
+    return true;
 }
 
-void UWB::calculatePosition() {
-    float d0 = _data.d0;
-    float d1 = _data.d1;
-    float L = UWB_BASELINE;
-    
-    if (d0 <= 0 || d1 <= 0) return;
-    
-    // 所有的计算单位为 cm
-    
-    // 三角定位算法
-    // 设车中心为原点 (x, y)
-    // d0^2 = (x + L/2)^2 + y^2
-    // d1^2 = (x - L/2)^2 + y^2
-    
-    // 简化公式计算相对坐标 (距离和角度)
-    // 余弦定理：
-    // cos(theta) = (d0^2 + L^2 - d1^2) / (2 * d0 * L)
-    
-    float cos_theta = (d0 * d0 + L * L - d1 * d1) / (2 * d0 * L);
-    cos_theta = constrain(cos_theta, -1.0f, 1.0f);
-    
-    // x偏离中心距离
-    // 这是一个近似计算，假设两个传感器在一条直线上，目标在前方
-    
-    // 计算左右偏移
-    // 如果 d0 > d1，说明目标偏向左边 (UWB1更近)
-    // 如果 d0 < d1，说明目标偏向右边 (UWB0更近)
-    
-    // 简单计算：
-    float x = (d0 * d0 - d1 * d1) / (2 * L);
-    float y_sq = d0 * d0 - (x + L/2) * (x + L/2);
-    float y = (y_sq > 0) ? sqrt(y_sq) : 0;
-    
-    _data.distance = y;  // 前方垂直距离
-    
+bool UWB::pairOwner() {
+    UwbTag* nearest = nearestTag();
+    if (nearest == nullptr) return false;
+    _owner = nearest->addr;
+    _ownerLocked = true;
+    selectTarget();
+    return true;
+}
+
+void UWB::clearOwner() {
+    _ownerLocked = false;
+}
+
+float UWB::bearingDeg(float x, float y) {
     // 计算角度 (正前方为0，左负右正)
     // x 正值表示偏右，负值表示偏左
-    float angle = atan2(x, y) * 180.0 / PI;
+    float angle = fastAtan2Deg(x, y);
 #if UWB_ANGLE_INVERT
     angle = -angle;
 #endif
     angle += UWB_ANGLE_OFFSET;
-    _data.angle = angle;
+    return angle;
+}
+
+const AnchorPos& UWB::anchorPos(uint8_t anchor) {
+    return kAnchors[anchor];
+}
+
+UWBData UWB::getPrediction(unsigned long timeUs) const {
+    UWBData out = _data;
+#if UWB_TRACKER_ENABLED
+    TrackState st;
+    if (_tracker.predict(timeUs, st)) {
+        out.x = st.x;
+        out.y = st.y;
+        out.vx = st.vx;
+        out.vy = st.vy;
+        out.distance = st.y;
+        out.angle = bearingDeg(st.x, st.y);
+        // d/dt atan2(x, y)，与 bearingDeg 同号
+        float r2 = st.x * st.x + st.y * st.y;
+        out.angleRate = (r2 > 1.0f) ? (st.vx * st.y - st.vy * st.x) / r2 * FAST_RAD_TO_DEG : 0.0f;
+#if UWB_ANGLE_INVERT
+        out.angleRate = -out.angleRate;
+#endif
+        out.fixUs = timeUs;
+    }
+#else
+    (void)timeUs;
+#endif
+    return out;
+}
+
+void UWB::rotateFrame(float yawDeg) {
+#if UWB_TRACKER_ENABLED
+    // 车右转 yaw 时，车体坐标 (x 右, y 前) 中的固定点从 +x 向 +y 转过 yaw；
+    // 跟踪器坐标 x 取反 (UWB_ANGLE_INVERT) 时方向相反
+#if UWB_ANGLE_INVERT
+    _tracker.rotate(-yawDeg * FAST_DEG_TO_RAD);
+#else
+    _tracker.rotate(yawDeg * FAST_DEG_TO_RAD);
+#endif
+#else
+    (void)yawDeg;
+#endif
 }
 
 bool UWB::isConnected() {
+    const UwbTag* tag = _hasTarget ? _tags.find(_target) : nullptr;
+    if (tag == nullptr || !isTagFresh(*tag)) return false;
     return (millis() - _data.lastUpdate) < 2000; // 2秒超时
 }
+
+bool UWB::isAnchorFresh(uint8_t anchor) const {
+    const UwbTag* tag = _hasTarget ? _tags.find(_target) : nullptr;
+    if (anchor >= UWB_ANCHOR_COUNT || tag == nullptr || tag->anchors[anchor].count == 0) return false;
+    return (micros() - tag->anchors[anchor].timeUs) < (unsigned long)UWB_ANCHOR_TIMEOUT_MS * 1000UL;
+}
+
+void UWB::printStats(Print& out) {
+#if UWB_RX_TASK_ENABLED
+    for (uint8_t i = 0; i < UWB_ANCHOR_COUNT; i++) {
+        UwbRxStats st = _rx.getStats(i);
+        out.printf("UWB%u: samples=%lu ovf=%lu full=%lu frame_err=%lu parity_err=%lu drops=%lu\n",
+                   i, (unsigned long)st.samples, (unsigned long)st.rxOverflow,
+                   (unsigned long)st.bufferFull, (unsigned long)st.frameErrors,
+                   (unsigned long)st.parityErrors, (unsigned long)st.queueDrops);
+        _rx.getHealth(i).print(out, i, st.link, micros());
+    }
+#else
+    out.println("UWB RX task disabled (polling mode)");
+    for (uint8_t i = 0; i < UWB_ANCHOR_COUNT; i++) {
+        _health[i].print(out, i, _channels[i].format().stats(), micros());
+    }
+#endif
+#if UWB_LOG_ENABLED
+    UwbLogStats ls = uwbLog.getStats();
+    out.printf("UWB log: records=%lu bytes=%lu/%u overwritten=%lu dropped=%lu\n",
+               (unsigned long)ls.records, (unsigned long)ls.bytes, (unsigned)UWB_LOG_BUFFER_SIZE,
+               (unsigned long)ls.overwritten, (unsigned long)ls.dropped);
+#endif
+    if (_ownerLocked) {
+        out.printf("Tags: %u (evicted %lu), owner=0x%04X\n", _tags.size(),
+                   (unsigned long)_tags.evictions(), _owner);
+    } else {
+        out.printf("Tags: %u (evicted %lu), owner=none (following nearest)\n", _tags.size(),
+                   (unsigned long)_tags.evictions());
+    }
+    unsigned long nowUs = micros();
+    for (uint8_t i = 0; i < UWB_TAG_CAPACITY; i++) {
+        UwbTag* tag = _tags.slot(i);
+        if (tag == nullptr) continue;
+        out.printf("Tag 0x%04X%s: x=%.0f y=%.0f res=%.1f age=%lums\n", tag->addr,
+                   (_hasTarget && tag->addr == _target) ? " [target]" : "",
+                   tag->x, tag->y, tag->residual, (nowUs - tag->lastSeenUs) / 1000UL);
+        for (uint8_t a = 0; a < UWB_ANCHOR_COUNT; a++) {
+            const RangeFilterStats& fs = tag->filters[a].getStats();
+            out.printf("  UWB%u filter: accepted=%lu outliers=%lu low_rssi=%lu\n",
+                       a, (unsigned long)fs.accepted, (unsigned long)fs.outliers,
+                       (unsigned long)fs.lowRssi);
+        }
+    }
+}
@@ -8,15 +8,32 @@
 
 #include <Arduino.h>
 #include "config.h"
+#include "uwb_channel.h"
+#include "uwb_rx.h"
+#include "tracker.h"
+#include "uwb_tags.h"
+#include "multilat.h"
+#include "uwb_log.h"
+#include "uwb_link.h"
 
 // UWB数据结构
 struct UWBData {
-    float d0;           // 基站0距离 (cm)
-    float d1;           // 基站1距离 (cm)
+    float range[UWB_ANCHOR_COUNT];          // 各基站距离 (cm，未平滑)
+    float meanRange;    // 各基站距离均值 (cm)，即到基站中心的斜距
     float distance;     // 目标综合距离 (cm)
     float angle;        // 目标角度 (度)
     bool valid;         // 数据有效性
     unsigned long lastUpdate;
+    unsigned long rangeUs[UWB_ANCHOR_COUNT]; // 各基站距离到达时间 (micros)
+    unsigned long fixUs; // distance/angle 对应的时刻 (micros)
+    float x;            // 目标横向位置 (cm)
+    float y;            // 目标前向位置 (cm)
+    float vx;           // 目标横向速度 (cm/s)，仅跟踪器输出
+    float vy;           // 目标前向速度 (cm/s)，仅跟踪器输出
+    float angleRate;    // 目标角度变化率 (度/s)，仅跟踪器输出
+    float residual;     // 定位残差 RMS (cm)，越小越可信
+    uint16_t addr;      // 数据所属标签地址
+    uint32_t seq;       // 定位结果序号，每发布一次新结果加 1 (0 = 尚无结果)
 };
 
 class UWB {
@@ -28,21 +45,93 @@ public:
      * @brief 获取当前数据
      */
     UWBData getData() const { return _data; }
+
+    /**
+     * @brief 获取跟踪器在指定时刻的预测数据
+     * @param timeUs 查询时刻 (micros)
+     * @details 跟踪器未启用或未初始化时返回最近一次几何解算结果
+     */
+    UWBData getPrediction(unsigned long timeUs) const;
+
+    /**
+     * @brief 车身转过 yawDeg (右转为正) 后把跟踪器状态转到新的车体坐标系
+     * @details 由控制任务按陀螺仪积分角度调用；跟踪器未启用时不处理
+     */
+    void rotateFrame(float yawDeg);
     
     /**
-     * @brief 检查UWB是否连接正常
+     * @brief 检查UWB是否连接正常（跟随目标的所有基站测距均未超时）
      */
     bool isConnected();
 
+    /**
+     * @brief 检查跟随目标在单个基站上的数据是否新鲜
+     */
+    bool isAnchorFresh(uint8_t anchor) const;
+
+    /**
+     * @brief 将当前最近的标签配对为主人，此后只跟随该地址
+     * @return false 附近没有可配对的标签
+     */
+    bool pairOwner();
+
+    /**
+     * @brief 取消主人配对，恢复跟随最近的标签
+     */
+    void clearOwner();
+
+    bool hasOwner() const { return _ownerLocked; }
+    uint16_t getOwner() const { return _owner; }
+
+    /**
+     * @brief 打印串口接收、链路健康与预滤波统计（溢出/帧错误/帧率/间隔直方图/离群剔除等）
+     */
+    void printStats(Print& out);
+
 private:
     UWBData _data;
+    uint32_t _seq = 0;
+    UwbTagTable _tags;
+    Multilateration<UWB_ANCHOR_COUNT> _solver;
+    uint16_t _owner = UWB_TAG_ADDR;
+    bool _ownerLocked = (UWB_TAG_ADDR != 0xFFFF);
+    uint16_t _target = UWB_TAG_ADDR;    // 当前跟随的标签地址
+    bool _hasTarget = (UWB_TAG_ADDR != 0xFFFF);
+    
+#if UWB_TRACKER_ENABLED
+    // 只跟踪当前跟随目标，目标切换时重新初始化
+    TargetTracker _tracker;
+#endif
     
-    // 串口解析相关
-    String _buffer0;
-    String _buffer1;
+#if UWB_RX_TASK_ENABLED
+    // 后台任务接收，loop 中只取样本
+    UwbRx _rx;
+#elif UWB_LOG_ENABLED
+    // 每个基站一路串口 (config.h UWB_ANCHOR_PORTS)，读出的字节同时写入飞行记录
+#define UWB_PORT_TAP(id, serial, uart, rx, tx) {serial, id},
+#define UWB_PORT_CHANNEL(id, serial, uart, rx, tx) {_taps[id], id},
+    UwbLogTap<HardwareSerial> _taps[UWB_ANCHOR_COUNT] = {UWB_ANCHOR_PORTS(UWB_PORT_TAP)};
+    UwbChannel<UwbLogTap<HardwareSerial>> _channels[UWB_ANCHOR_COUNT] = {UWB_ANCHOR_PORTS(UWB_PORT_CHANNEL)};
+#undef UWB_PORT_TAP
+#undef UWB_PORT_CHANNEL
+    UwbLinkHealth _health[UWB_ANCHOR_COUNT];
+#else
+    // 每个基站一路串口 (config.h UWB_ANCHOR_PORTS)
+#define UWB_PORT_CHANNEL(id, serial, uart, rx, tx) {serial, id},
+    UwbChannel<HardwareSerial> _channels[UWB_ANCHOR_COUNT] = {UWB_ANCHOR_PORTS(UWB_PORT_CHANNEL)};
+#undef UWB_PORT_CHANNEL
+    UwbLinkHealth _health[UWB_ANCHOR_COUNT];
+#endif
     
-    float parseDistance(String& line);
-    void calculatePosition();
+    void onRange(uint8_t anchor, const UwbReading& reading, unsigned long timeUs);
+    bool pairRanges(const UwbTag& tag, uint8_t anchor, float (&ranges)[UWB_ANCHOR_COUNT], unsigned long& fixUs);
+    void calculatePosition(UwbTag& tag);
+    void selectTarget();
+    void publish(const UwbTag& tag);
+    UwbTag* nearestTag();
+    bool isTagFresh(const UwbTag& tag) const;
+    static float bearingDeg(float x, float y);
+    static const AnchorPos& anchorPos(uint8_t anchor);
 };
 
 extern UWB uwb;
@@ -0,0 +1,84 @@
+/**
+ * @file uwb_channel.h
+ * @brief 单路UWB串口接收通道
+ * @details 按块读取串口，在整块数据上运行编译期选定的格式解析器。
+ *          每块读出时记一次 micros()，块中各帧按其后仍在缓冲中的字节数与串口字节时间
+ *          倒推到达时刻，同一批读出的多帧不共用时刻。
+ *          以流类型为模板参数，HardwareSerial 或其它 Stream 均可使用
+ */
+
+#ifndef UWB_CHANNEL_H
+#define UWB_CHANNEL_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "uwb_format.h"
+
+// 单次从串口读取的块大小
+#define UWB_READ_CHUNK 64
+
+/**
+ * @brief 串口传输 bytes 个字节所需时间 (us)，8N1 每字节 10 位
+ */
+static inline unsigned long uwbByteTimeUs(size_t bytes) {
+    return (unsigned long)((float)bytes * (10.0f * 1000000.0f / UWB_BAUD_RATE));
+}
+
+template <typename StreamT, typename FormatT = UwbWireFormat>
+class UwbChannel {
+public:
+    UwbChannel(StreamT& stream, uint8_t id) : _stream(stream) {
+        _format.id = id;
+    }
+
+    /**
+     * @brief 读空串口接收缓冲并解析
+     * @param now 当前时间 (ms)
+     * @param onRange 每解析出一个有效距离调用一次 onRange(const UwbReading&, unsigned long timeUs)，
+     *                timeUs 为该距离最后一个字节的到达时刻 (micros)
+     * @return true 本批次得到了新距离
+     */
+    template <typename Sink>
+    bool poll(unsigned long now, Sink onRange) {
+        bool got = false;
+        size_t chunkLen = 0;
+        unsigned long chunkEndUs = 0;
+        // 帧尾之后块内还有 (chunkLen - end) 个字节，它们在帧尾之后逐个到达
+        auto sink = [&](const UwbReading& r, size_t end) {
+            got = true;
+            onRange(r, chunkEndUs - uwbByteTimeUs(chunkLen - end));
+        };
+        // 空闲刷新的行以最后收到的字节结束
+        auto idleSink = [&](const UwbReading& r, size_t) {
+            got = true;
+            onRange(r, _lastByteUs);
+        };
+        uint8_t chunk[UWB_READ_CHUNK];
+
+        int avail = _stream.available();
+        while (avail > 0) {
+            size_t want = (avail < UWB_READ_CHUNK) ? (size_t)avail : (size_t)UWB_READ_CHUNK;
+            size_t n = _stream.readBytes(chunk, want);
+            if (n == 0) break;
+            // 先取剩余字节数再取时刻: 剩余字节都在该时刻之前到达，块尾又早于它们
+            avail = _stream.available();
+            unsigned long readUs = micros();
+            chunkLen = n;
+            chunkEndUs = readUs - uwbByteTimeUs(avail > 0 ? (size_t)avail : 0);
+            _lastByteUs = chunkEndUs;
+            _format.feed(chunk, n, now, sink);
+        }
+        _format.idle(now, idleSink);
+        return got;
+    }
+
+    StreamT& stream() { return _stream; }
+    FormatT& format() { return _format; }
+
+private:
+    StreamT& _stream;
+    FormatT _format;
+    unsigned long _lastByteUs = 0;   // 最近读出的字节的到达时刻 (micros)
+};
+
+#endif // UWB_CHANNEL_H
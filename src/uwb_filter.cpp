@@ -0,0 +1,45 @@
+/**
+ * @file uwb_filter.cpp
+ * @brief UWB单基站测距预滤波实现
+ */
+
+#include "uwb_filter.h"
+#include <math.h>
+
+void RangeFilter::reset() {
+    _window.clear();
+}
+
+bool RangeFilter::accept(const UwbReading& reading) {
+    // 每个标签各有一组滤波器 (见 uwb_tags.h)，这里无需再按地址区分
+#if UWB_RSSI_MIN > 0
+    if (reading.hasMeta && reading.rssi < UWB_RSSI_MIN) {
+        _stats.lowRssi++;
+        return false;
+    }
+#endif
+
+    float x = reading.distance;
+
+    // 窗口未满时直接接受
+    if (!_window.full()) {
+        _window.push(x);
+        _stats.accepted++;
+        return true;
+    }
+
+    float med = _window.median();
+    float dev[UWB_HAMPEL_WINDOW];
+    for (uint8_t i = 0; i < UWB_HAMPEL_WINDOW; i++) dev[i] = fabsf(_window.at(i) - med);
+    float sigma = 1.4826f * MedianFilter<UWB_HAMPEL_WINDOW>::medianOf(dev, UWB_HAMPEL_WINDOW);
+    if (sigma < UWB_HAMPEL_MIN_SIGMA) sigma = UWB_HAMPEL_MIN_SIGMA;
+
+    // 离群样本也进入窗口，真实的距离阶跃在窗口过半后即被接受
+    _window.push(x);
+    if (fabsf(x - med) > UWB_HAMPEL_K * sigma) {
+        _stats.outliers++;
+        return false;
+    }
+    _stats.accepted++;
+    return true;
+}
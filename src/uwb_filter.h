@@ -0,0 +1,40 @@
+/**
+ * @file uwb_filter.h
+ * @brief UWB单基站测距预滤波 (Hampel + RSSI门限)
+ * @details 定长滑动窗口的中位数/MAD 判定离群点，被拒样本直接丢弃，
+ *          被接受样本原样输出，不引入平滑滞后。每样本固定 O(N) 且 N 为
+ *          编译期常量，内存固定
+ */
+
+#ifndef UWB_FILTER_H
+#define UWB_FILTER_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "uwb_parser.h"
+#include "filters.h"
+
+// 预滤波统计
+struct RangeFilterStats {
+    uint32_t accepted;      // 通过
+    uint32_t outliers;      // Hampel 判为离群
+    uint32_t lowRssi;       // RSSI 低于门限
+};
+
+class RangeFilter {
+public:
+    /**
+     * @brief 判定一次测距是否可用
+     * @return true 接受该样本
+     */
+    bool accept(const UwbReading& reading);
+
+    void reset();
+    const RangeFilterStats& getStats() const { return _stats; }
+
+private:
+    MedianFilter<UWB_HAMPEL_WINDOW> _window;
+    RangeFilterStats _stats = {};
+};
+
+#endif // UWB_FILTER_H
@@ -0,0 +1,320 @@
+/**
+ * @file uwb_format.h
+ * @brief UWB串口格式解析策略
+ * @details 每种输出格式一个策略类，统一接口:
+ *            feed(data, n, now, onRange)  解析一整块字节，每个距离调用 onRange(reading, end)，
+ *                                         end 为该距离最后一个字节之后在 data 中的位置
+ *            idle(now, onRange)           空闲时刷新未结束的行 (end 为 0)
+ *            stats()                      解析统计 (UwbLinkStats)
+ *          由 config.h 中的 UWB_WIRE_FORMAT 在编译期选定 UwbWireFormat，
+ *          热路径只运行一种解析器；UWB_FORMAT_AUTO 在启动时检测一次后锁定
+ */
+
+#ifndef UWB_FORMAT_H
+#define UWB_FORMAT_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "uwb_parser.h"
+
+// 无换行时的行超时 (ms)
+#define UWB_LINE_IDLE_MS 30
+
+static inline bool uwbIsPrintable(uint8_t b) {
+    return b >= 0x20 && b <= 0x7E;
+}
+
+static inline void addFrameErrors(UwbLinkStats& s, const FrameParser& p) {
+    s.resyncs += p.resyncs;
+    s.lengthErrors += p.lengthErrors;
+    s.tailErrors += p.tailErrors;
+}
+
+static inline void addLinkStats(UwbLinkStats& s, const UwbLinkStats& o) {
+    s.frames += o.frames;
+    s.resyncs += o.resyncs;
+    s.lengthErrors += o.lengthErrors;
+    s.tailErrors += o.tailErrors;
+    s.parseFailures += o.parseFailures;
+    s.zeroDistance += o.zeroDistance;
+}
+
+static inline const char* uwbFormatName(int format) {
+    static const char* const names[] = {"binary", "ascii", "hex", "mixed", "auto"};
+    return (format >= 0 && format <= UWB_FORMAT_AUTO) ? names[format] : "unknown";
+}
+
+/**
+ * @brief MK8000 二进制帧
+ */
+class UwbBinaryFormat {
+public:
+    uint8_t id = 0;
+
+    template <typename Sink>
+    void feed(const uint8_t* data, size_t n, unsigned long now, Sink& onRange) {
+        (void)now;
+        for (size_t i = 0; i < n; i++) {
+            uint16_t addr = 0;
+            uint16_t dist = 0;
+            uint8_t rssi = 0;
+            if (!parseFrame(_parser, data[i], addr, dist, rssi)) continue;
+            if (dist == 0) {
+                _zeroDistance++;
+                continue;
+            }
+            _frames++;
+            UwbReading r;
+            r.distance = (float)dist * UWB_DISTANCE_SCALE;
+            r.addr = addr;
+            r.rssi = rssi;
+            r.hasMeta = true;
+            onRange(r, i + 1);
+        }
+    }
+
+    template <typename Sink>
+    void idle(unsigned long, Sink&) {}
+
+    UwbLinkStats stats() const {
+        UwbLinkStats s = {};
+        s.frames = _frames;
+        s.zeroDistance = _zeroDistance;
+        addFrameErrors(s, _parser);
+        return s;
+    }
+
+private:
+    FrameParser _parser;
+    uint32_t _frames = 0;
+    uint32_t _zeroDistance = 0;
+};
+
+/**
+ * @brief 按行输出的文本格式，Parse 为行解析函数
+ */
+template <float (*Parse)(const char*, size_t)>
+class UwbLineFormat {
+public:
+    uint8_t id = 0;
+
+    template <typename Sink>
+    void feed(const uint8_t* data, size_t n, unsigned long now, Sink& onRange) {
+        for (size_t i = 0; i < n; i++) {
+            uint8_t b = data[i];
+            if (b == '\n' || b == '\r') {
+                if (_line.length() > 0) flush("raw", i + 1, onRange);
+            } else if (uwbIsPrintable(b)) {
+                _lastAscii = now;
+                _line.push((char)b);
+                if (_line.full()) flush("raw", i + 1, onRange);
+            } else if (_line.length() > 0) {
+                _line.clear();
+            }
+        }
+    }
+
+    template <typename Sink>
+    void idle(unsigned long now, Sink& onRange) {
+        // Fallback: no newline, flush after short idle
+        if (_line.length() > 0 && (now - _lastAscii) > UWB_LINE_IDLE_MS) {
+            flush("raw(noeol)", 0, onRange);
+        }
+    }
+
+    UwbLinkStats stats() const {
+        UwbLinkStats s = {};
+        s.frames = _frames;
+        s.parseFailures = _parseFailures;
+        return s;
+    }
+
+private:
+    UwbLineBuffer _line;
+    unsigned long _lastAscii = 0;
+    uint32_t _frames = 0;
+    uint32_t _parseFailures = 0;
+
+    template <typename Sink>
+    void flush(const char* tag, size_t end, Sink& onRange) {
+        float d = Parse(_line.c_str(), _line.length());
+        if (d > 0) {
+            _frames++;
+            UwbReading r;
+            r.distance = d;
+            r.addr = 0;
+            r.rssi = 0;
+            r.hasMeta = false;
+            onRange(r, end);
+        } else {
+            _parseFailures++;
+            DEBUG_PRINTF("UWB%u %s: %s\n", id, tag, _line.c_str());
+        }
+        (void)tag;  // 仅用于调试输出
+        _line.clear();
+    }
+};
+
+typedef UwbLineFormat<uwbParseDecimal> UwbAsciiFormat;
+typedef UwbLineFormat<uwbParseHex> UwbHexFormat;
+
+/**
+ * @brief 旧版兼容: 二进制帧状态机与文本行同时运行，文本行先十进制后十六进制
+ */
+class UwbMixedFormat {
+public:
+    uint8_t id = 0;
+
+    template <typename Sink>
+    void feed(const uint8_t* data, size_t n, unsigned long now, Sink& onRange) {
+        _text.id = id;
+        // 文本解析器逐字节输入，位置换算回整块
+        size_t pos = 0;
+        auto text = [&](const UwbReading& r, size_t end) { onRange(r, pos + end); };
+        for (size_t i = 0; i < n; i++) {
+            uint16_t addr = 0;
+            uint16_t dist = 0;
+            uint8_t rssi = 0;
+            if (parseFrame(_parser, data[i], addr, dist, rssi)) {
+                if (dist == 0) {
+                    _zeroDistance++;
+                } else {
+                    _frames++;
+                    UwbReading r;
+                    r.distance = (float)dist * UWB_DISTANCE_SCALE;
+                    r.addr = addr;
+                    r.rssi = rssi;
+                    r.hasMeta = true;
+                    onRange(r, i + 1);
+                }
+                continue;
+            }
+            if (_parser.state != 0) continue;
+            pos = i;
+            _text.feed(data + i, 1, now, text);
+        }
+    }
+
+    template <typename Sink>
+    void idle(unsigned long now, Sink& onRange) {
+        _text.idle(now, onRange);
+    }
+
+    UwbLinkStats stats() const {
+        // 文本行在帧状态机看来也是帧间无效字节，resyncs 包含文本行数
+        UwbLinkStats s = _text.stats();
+        s.frames += _frames;
+        s.zeroDistance += _zeroDistance;
+        addFrameErrors(s, _parser);
+        return s;
+    }
+
+private:
+    FrameParser _parser;
+    UwbLineFormat<uwbParseDistance> _text;
+    uint32_t _frames = 0;
+    uint32_t _zeroDistance = 0;
+};
+
+/**
+ * @brief 启动时自动检测格式，检测完成后只运行锁定的解析器
+ */
+class UwbAutoFormat {
+public:
+    uint8_t id = 0;
+
+    template <typename Sink>
+    void feed(const uint8_t* data, size_t n, unsigned long now, Sink& onRange) {
+        size_t used = 0;
+        if (_locked < 0) {
+            used = probe(data, n);
+            if (_locked < 0) return;
+        }
+        // 每块只分派一次，块内循环在具体解析器中完成；位置换算回整块
+        auto shifted = [&](const UwbReading& r, size_t end) { onRange(r, used + end); };
+        switch (_locked) {
+            case UWB_FORMAT_BINARY: _binary.feed(data + used, n - used, now, shifted); break;
+            case UWB_FORMAT_ASCII:  _ascii.feed(data + used, n - used, now, shifted); break;
+            case UWB_FORMAT_HEX:    _hex.feed(data + used, n - used, now, shifted); break;
+            default: break;
+        }
+    }
+
+    template <typename Sink>
+    void idle(unsigned long now, Sink& onRange) {
+        switch (_locked) {
+            case UWB_FORMAT_ASCII: _ascii.idle(now, onRange); break;
+            case UWB_FORMAT_HEX:   _hex.idle(now, onRange); break;
+            default: break;
+        }
+    }
+
+    /**
+     * @brief 已锁定的格式，未锁定返回 -1
+     */
+    int lockedFormat() const { return _locked; }
+
+    UwbLinkStats stats() const {
+        UwbLinkStats s = _binary.stats();
+        addLinkStats(s, _ascii.stats());
+        addLinkStats(s, _hex.stats());
+        return s;
+    }
+
+private:
+    int _locked = -1;
+    uint8_t _votes[3] = {0, 0, 0};
+    FrameParser _probeFrame;
+    UwbLineBuffer _probeLine;
+    UwbBinaryFormat _binary;
+    UwbAsciiFormat _ascii;
+    UwbHexFormat _hex;
+
+    // 返回已消耗的字节数；锁定后剩余字节交给锁定的解析器
+    size_t probe(const uint8_t* data, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            uint8_t b = data[i];
+            uint16_t addr = 0;
+            uint16_t dist = 0;
+            uint8_t rssi = 0;
+            int vote = -1;
+            if (parseFrame(_probeFrame, b, addr, dist, rssi)) {
+                vote = UWB_FORMAT_BINARY;
+            } else if (_probeFrame.state != 0) {
+                continue;
+            } else if (b == '\n' || b == '\r') {
+                if (_probeLine.length() > 0) {
+                    vote = uwbClassifyLine(_probeLine.c_str(), _probeLine.length());
+                    _probeLine.clear();
+                }
+            } else if (uwbIsPrintable(b)) {
+                _probeLine.push((char)b);
+                if (_probeLine.full()) _probeLine.clear();
+            }
+
+            if (vote < 0) continue;
+            for (int f = 0; f < 3; f++) {
+                _votes[f] = (f == vote) ? (uint8_t)(_votes[f] + 1) : 0;
+            }
+            if (_votes[vote] >= UWB_FORMAT_DETECT_FRAMES) {
+                _locked = vote;
+                _binary.id = _ascii.id = _hex.id = id;
+                DEBUG_PRINTF("UWB%u format locked: %s\n", id, uwbFormatName(vote));
+                return i + 1;
+            }
+        }
+        return n;
+    }
+};
+
+// 编译期选择格式策略
+template <int Format> struct UwbFormatFor;
+template <> struct UwbFormatFor<UWB_FORMAT_BINARY> { typedef UwbBinaryFormat type; };
+template <> struct UwbFormatFor<UWB_FORMAT_ASCII>  { typedef UwbAsciiFormat type; };
+template <> struct UwbFormatFor<UWB_FORMAT_HEX>    { typedef UwbHexFormat type; };
+template <> struct UwbFormatFor<UWB_FORMAT_MIXED>  { typedef UwbMixedFormat type; };
+template <> struct UwbFormatFor<UWB_FORMAT_AUTO>   { typedef UwbAutoFormat type; };
+
+typedef UwbFormatFor<UWB_WIRE_FORMAT>::type UwbWireFormat;
+
+#endif // UWB_FORMAT_H
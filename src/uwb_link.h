@@ -0,0 +1,78 @@
+/**
+ * @file uwb_link.h
+ * @brief UWB单路串口链路健康统计
+ * @details 样本速率 (按固定窗口计算) 与样本间隔直方图 (定宽分格)。
+ *          每个样本只做一次除法和几次加法，可在量产固件中常开
+ */
+
+#ifndef UWB_LINK_H
+#define UWB_LINK_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "uwb_parser.h"
+
+class UwbLinkHealth {
+public:
+    /**
+     * @brief 记录一个样本的到达时刻 (micros)
+     */
+    void onSample(unsigned long timeUs) {
+        if (_count > 0) {
+            unsigned long gap = timeUs - _lastUs;
+            unsigned long bin = gap / (UWB_LINK_HIST_BIN_MS * 1000UL);
+            if (bin >= UWB_LINK_HIST_BINS) bin = UWB_LINK_HIST_BINS - 1;
+            _hist[bin]++;
+            if (gap > _maxGapUs) _maxGapUs = gap;
+        } else {
+            _windowStartUs = timeUs;
+        }
+        _lastUs = timeUs;
+        _count++;
+
+        _windowCount++;
+        unsigned long span = timeUs - _windowStartUs;
+        if (span >= UWB_LINK_RATE_WINDOW_MS * 1000UL) {
+            _rateHz = (float)_windowCount * 1e6f / (float)span;
+            _windowCount = 0;
+            _windowStartUs = timeUs;
+        }
+    }
+
+    /**
+     * @brief 打印速率、解析统计与间隔直方图
+     * @param nowUs 当前时刻，用于判断链路是否已停止
+     */
+    void print(Print& out, uint8_t channel, const UwbLinkStats& link, unsigned long nowUs) const {
+        // 超过两个窗口没有样本时速率按 0 显示，不保留失联前的旧值
+        bool stale = _count == 0 || (nowUs - _lastUs) > 2UL * UWB_LINK_RATE_WINDOW_MS * 1000UL;
+        out.printf("UWB%u link: %.1f frames/s, frames=%lu resync=%lu len_err=%lu tail_err=%lu "
+                   "parse_fail=%lu zero_dist=%lu max_gap=%lums\n",
+                   channel, stale ? 0.0f : _rateHz, (unsigned long)link.frames,
+                   (unsigned long)link.resyncs, (unsigned long)link.lengthErrors,
+                   (unsigned long)link.tailErrors, (unsigned long)link.parseFailures,
+                   (unsigned long)link.zeroDistance, _maxGapUs / 1000UL);
+        out.printf("UWB%u gap(ms):", channel);
+        for (uint8_t i = 0; i < UWB_LINK_HIST_BINS; i++) {
+            if (_hist[i] == 0) continue;
+            if (i == UWB_LINK_HIST_BINS - 1) {
+                out.printf(" >=%u:%lu", (unsigned)(i * UWB_LINK_HIST_BIN_MS), (unsigned long)_hist[i]);
+            } else {
+                out.printf(" %u-%u:%lu", (unsigned)(i * UWB_LINK_HIST_BIN_MS),
+                           (unsigned)((i + 1) * UWB_LINK_HIST_BIN_MS), (unsigned long)_hist[i]);
+            }
+        }
+        out.printf("\n");
+    }
+
+private:
+    uint32_t _hist[UWB_LINK_HIST_BINS] = {0};
+    uint32_t _count = 0;
+    unsigned long _lastUs = 0;
+    unsigned long _maxGapUs = 0;
+    unsigned long _windowStartUs = 0;
+    uint32_t _windowCount = 0;
+    float _rateHz = 0;
+};
+
+#endif // UWB_LINK_H
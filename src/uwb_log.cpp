@@ -0,0 +1,113 @@
+/**
+ * @file uwb_log.cpp
+ * @brief UWB原始串口数据飞行记录实现
+ */
+
+#include "uwb_log.h"
+
+#if UWB_LOG_ENABLED
+
+UwbLog uwbLog;
+
+void UwbLog::put(uint8_t b) {
+    _buf[_head] = b;
+    _head = (_head + 1) % UWB_LOG_BUFFER_SIZE;
+    _used++;
+}
+
+void UwbLog::dropOldest() {
+    size_t size = UWB_LOG_RECORD_HEADER_SIZE + at(5);
+    _tail = (_tail + size) % UWB_LOG_BUFFER_SIZE;
+    _used -= size;
+    _records--;
+    _overwritten++;
+}
+
+void UwbLog::append(uint8_t channel, uint32_t timeUs, const uint8_t* data, size_t len) {
+    // 单条记录长度字段为 1 字节，过长的块拆成多条
+    while (len > UWB_LOG_MAX_CHUNK) {
+        append(channel, timeUs, data, UWB_LOG_MAX_CHUNK);
+        data += UWB_LOG_MAX_CHUNK;
+        len -= UWB_LOG_MAX_CHUNK;
+    }
+    size_t need = UWB_LOG_RECORD_HEADER_SIZE + len;
+    if (need > UWB_LOG_BUFFER_SIZE) return;
+
+    portENTER_CRITICAL(&_mux);
+    if (_paused) {
+        _dropped++;
+        portEXIT_CRITICAL(&_mux);
+        return;
+    }
+    while (UWB_LOG_BUFFER_SIZE - _used < need) {
+        dropOldest();
+    }
+    put((uint8_t)timeUs);
+    put((uint8_t)(timeUs >> 8));
+    put((uint8_t)(timeUs >> 16));
+    put((uint8_t)(timeUs >> 24));
+    put(channel);
+    put((uint8_t)len);
+    for (size_t i = 0; i < len; i++) {
+        put(data[i]);
+    }
+    _records++;
+    portEXIT_CRITICAL(&_mux);
+}
+
+void UwbLog::dump(Print& out) {
+    // 导出耗时较长 (串口每 KB 约 0.2 s)，期间暂停记录，保证快照一致
+    portENTER_CRITICAL(&_mux);
+    _paused = true;
+    size_t used = _used;
+    portEXIT_CRITICAL(&_mux);
+
+    const uint8_t header[UWB_LOG_FILE_HEADER_SIZE] = {
+        'U', 'W', 'B', 'L', UWB_LOG_VERSION, UWB_ANCHOR_COUNT, 0, 0};
+    out.printf("UWBLOG BEGIN %u\n", (unsigned)(UWB_LOG_FILE_HEADER_SIZE + used));
+
+    char line[2 * 32 + 1];
+    size_t n = 0;
+    for (size_t i = 0; i < UWB_LOG_FILE_HEADER_SIZE + used; i++) {
+        uint8_t b = (i < UWB_LOG_FILE_HEADER_SIZE) ? header[i] : at(i - UWB_LOG_FILE_HEADER_SIZE);
+        static const char hex[] = "0123456789abcdef";
+        line[n++] = hex[b >> 4];
+        line[n++] = hex[b & 0x0F];
+        if (n == sizeof(line) - 1) {
+            line[n] = '\0';
+            out.printf("UWBLOG %s\n", line);
+            n = 0;
+        }
+    }
+    if (n > 0) {
+        line[n] = '\0';
+        out.printf("UWBLOG %s\n", line);
+    }
+    out.println("UWBLOG END");
+
+    portENTER_CRITICAL(&_mux);
+    _paused = false;
+    portEXIT_CRITICAL(&_mux);
+}
+
+void UwbLog::clear() {
+    portENTER_CRITICAL(&_mux);
+    _head = 0;
+    _tail = 0;
+    _used = 0;
+    _records = 0;
+    portEXIT_CRITICAL(&_mux);
+}
+
+UwbLogStats UwbLog::getStats() {
+    UwbLogStats st;
+    portENTER_CRITICAL(&_mux);
+    st.records = _records;
+    st.bytes = (uint32_t)_used;
+    st.overwritten = _overwritten;
+    st.dropped = _dropped;
+    portEXIT_CRITICAL(&_mux);
+    return st;
+}
+
+#endif // UWB_LOG_ENABLED
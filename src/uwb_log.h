@@ -0,0 +1,97 @@
+/**
+ * @file uwb_log.h
+ * @brief UWB原始串口数据飞行记录
+ * @details 每次从串口读出的原始字节连同 micros 时间戳和通道号写入 RAM 环形缓冲，
+ *          满后覆盖最旧记录。现场出现异常时用 G 命令导出，主机端
+ *          tools/uwb_replay.cpp 可将其回放到真实的解析/定位/跟随代码中。
+ *
+ *          导出格式 (小端):
+ *            文件头  "UWBL" version(1) anchors(1) reserved(2)
+ *            记录    timeUs(4) channel(1) len(1) data(len)
+ *          串口/蓝牙导出时按行十六进制编码:
+ *            UWBLOG BEGIN <字节数>
+ *            UWBLOG <十六进制>
+ *            UWBLOG END
+ */
+
+#ifndef UWB_LOG_H
+#define UWB_LOG_H
+
+#include <Arduino.h>
+#include "config.h"
+
+#define UWB_LOG_MAGIC "UWBL"
+#define UWB_LOG_VERSION 1
+#define UWB_LOG_FILE_HEADER_SIZE 8
+#define UWB_LOG_RECORD_HEADER_SIZE 6
+#define UWB_LOG_MAX_CHUNK 255
+
+#if UWB_LOG_ENABLED
+
+#include <freertos/FreeRTOS.h>
+
+// 记录统计
+struct UwbLogStats {
+    uint32_t records;       // 当前缓冲内记录数
+    uint32_t bytes;         // 当前缓冲内字节数
+    uint32_t overwritten;   // 被覆盖的旧记录数
+    uint32_t dropped;       // 导出期间丢弃的记录数
+};
+
+class UwbLog {
+public:
+    /**
+     * @brief 追加一块原始串口数据 (可在接收任务中调用)
+     */
+    void append(uint8_t channel, uint32_t timeUs, const uint8_t* data, size_t len);
+
+    /**
+     * @brief 按十六进制行导出全部记录，导出期间暂停记录
+     */
+    void dump(Print& out);
+
+    void clear();
+    UwbLogStats getStats();
+
+private:
+    uint8_t _buf[UWB_LOG_BUFFER_SIZE];
+    size_t _head = 0;       // 下一个写入位置
+    size_t _tail = 0;       // 最旧记录起点
+    size_t _used = 0;
+    uint32_t _records = 0;
+    uint32_t _overwritten = 0;
+    uint32_t _dropped = 0;
+    bool _paused = false;
+    portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+
+    void put(uint8_t b);
+    uint8_t at(size_t offset) const { return _buf[(_tail + offset) % UWB_LOG_BUFFER_SIZE]; }
+    void dropOldest();
+};
+
+extern UwbLog uwbLog;
+
+/**
+ * @brief 流适配器: 透传读取，并把读到的字节写入飞行记录
+ */
+template <typename StreamT>
+class UwbLogTap {
+public:
+    UwbLogTap(StreamT& stream, uint8_t channel) : _stream(stream), _channel(channel) {}
+
+    int available() { return _stream.available(); }
+
+    size_t readBytes(uint8_t* buffer, size_t length) {
+        size_t n = _stream.readBytes(buffer, length);
+        if (n > 0) uwbLog.append(_channel, (uint32_t)micros(), buffer, n);
+        return n;
+    }
+
+private:
+    StreamT& _stream;
+    uint8_t _channel;
+};
+
+#endif // UWB_LOG_ENABLED
+
+#endif // UWB_LOG_H
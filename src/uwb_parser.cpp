@@ -0,0 +1,234 @@
+/**
+ * @file uwb_parser.cpp
+ * @brief UWB串口数据解析实现 (无堆分配)
+ */
+
+#include "uwb_parser.h"
+
+static int hexDigitValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static char toLowerAscii(char c) {
+    return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+}
+
+static bool isSpaceAscii(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// 将 [begin, end) 内的 "[+-]digits[.digits]" 转为数值，等价于 toFloat()
+static float scanDecimal(const char* s, int begin, int end) {
+    int i = begin;
+    bool negative = false;
+    if (s[i] == '-' || s[i] == '+') {
+        negative = (s[i] == '-');
+        i++;
+    }
+
+    float value = 0;
+    float frac = 0;
+    float fracScale = 1.0f;
+    bool inFrac = false;
+    for (; i < end; i++) {
+        char c = s[i];
+        if (c == '.') {
+            if (inFrac) break;  // 第二个小数点之后忽略
+            inFrac = true;
+        } else if (inFrac) {
+            frac = frac * 10.0f + (float)(c - '0');
+            fracScale *= 10.0f;
+        } else {
+            value = value * 10.0f + (float)(c - '0');
+        }
+    }
+
+    value += frac / fracScale;
+    return negative ? -value : value;
+}
+
+bool parseFrame(FrameParser& p, uint8_t b, uint16_t& addr, uint16_t& dist, uint8_t& rssi) {
+    switch (p.state) {
+        case 0:
+            if (b == 0xF0) {
+                p.state = 1;
+                p.inGap = false;
+            } else if (!p.inGap) {
+                p.inGap = true;
+                p.resyncs++;
+            }
+            break;
+        case 1:
+            p.len = b;
+            if (p.len == 0x05) {
+                p.index = 0;
+                p.state = 2;
+            } else {
+                p.lengthErrors++;
+                p.state = 0;
+            }
+            break;
+        case 2:
+            p.payload[p.index++] = b;
+            if (p.index >= p.len) {
+                p.state = 3;
+            }
+            break;
+        case 3:
+            if (b == 0xAA) {
+                addr = (uint16_t)p.payload[0] | ((uint16_t)p.payload[1] << 8);
+                dist = (uint16_t)p.payload[2] | ((uint16_t)p.payload[3] << 8);
+                rssi = p.payload[4];
+                p.state = 0;
+                return true;
+            }
+            p.tailErrors++;
+            p.state = 0;
+            break;
+        default:
+            p.state = 0;
+            break;
+    }
+    return false;
+}
+
+// 去除首尾空白，返回 [start, end)
+static bool trimLine(const char* line, size_t length, int& start, int& end) {
+    start = 0;
+    end = (int)length;
+    while (start < end && isSpaceAscii(line[start])) start++;
+    while (end > start && isSpaceAscii(line[end - 1])) end--;
+    return start < end;
+}
+
+float uwbParseDecimal(const char* line, size_t length) {
+    // 只在原缓冲区上移动下标，不做拷贝
+    int start = 0;
+    int len = 0;
+    if (!trimLine(line, length, start, len)) return 0;
+
+    // Extract the last numeric token and convert to cm
+    float value = 0;
+    bool found = false;
+    int lastEnd = -1;
+
+    for (int i = start; i < len; i++) {
+        char c = line[i];
+        if ((c >= '0' && c <= '9') || c == '.' || c == '-' || c == '+') {
+            int j = i;
+            bool hasDigit = false;
+            if (line[j] == '-' || line[j] == '+') j++;
+            while (j < len) {
+                char cj = line[j];
+                if (cj >= '0' && cj <= '9') {
+                    hasDigit = true;
+                    j++;
+                } else if (cj == '.') {
+                    j++;
+                } else {
+                    break;
+                }
+            }
+            if (hasDigit) {
+                value = scanDecimal(line, i, j);
+                found = true;
+                lastEnd = j;
+            }
+            i = j - 1;
+        }
+    }
+
+    if (!found || value <= 0) return 0;
+
+    int k = lastEnd;
+    while (k < len && isSpaceAscii(line[k])) k++;
+    if (k < len) {
+        char c0 = toLowerAscii(line[k]);
+        char c1 = (k + 1 < len) ? toLowerAscii(line[k + 1]) : '\0';
+        if (c0 == 'm' && c1 == 'm') {
+            return value * 0.1f;    // mm -> cm
+        } else if (c0 == 'c' && c1 == 'm') {
+            return value;           // cm
+        } else if (c0 == 'm') {
+            return value * 100.0f;  // m -> cm
+        }
+    }
+    return value * UWB_DISTANCE_SCALE;
+}
+
+float uwbParseHex(const char* line, size_t length) {
+    int start = 0;
+    int len = 0;
+    if (!trimLine(line, length, start, len)) return 0;
+
+    // Find last hex token (e.g., "0f 00000a3c")
+    unsigned long hexValue = 0;
+    bool hexFound = false;
+    for (int i = start; i < len; i++) {
+        int j = i;
+        if (line[j] == '0' && (j + 1 < len)) {
+            char nx = line[j + 1];
+            if (nx == 'x' || nx == 'X') {
+                j += 2;
+            }
+        }
+
+        unsigned long v = 0;
+        bool hasHex = false;
+        while (j < len) {
+            int hv = hexDigitValue(line[j]);
+            if (hv >= 0) {
+                v = (v << 4) + (unsigned long)hv;
+                hasHex = true;
+                j++;
+            } else {
+                break;
+            }
+        }
+
+        if (hasHex) {
+            hexValue = v;
+            hexFound = true;
+            i = j - 1;
+        }
+    }
+
+    if (!hexFound || hexValue == 0) return 0;
+    return (float)hexValue * UWB_HEX_SCALE;
+}
+
+float uwbParseDistance(const char* line, size_t length) {
+    // 支持的格式: "d: 120cm" / "DIST: 1.23m" / 纯数字 / "mc 0f 00000a3c" (AT十六进制)
+    float d = uwbParseDecimal(line, length);
+    if (d > 0) return d;
+    return uwbParseHex(line, length);
+}
+
+int uwbClassifyLine(const char* line, size_t length) {
+    int start = 0;
+    int len = 0;
+    if (!trimLine(line, length, start, len)) return -1;
+
+    // 取最后一个空白分隔的字段
+    int tokenStart = len;
+    while (tokenStart > start && !isSpaceAscii(line[tokenStart - 1])) tokenStart--;
+    int tokenLen = len - tokenStart;
+
+    // AT 十六进制输出为 0x 前缀或定宽 (>=6 位) 的十六进制字段
+    bool allHex = tokenLen > 0;
+    for (int i = tokenStart; i < len; i++) {
+        if (hexDigitValue(line[i]) < 0) {
+            allHex = false;
+            break;
+        }
+    }
+    bool prefixed = tokenLen > 2 && line[tokenStart] == '0' &&
+                    (line[tokenStart + 1] == 'x' || line[tokenStart + 1] == 'X');
+    if ((allHex && tokenLen >= 6) || prefixed) {
+        return (uwbParseHex(line, length) > 0) ? UWB_FORMAT_HEX : -1;
+    }
+    return (uwbParseDecimal(line, length) > 0) ? UWB_FORMAT_ASCII : -1;
+}
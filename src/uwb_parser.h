@@ -0,0 +1,104 @@
+/**
+ * @file uwb_parser.h
+ * @brief UWB串口数据解析 (无堆分配)
+ * @details 二进制帧状态机、定长行缓冲与距离数值扫描，
+ *          不依赖 String，稳态运行时不产生任何堆分配
+ */
+
+#ifndef UWB_PARSER_H
+#define UWB_PARSER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+
+// 单行最大字符数，超出后强制解析并清空
+#define UWB_LINE_CAPACITY 200
+
+// 一次测距结果
+struct UwbReading {
+    float distance;     // 距离 (cm)
+    uint16_t addr;      // 测距对端地址 (仅二进制帧)
+    uint8_t rssi;       // 信号强度 (仅二进制帧)
+    bool hasMeta;       // addr/rssi 是否有效 (ASCII 格式无此信息)
+};
+
+// MK8000 二进制帧: F0 05 addr(2) dist(2) rssi(1) AA
+struct FrameParser {
+    uint8_t state = 0;  // 0=wait header, 1=len, 2=payload, 3=tail
+    uint8_t len = 0;
+    uint8_t index = 0;
+    uint8_t payload[8] = {0};
+
+    // 链路错误计数
+    bool inGap = false;         // 正在跳过帧间的无效字节
+    uint32_t resyncs = 0;       // 帧头重新同步次数 (每段连续无效字节计一次)
+    uint32_t lengthErrors = 0;  // 长度字节错误
+    uint32_t tailErrors = 0;    // 帧尾不是 0xAA
+};
+
+// 单路串口的解析统计
+struct UwbLinkStats {
+    uint32_t frames;        // 有效帧/行
+    uint32_t resyncs;       // 帧头重新同步
+    uint32_t lengthErrors;  // 帧长度错误
+    uint32_t tailErrors;    // 帧尾错误
+    uint32_t parseFailures; // 文本行解析失败
+    uint32_t zeroDistance;  // 距离为 0 的帧被丢弃
+};
+
+/**
+ * @brief 向帧状态机输入一个字节
+ * @return true 收到完整帧，addr/dist/rssi 有效
+ */
+bool parseFrame(FrameParser& p, uint8_t b, uint16_t& addr, uint16_t& dist, uint8_t& rssi);
+
+/**
+ * @brief ASCII 行缓冲（定长，仅接收可打印字符）
+ */
+class UwbLineBuffer {
+public:
+    void push(char c) {
+        if (_len < UWB_LINE_CAPACITY) {
+            _buf[_len++] = c;
+        }
+        _buf[_len] = '\0';
+    }
+    void clear() {
+        _len = 0;
+        _buf[0] = '\0';
+    }
+    bool full() const { return _len >= UWB_LINE_CAPACITY; }
+    size_t length() const { return _len; }
+    const char* c_str() const { return _buf; }
+
+private:
+    char _buf[UWB_LINE_CAPACITY + 1] = {0};
+    size_t _len = 0;
+};
+
+/**
+ * @brief ASCII 十进制格式: 取最后一个十进制数字并识别 mm/cm/m 单位
+ * @return 距离 (cm)，解析失败返回 0
+ */
+float uwbParseDecimal(const char* line, size_t len);
+
+/**
+ * @brief AT 十六进制格式: 取最后一个十六进制字段 (如 "mc 0f 00000a3c")
+ * @return 距离 (cm)，解析失败返回 0
+ */
+float uwbParseHex(const char* line, size_t len);
+
+/**
+ * @brief 兼容解析: 先按十进制，失败再回退十六进制
+ * @return 距离 (cm)，解析失败返回 0
+ */
+float uwbParseDistance(const char* line, size_t len);
+
+/**
+ * @brief 判断一行属于哪种文本格式，用于启动时自动检测
+ * @return UWB_FORMAT_ASCII / UWB_FORMAT_HEX，无法判断返回 -1
+ */
+int uwbClassifyLine(const char* line, size_t len);
+
+#endif // UWB_PARSER_H
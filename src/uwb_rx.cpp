@@ -0,0 +1,146 @@
+/**
+ * @file uwb_rx.cpp
+ * @brief UWB后台接收任务实现
+ * 每路串口一个任务，阻塞在UART驱动事件队列上；
+ * 帧尾 0xAA 模式检测中断保证二进制帧一到即被处理
+ */
+
+#include "uwb_rx.h"
+
+#if UWB_RX_TASK_ENABLED
+
+#include <freertos/task.h>
+#include "uwb_channel.h"
+#include "uwb_log.h"
+
+namespace {
+// 按基站编号排列，见 config.h UWB_ANCHOR_PORTS
+#define UWB_PORT_UART(id, serial, uart, rx, tx) uart,
+#define UWB_PORT_RX(id, serial, uart, rx, tx) rx,
+#define UWB_PORT_TX(id, serial, uart, rx, tx) tx,
+const uart_port_t kPorts[] = {UWB_ANCHOR_PORTS(UWB_PORT_UART)};
+const int kRxPins[] = {UWB_ANCHOR_PORTS(UWB_PORT_RX)};
+const int kTxPins[] = {UWB_ANCHOR_PORTS(UWB_PORT_TX)};
+#undef UWB_PORT_UART
+#undef UWB_PORT_RX
+#undef UWB_PORT_TX
+static_assert(sizeof(kPorts) / sizeof(kPorts[0]) == UWB_ANCHOR_COUNT, "每个基站需要分配一路 UART");
+
+struct TaskContext {
+    UwbRx* rx;
+    uint8_t anchor;
+};
+TaskContext g_taskContext[UWB_ANCHOR_COUNT];
+}  // namespace
+
+bool UwbRx::begin() {
+    _samples = xQueueCreate(UWB_SAMPLE_QUEUE_LEN, sizeof(UwbRangeSample));
+    if (_samples == nullptr) {
+        DEBUG_PRINTLN("UWB样本队列创建失败");
+        return false;
+    }
+
+    uart_config_t cfg = {};
+    cfg.baud_rate = UWB_BAUD_RATE;
+    cfg.data_bits = UART_DATA_8_BITS;
+    cfg.parity = UART_PARITY_DISABLE;
+    cfg.stop_bits = UART_STOP_BITS_1;
+    cfg.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
+
+    for (uint8_t i = 0; i < UWB_ANCHOR_COUNT; i++) {
+        uart_port_t port = kPorts[i];
+        if (uart_driver_install(port, UWB_RX_BUFFER_SIZE, 0, UWB_RX_EVENT_QUEUE_LEN, &_events[i], 0) != ESP_OK) {
+            DEBUG_PRINTF("UWB%u UART驱动安装失败\n", i);
+            return false;
+        }
+        uart_param_config(port, &cfg);
+        uart_set_pin(port, kTxPins[i], kRxPins[i], UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+        uart_set_rx_timeout(port, UWB_RX_TIMEOUT_SYMBOLS);
+
+        // 帧尾字节触发模式检测事件，不必等接收超时
+        uart_enable_pattern_det_baud_intr(port, UWB_FRAME_TAIL, 1, 9, 0, 0);
+        uart_pattern_queue_reset(port, UWB_RX_EVENT_QUEUE_LEN);
+
+        g_taskContext[i].rx = this;
+        g_taskContext[i].anchor = i;
+        char name[12];
+        snprintf(name, sizeof(name), "uwb_rx%u", i);
+        xTaskCreatePinnedToCore(taskEntry, name, UWB_RX_TASK_STACK,
+                                &g_taskContext[i], UWB_RX_TASK_PRIORITY, nullptr, UWB_RX_TASK_CORE);
+    }
+    return true;
+}
+
+bool UwbRx::receive(UwbRangeSample& sample) {
+    return _samples != nullptr && xQueueReceive(_samples, &sample, 0) == pdTRUE;
+}
+
+void UwbRx::taskEntry(void* arg) {
+    TaskContext* ctx = static_cast<TaskContext*>(arg);
+    ctx->rx->run(ctx->anchor);
+}
+
+void UwbRx::run(uint8_t anchor) {
+    uart_port_t port = kPorts[anchor];
+    QueueHandle_t events = _events[anchor];
+    UwbRxStats& stats = _stats[anchor];
+    UwbLinkHealth& health = _health[anchor];
+    UartDriverStream stream(port);
+#if UWB_LOG_ENABLED
+    UwbLogTap<UartDriverStream> tap(stream, anchor);
+    UwbChannel<UwbLogTap<UartDriverStream>> channel(tap, anchor);
+#else
+    UwbChannel<UartDriverStream> channel(stream, anchor);
+#endif
+    uart_event_t event;
+
+    for (;;) {
+        // 超时唤醒用于无换行ASCII行的空闲刷新
+        bool gotEvent = xQueueReceive(events, &event, pdMS_TO_TICKS(UWB_LINE_IDLE_MS)) == pdTRUE;
+
+        if (gotEvent) {
+            switch (event.type) {
+                case UART_FIFO_OVF:
+                    stats.rxOverflow++;
+                    uart_flush_input(port);
+                    xQueueReset(events);
+                    continue;
+                case UART_BUFFER_FULL:
+                    stats.bufferFull++;
+                    uart_flush_input(port);
+                    xQueueReset(events);
+                    continue;
+                case UART_FRAME_ERR:
+                    stats.frameErrors++;
+                    break;
+                case UART_PARITY_ERR:
+                    stats.parityErrors++;
+                    break;
+                case UART_PATTERN_DET:
+                    // 数据统一由 poll 读取，这里只清空模式位置队列
+                    while (uart_pattern_pop_pos(port) >= 0) {
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        // 一次事件可能读出多帧，时刻由通道按帧在读出块中的位置倒推，不共用事件时刻
+        channel.poll(millis(), [&](const UwbReading& reading, unsigned long timeUs) {
+            UwbRangeSample sample;
+            sample.anchor = anchor;
+            sample.reading = reading;
+            sample.timeUs = timeUs;
+            health.onSample(sample.timeUs);
+            if (xQueueSend(_samples, &sample, 0) == pdTRUE) {
+                stats.samples++;
+            } else {
+                stats.queueDrops++;
+            }
+        });
+        stats.link = channel.format().stats();
+    }
+}
+
+#endif // UWB_RX_TASK_ENABLED
@@ -0,0 +1,100 @@
+/**
+ * @file uwb_rx.h
+ * @brief UWB后台接收任务
+ * @details 使用 ESP-IDF UART 驱动事件队列，在独立 FreeRTOS 任务中
+ *          读取并解析每个基站的UWB串口，将带时间戳的距离样本送入队列。
+ *          loop() 阻塞（如 showMessage 的 delay）期间不会丢失测距数据
+ */
+
+#ifndef UWB_RX_H
+#define UWB_RX_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "uwb_parser.h"
+#include "uwb_link.h"
+
+// 单个距离样本
+struct UwbRangeSample {
+    uint8_t anchor;         // 基站编号 (0..UWB_ANCHOR_COUNT-1)
+    UwbReading reading;     // 距离及 addr/rssi
+    unsigned long timeUs;   // 帧最后一个字节的到达时刻 (micros)
+};
+
+// 每路串口的接收统计
+struct UwbRxStats {
+    uint32_t samples;       // 已发布样本数
+    uint32_t rxOverflow;    // 硬件FIFO溢出次数
+    uint32_t bufferFull;    // 驱动环形缓冲满次数
+    uint32_t frameErrors;   // 帧错误 (停止位错误)
+    uint32_t parityErrors;  // 校验错误
+    uint32_t queueDrops;    // 样本队列满丢弃数
+    UwbLinkStats link;      // 解析统计 (有效帧/重同步/长度与帧尾错误等)
+};
+
+#if UWB_RX_TASK_ENABLED
+
+#include <driver/uart.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+
+/**
+ * @brief UART驱动接收缓冲的流适配器，供 UwbChannel 使用
+ */
+class UartDriverStream {
+public:
+    explicit UartDriverStream(uart_port_t port) : _port(port) {}
+
+    int available() {
+        size_t n = 0;
+        uart_get_buffered_data_len(_port, &n);
+        return (int)n;
+    }
+
+    size_t readBytes(uint8_t* buffer, size_t length) {
+        int n = uart_read_bytes(_port, buffer, length, 0);
+        return (n > 0) ? (size_t)n : 0;
+    }
+
+    uart_port_t port() const { return _port; }
+
+private:
+    uart_port_t _port;
+};
+
+class UwbRx {
+public:
+    /**
+     * @brief 安装UART驱动并启动接收任务
+     */
+    bool begin();
+
+    /**
+     * @brief 取出一个距离样本（非阻塞）
+     * @return true 取到样本
+     */
+    bool receive(UwbRangeSample& sample);
+
+    /**
+     * @brief 获取指定基站串口的接收统计
+     */
+    UwbRxStats getStats(uint8_t anchor) const { return _stats[anchor]; }
+
+    /**
+     * @brief 获取指定基站串口的样本速率与间隔直方图
+     */
+    const UwbLinkHealth& getHealth(uint8_t anchor) const { return _health[anchor]; }
+
+private:
+    QueueHandle_t _samples = nullptr;
+    QueueHandle_t _events[UWB_ANCHOR_COUNT] = {nullptr};
+    UwbRxStats _stats[UWB_ANCHOR_COUNT] = {};
+    UwbLinkHealth _health[UWB_ANCHOR_COUNT];
+
+    static void taskEntry(void* arg);
+    void run(uint8_t anchor);
+};
+
+#endif // UWB_RX_TASK_ENABLED
+
+#endif // UWB_RX_H
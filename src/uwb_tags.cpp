@@ -0,0 +1,75 @@
+/**
+ * @file uwb_tags.cpp
+ * @brief UWB多标签表实现
+ */
+
+#include "uwb_tags.h"
+
+static_assert((UWB_TAG_CAPACITY & (UWB_TAG_CAPACITY - 1)) == 0, "UWB_TAG_CAPACITY 须为 2 的幂");
+static_assert(UWB_TAG_MAX >= 1, "UWB_TAG_CAPACITY 过小");
+
+uint8_t UwbTagTable::home(uint16_t addr) {
+    // 乘法散列，连续地址 (0001/0002/...) 也能均匀分布
+    return (uint8_t)(((uint32_t)addr * 2654435761u) >> 24) & (UWB_TAG_CAPACITY - 1);
+}
+
+int UwbTagTable::indexOf(uint16_t addr) const {
+    // 探测链遇到空槽即结束，装载率 <= 3/4 时平均只比较 1~2 次
+    uint8_t i = home(addr);
+    for (uint8_t n = 0; n < UWB_TAG_CAPACITY; n++) {
+        const UwbTag& t = _slots[i];
+        if (!t.used) return -1;
+        if (t.addr == addr) return i;
+        i = (uint8_t)((i + 1) & (UWB_TAG_CAPACITY - 1));
+    }
+    return -1;
+}
+
+UwbTag* UwbTagTable::acquire(uint16_t addr, uint16_t keepAddr) {
+    UwbTag* t = find(addr);
+    if (t != nullptr) return t;
+
+    if (_size >= UWB_TAG_MAX) {
+        // 淘汰最久未出现的标签，仅在新标签出现时扫描一次整表
+        int oldest = -1;
+        for (uint8_t i = 0; i < UWB_TAG_CAPACITY; i++) {
+            const UwbTag& s = _slots[i];
+            if (!s.used || s.addr == keepAddr) continue;
+            if (oldest < 0 || (long)(s.lastSeenUs - _slots[oldest].lastSeenUs) < 0) {
+                oldest = i;
+            }
+        }
+        if (oldest < 0) return nullptr;
+        remove((uint8_t)oldest);
+        _evictions++;
+    }
+
+    uint8_t i = home(addr);
+    while (_slots[i].used) {
+        i = (uint8_t)((i + 1) & (UWB_TAG_CAPACITY - 1));
+    }
+    _slots[i] = UwbTag();
+    _slots[i].addr = addr;
+    _slots[i].used = true;
+    _size++;
+    return &_slots[i];
+}
+
+void UwbTagTable::remove(uint8_t index) {
+    // 线性探测的后移删除: 把后续探测链上的元素前移填补空位，不留墓碑
+    _slots[index].used = false;
+    _size--;
+    uint8_t hole = index;
+    uint8_t i = (uint8_t)((index + 1) & (UWB_TAG_CAPACITY - 1));
+    while (_slots[i].used) {
+        uint8_t h = home(_slots[i].addr);
+        // h 不在 (hole, i] 循环区间内时，该元素可以前移到 hole
+        bool between = (hole <= i) ? (h > hole && h <= i) : (h > hole || h <= i);
+        if (!between) {
+            _slots[hole] = _slots[i];
+            _slots[i].used = false;
+            hole = i;
+        }
+        i = (uint8_t)((i + 1) & (UWB_TAG_CAPACITY - 1));
+    }
+}
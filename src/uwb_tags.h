@@ -0,0 +1,96 @@
+/**
+ * @file uwb_tags.h
+ * @brief UWB多标签表 (按地址开放寻址，无堆分配)
+ * @details 每个标签独立保存各基站测距、时间戳、预滤波窗口与解算位置，
+ *          多名学生同时佩戴标签时互不干扰。线性探测散列，查找平均 O(1)；
+ *          表满时淘汰最久未出现的标签 (跟随目标除外)
+ */
+
+#ifndef UWB_TAGS_H
+#define UWB_TAGS_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "uwb_filter.h"
+#include "filters.h"
+
+// 无地址信息的测距 (ASCII/十六进制格式) 归入该地址
+#define UWB_ADDR_UNKNOWN 0xFFFF
+
+// 同时保存的标签上限，保持装载率 <= 3/4 以缩短探测链
+#define UWB_TAG_MAX (UWB_TAG_CAPACITY * 3 / 4)
+
+// 单个基站最近两次测距，用于时间对齐
+struct AnchorTrack {
+    float distance = 0;                     // 平滑后的距离，用于几何解算 (UWB_RANGE_SMOOTH_ENABLED=0 时为原始距离)
+    float raw = 0;                          // 预滤波后、未平滑的距离，用于发布与测距变化率
+    unsigned long timeUs = 0;
+    float prevDistance = 0;
+    unsigned long prevTimeUs = 0;
+    uint8_t count = 0;
+#if UWB_RANGE_SMOOTH_ENABLED
+    OneEuroFilter smooth{UWB_RANGE_MIN_CUTOFF_HZ, UWB_RANGE_BETA, UWB_RANGE_D_CUTOFF_HZ};
+#endif
+};
+
+// 单个标签的全部状态
+struct UwbTag {
+    uint16_t addr = 0;
+    bool used = false;
+    unsigned long lastSeenUs = 0;           // 最近一次测距到达时刻 (micros)
+    AnchorTrack anchors[UWB_ANCHOR_COUNT];
+    RangeFilter filters[UWB_ANCHOR_COUNT];
+
+    // 本批次最新的一组时间对齐距离
+    float pairRanges[UWB_ANCHOR_COUNT] = {0};
+    unsigned long pairUs = 0;
+    bool pairReady = false;
+
+    // 最近一次解算结果
+    bool hasFix = false;
+    float x = 0;
+    float y = 0;
+    float residual = 0;
+    unsigned long fixUs = 0;
+    bool newFix = false;                    // 本批次刚解算出新位置
+};
+
+class UwbTagTable {
+public:
+    /**
+     * @brief 按地址查找，不存在返回 nullptr
+     */
+    UwbTag* find(uint16_t addr) {
+        int i = indexOf(addr);
+        return (i >= 0) ? &_slots[i] : nullptr;
+    }
+    const UwbTag* find(uint16_t addr) const {
+        int i = indexOf(addr);
+        return (i >= 0) ? &_slots[i] : nullptr;
+    }
+
+    /**
+     * @brief 查找或新建标签
+     * @param keepAddr 表满需要淘汰时保留的地址 (当前跟随目标)
+     */
+    UwbTag* acquire(uint16_t addr, uint16_t keepAddr);
+
+    /**
+     * @brief 按槽位遍历，空槽返回 nullptr
+     */
+    UwbTag* slot(uint8_t index) { return _slots[index].used ? &_slots[index] : nullptr; }
+
+    uint8_t size() const { return _size; }
+    uint32_t evictions() const { return _evictions; }
+
+private:
+    UwbTag _slots[UWB_TAG_CAPACITY];
+    uint8_t _size = 0;
+    uint32_t _evictions = 0;
+
+    static uint8_t home(uint16_t addr);
+    int indexOf(uint16_t addr) const;
+    void remove(uint8_t index);
+};
+
+#endif // UWB_TAGS_H
@@ -39,6 +39,8 @@ void Weight::begin() {
 void Weight::tare() {
     if (_available && _hx711.is_ready()) {
         _hx711.tare(5);
+        // 零点变了，旧读数不再参与平滑
+        _filter.reset();
         DEBUG_PRINTLN("称重去皮完成");
     }
 }
@@ -61,6 +63,7 @@ void Weight::calibrate(float knownWeight) {
         float newFactor = rawValue / knownWeight;
         _calibrationFactor = newFactor;
         _hx711.set_scale(_calibrationFactor);
+        _filter.reset();
         DEBUG_PRINTF("新校准系数: %.2f\n", _calibrationFactor);
     }
 }
@@ -75,14 +78,14 @@ float Weight::readWeight() {
     if (_hx711.is_ready()) {
         // 只读取1个样本，避免阻塞
         float reading = _hx711.get_units(1);
+        unsigned long now = millis();
         
-        // 低通滤波
-        _currentWeight = _currentWeight * 0.8f + reading * 0.2f;
+        // 低通滤波，按实际读数间隔
+        float filtered = _filter.update(reading, (now - _lastReadMs) * 1e-3f);
+        _lastReadMs = now;
         
-        // 限制负值
-        if (_currentWeight < 0) {
-            _currentWeight = 0;
-        }
+        // 限制负值 (只限制输出，滤波状态不截断)
+        _currentWeight = (filtered < 0) ? 0 : filtered;
     }
     
     return _currentWeight;
@@ -9,6 +9,7 @@
 #include <Arduino.h>
 #include <HX711.h>
 #include "config.h"
+#include "filters.h"
 
 class Weight {
 public:
@@ -71,6 +72,8 @@ private:
     float _calibrationFactor = WEIGHT_CALIBRATION_FACTOR;
     float _currentWeight = 0;
     bool _available = false;
+    EmaFilter _filter{WEIGHT_FILTER_TAU_MS * 1e-3f, WEIGHT_READ_INTERVAL_MS * 1e-3f};
+    unsigned long _lastReadMs = 0;
 };
 
 // 全局称重对象
@@ -0,0 +1,99 @@
+/**
+ * @file fast_math_bench.cpp
+ * @brief 快速数学函数误差与耗时 (主机端)
+ * @details 1) 在全定义域扫描 fastAtan2 / fastRsqrt / fastSqrt，与 double 精度
+ *             libm 对比，报告最大误差并检查 fast_math.h 中声明的误差上界
+ *          2) 测量单次调用耗时 (ns)，与 libm 单精度版本对比。主机有硬件
+ *             sqrt，耗时只作相对参考；ESP32 上 libm 的 atan2/sqrt 为软件实现
+ *
+ * 编译运行 (在仓库根目录):
+ *   g++ -O2 -std=gnu++11 -Itools/host -Isrc tools/fast_math_bench.cpp -o /tmp/fast_math_bench
+ *   /tmp/fast_math_bench
+ */
+
+#include <Arduino.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "fast_math.h"
+
+static const double kAtanBound = 2.5e-5;
+static const double kSqrtBound = 5.0e-6;
+
+static bool report(const char* name, double maxErr, double bound, const char* unit) {
+    bool ok = maxErr <= bound;
+    printf("  %-14s max_err=%.3g %s (bound %.3g) %s\n", name, maxErr, unit, bound, ok ? "OK" : "FAIL");
+    return ok;
+}
+
+template <typename F>
+static double timeNs(const std::vector<float>& a, const std::vector<float>& b, F f) {
+    const int rounds = 200;
+    volatile float sink = 0;
+    float acc = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < a.size(); i++) {
+            acc += f(a[i], b[i]);
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    sink = acc;
+    (void)sink;
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / ((double)rounds * a.size());
+}
+
+int main() {
+    bool ok = true;
+    printf("Accuracy (full-domain sweep vs double libm):\n");
+
+    // atan2: 单位圆上密集扫描角度，再叠加不同模长
+    double atanErr = 0;
+    for (int i = 0; i <= 2000000; i++) {
+        double th = -M_PI + 2.0 * M_PI * i / 2000000.0;
+        for (float r : {1e-3f, 1.0f, 350.0f, 1e6f}) {
+            float y = (float)(r * sin(th));
+            float x = (float)(r * cos(th));
+            double e = fabs((double)fastAtan2(y, x) - atan2((double)y, (double)x));
+            if (e > M_PI) e = fabs(e - 2 * M_PI);  // ±π 处的分支
+            if (e > atanErr) atanErr = e;
+        }
+    }
+    ok &= report("fastAtan2", atanErr, kAtanBound, "rad");
+
+    // rsqrt/sqrt: 按指数与尾数扫描 [1e-6, 1e9]
+    double rsqrtErr = 0;
+    double sqrtErr = 0;
+    for (double x = 1e-6; x < 1e9; x *= 1.0000137) {
+        float xf = (float)x;
+        double ref = sqrt((double)xf);
+        double e1 = fabs((double)fastRsqrt(xf) * ref - 1.0);
+        double e2 = fabs((double)fastSqrt(xf) / ref - 1.0);
+        if (e1 > rsqrtErr) rsqrtErr = e1;
+        if (e2 > sqrtErr) sqrtErr = e2;
+    }
+    ok &= report("fastRsqrt", rsqrtErr, kSqrtBound, "rel");
+    ok &= report("fastSqrt", sqrtErr, kSqrtBound, "rel");
+
+    // 边界
+    ok &= fastAtan2(0, 0) == 0 && fastSqrt(0) == 0 && fastSqrt(-1) == 0;
+    ok &= fabsf(fastAtan2(0, -1) - FAST_PI) < 1e-6f && fabsf(fastAtan2(1, 0) - FAST_HALF_PI) < 1e-6f;
+
+    // 耗时: 与固件相同的输入量级 (cm 位置 / m/s² 加速度)
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> u(-400, 400);
+    std::vector<float> a(100000), b(100000);
+    for (size_t i = 0; i < a.size(); i++) {
+        a[i] = u(rng);
+        b[i] = u(rng);
+    }
+    printf("Timing (ns/call):\n");
+    printf("  atan2f         %6.2f\n", timeNs(a, b, [](float y, float x) { return atan2f(y, x); }));
+    printf("  atan2 (double) %6.2f\n", timeNs(a, b, [](float y, float x) { return (float)(atan2((double)y, (double)x) * 180.0 / PI); }));
+    printf("  fastAtan2Deg   %6.2f\n", timeNs(a, b, [](float y, float x) { return fastAtan2Deg(y, x); }));
+    printf("  sqrtf          %6.2f\n", timeNs(a, b, [](float y, float x) { return sqrtf(y * y + x * x); }));
+    printf("  fastSqrt       %6.2f\n", timeNs(a, b, [](float y, float x) { return fastSqrt(y * y + x * x); }));
+
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,220 @@
+/**
+ * @file filters_bench.cpp
+ * @brief 滤波器库正确性检查与逐样本耗时 (主机端)
+ * @details 1) 对 src/filters.h 中各滤波器做确定性检查:
+ *             - EmaFilter: 阶跃响应在 t = tau 时为 63.2%，固定/抖动/稀疏样本间隔结果一致
+ *             - MedianFilter: 单个尖峰不通过、阶跃在窗口过半后通过、长间隔后清空窗口
+ *             - BiquadLowpass: 直流增益 1 且无起步瞬态，截止频率处 -3 dB，10 倍截止频率处衰减
+ *               >= 38 dB，样本间隔变化后按新间隔重新设计仍满足
+ *             - OneEuroFilter: 静止时噪声明显降低，匀速斜坡的滞后小于同等静止截止频率的一阶低通
+ *             - constexpr 系数与运行时计算一致 (static_assert)
+ *          2) 测量每样本耗时 (ns)，固定 dt 与抖动 dt 分别测量 (抖动时 Ema 每次重算 expf，
+ *             Biquad 超出 10% 才重新设计)。主机有硬件浮点超越函数，耗时只作相对参考
+ *
+ * 编译运行 (在仓库根目录):
+ *   g++ -O2 -std=gnu++11 -Itools/host -Isrc tools/filters_bench.cpp -o /tmp/filters_bench
+ *   /tmp/filters_bench
+ */
+
+#include <Arduino.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "filters.h"
+
+// 编译期系数: 190 ms 时间常数在 50 Hz 下与旧的固定系数 0.1 一致
+static_assert(filters::emaAlpha(0.19f, 0.02f) > 0.0995f && filters::emaAlpha(0.19f, 0.02f) < 0.1005f,
+              "emaAlpha constexpr");
+static_assert(filters::biquadLowpass(1.0f, 0.02f).b0 > 0.0036f && filters::biquadLowpass(1.0f, 0.02f).b0 < 0.0037f,
+              "biquadLowpass constexpr");
+
+static bool check(const char* name, bool ok, const char* fmt, double value) {
+    printf("  %-44s ", name);
+    printf(fmt, value);
+    printf(" %s\n", ok ? "OK" : "FAIL");
+    return ok;
+}
+
+// 给定样本间隔序列，对 0 -> 1 阶跃求 t = tau 时的输出
+static float emaStepAt(float tau, const std::vector<float>& dts) {
+    EmaFilter f(tau);
+    f.update(0, 0);
+    float t = 0, y = 0;
+    for (float dt : dts) {
+        if (t + dt > tau + 1e-6f) break;
+        t += dt;
+        y = f.update(1, dt);
+    }
+    return y;
+}
+
+static std::vector<float> fixedDts(float dt, float total) {
+    return std::vector<float>((size_t)(total / dt + 0.5f), dt);
+}
+
+static bool testEma() {
+    bool ok = true;
+    const float tau = 0.2f;
+    const float expect = 1.0f - expf(-1.0f);
+    for (float dt : {0.001f, 0.02f, 0.1f}) {
+        char name[64];
+        snprintf(name, sizeof(name), "ema step at tau, dt %.0f ms", dt * 1000);
+        float y = emaStepAt(tau, fixedDts(dt, tau));
+        ok &= check(name, fabsf(y - expect) < 0.005f, "%.4f", y);
+    }
+    // 抖动间隔: 样本时刻恰好落在 tau 上 (最后一个间隔补齐)
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> u(0.005f, 0.05f);
+    std::vector<float> dts;
+    float t = 0;
+    while (t < tau) {
+        float dt = std::min(u(rng), tau - t);
+        dts.push_back(dt);
+        t += dt;
+    }
+    float y = emaStepAt(tau, dts);
+    ok &= check("ema step at tau, jittered 5-50 ms", fabsf(y - expect) < 0.005f, "%.4f", y);
+
+    // shift 平移状态，不影响后续收敛
+    EmaFilter f(tau, 0.02f);
+    f.update(10, 0.02f);
+    f.shift(5);
+    ok &= check("ema shift", fabsf(f.value() - 15) < 1e-6f, "%.4f", f.value());
+    return ok;
+}
+
+static bool testMedian() {
+    bool ok = true;
+    MedianFilter<5> m(0.5f);
+    float out = 0;
+    for (float x : {100.f, 101.f, 99.f, 100.f}) out = m.update(x, 0.05f);
+    out = m.update(400, 0.05f);
+    ok &= check("median rejects single spike", out < 102, "%.1f", out);
+    for (int i = 0; i < 2; i++) out = m.update(200, 0.05f);
+    ok &= check("median passes step after 3 of 5", out == 200, "%.1f", out);
+    out = m.update(50, 1.0f);
+    ok &= check("median clears after gap", out == 50 && m.size() == 1, "%.1f", out);
+    float v[4] = {4, 1, 3, 2};
+    float even = MedianFilter<4>::medianOf(v, 4);
+    ok &= check("median of even count", even == 2.5f, "%.2f", even);
+    return ok;
+}
+
+// 正弦输入的稳态幅值增益
+static float biquadGain(float fc, float nominalDt, float dt, float freq) {
+    BiquadLowpass f(fc, nominalDt);
+    float peak = 0;
+    float total = 20.0f / freq + 5.0f / fc;
+    for (float t = 0; t < total; t += dt) {
+        float y = f.update(sinf(2 * filters::kPi * freq * t), dt);
+        if (t > total - 2.0f / freq && fabsf(y) > peak) peak = fabsf(y);
+    }
+    return peak;
+}
+
+static bool testBiquad() {
+    bool ok = true;
+    BiquadLowpass dc(1.0f, 0.02f);
+    float maxDev = 0;
+    for (int i = 0; i < 200; i++) maxDev = std::max(maxDev, fabsf(dc.update(37.5f, 0.02f) - 37.5f));
+    ok &= check("biquad dc gain, no start transient", maxDev < 1e-3f, "%.2g", maxDev);
+    float g = biquadGain(1.0f, 0.02f, 0.02f, 1.0f);
+    ok &= check("biquad gain at cutoff (50 Hz)", fabsf(g - 0.7071f) < 0.03f, "%.3f", g);
+    g = biquadGain(1.0f, 0.02f, 0.02f, 10.0f);
+    ok &= check("biquad attenuation at 10x cutoff (dB)", 20 * log10f(g) < -38, "%.1f", 20 * log10f(g));
+    g = biquadGain(1.0f, 0.02f, 0.005f, 1.0f);
+    ok &= check("biquad gain at cutoff, run at 200 Hz", fabsf(g - 0.7071f) < 0.03f, "%.3f", g);
+    return ok;
+}
+
+static bool testOneEuro() {
+    bool ok = true;
+    std::mt19937 rng(7);
+    std::normal_distribution<float> n(0, 5.0f);
+    const float dt = 0.05f;
+
+    // 静止: 输出标准差 / 输入噪声标准差
+    OneEuroFilter still(1.0f, 0.05f, 1.0f);
+    double sq = 0;
+    int cnt = 0;
+    for (int i = 0; i < 2000; i++) {
+        float y = still.update(200 + n(rng), dt);
+        if (i > 100) {
+            sq += (y - 200) * (y - 200);
+            cnt++;
+        }
+    }
+    float ratio = sqrtf((float)(sq / cnt)) / 5.0f;
+    ok &= check("one-euro noise ratio when still", ratio < 0.7f, "%.2f", ratio);
+
+    // 100 cm/s 斜坡: 稳态滞后对比同样 1 Hz 的一阶低通 (tau = 1 / (2 pi fc))
+    OneEuroFilter ramp(1.0f, 0.05f, 1.0f);
+    EmaFilter ema(filters::cutoffToTau(1.0f));
+    float lagEuro = 0, lagEma = 0;
+    for (int i = 0; i < 200; i++) {
+        float x = 100.0f * dt * i;
+        lagEuro = x - ramp.update(x, dt);
+        lagEma = x - ema.update(x, dt);
+    }
+    ok &= check("one-euro ramp lag (cm), ema 1 Hz below", lagEuro < 0.25f * lagEma, "%.1f", lagEuro);
+    printf("  %-44s %.1f\n", "  ema 1 Hz ramp lag (cm)", lagEma);
+    return ok;
+}
+
+template <typename F>
+static double timeNs(const std::vector<float>& x, const std::vector<float>& dt, F f) {
+    const int rounds = 100;
+    volatile float sink = 0;
+    float acc = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < x.size(); i++) acc += f(x[i], dt[i]);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    sink = acc;
+    (void)sink;
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / ((double)rounds * x.size());
+}
+
+static void bench() {
+    std::mt19937 rng(1);
+    std::normal_distribution<float> n(0, 5.0f);
+    std::uniform_real_distribution<float> jitter(0.018f, 0.022f);
+    const size_t count = 100000;
+    std::vector<float> x(count), fixed(count, 0.02f), jittered(count);
+    for (size_t i = 0; i < count; i++) {
+        x[i] = 150 + n(rng);
+        jittered[i] = jitter(rng);
+    }
+
+    printf("Timing (ns/sample, fixed dt | jittered dt +-10%%):\n");
+    for (int j = 0; j < 2; j++) {
+        const std::vector<float>& dts = j ? jittered : fixed;
+        EmaFilter ema(0.19f, 0.02f);
+        MedianFilter<7> median;
+        BiquadLowpass biquad(1.0f, 0.02f);
+        OneEuroFilter euro(1.0f, 0.5f, 1.0f);
+        double t[4];
+        t[0] = timeNs(x, dts, [&](float v, float dt) { return ema.update(v, dt); });
+        t[1] = timeNs(x, dts, [&](float v, float dt) { return median.update(v, dt); });
+        t[2] = timeNs(x, dts, [&](float v, float dt) { return biquad.update(v, dt); });
+        t[3] = timeNs(x, dts, [&](float v, float dt) { return euro.update(v, dt); });
+        printf("  %-9s EmaFilter %6.2f  MedianFilter<7> %6.2f  BiquadLowpass %6.2f  OneEuroFilter %6.2f\n",
+               j ? "jittered" : "fixed", t[0], t[1], t[2], t[3]);
+    }
+    printf("Memory (bytes): EmaFilter %u  MedianFilter<7> %u  BiquadLowpass %u  OneEuroFilter %u\n",
+           (unsigned)sizeof(EmaFilter), (unsigned)sizeof(MedianFilter<7>), (unsigned)sizeof(BiquadLowpass),
+           (unsigned)sizeof(OneEuroFilter));
+}
+
+int main() {
+    bool ok = true;
+    printf("Checks:\n");
+    ok &= testEma();
+    ok &= testMedian();
+    ok &= testBiquad();
+    ok &= testOneEuro();
+    bench();
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
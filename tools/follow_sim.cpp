@@ -0,0 +1,742 @@
+/**
+ * @file follow_sim.cpp
+ * @brief 跟随闭环仿真与场景基准 (主机端)
+ * @details 真实的 UWB 解析/定位 (UWB::calculatePosition)、跟踪器、Follow 与 Motor 斜坡代码
+ *          在仿真世界中闭环运行，用于在主机上调 FOLLOW_* 参数，不必反复烧录后到走廊里走:
+ *          - 行人: 按脚本 (直行、走停交替、90° 转角、掉头、折线) 在世界坐标系中行走，身上带标签
+ *          - 车: 差速运动学，轮速 = 实际占空比 (斜坡之后) × CART_SPEED_PER_DUTY，
+ *                左右轮增益可设不一致 (--wheel-err)，航位推算因此与真值有偏差
+ *          - UWB: 每基站 20 Hz，按基站在车上的物理位置 (UWB_ANGLE_INVERT 时左右互换) 计算真实距离，
+ *                 叠加高斯噪声、多径尖峰、单帧丢失与成段遮挡，以二进制帧写入 Serial2/Serial1
+ *          - 陀螺仪: 每个控制周期把真实转角加上零偏 (--gyro-bias) 经 follow.rotate() 送入，
+ *                    与固件 IMU_GYRO_COMP_ENABLED 时相同；--no-gyro 模拟 IMU 不可用
+ *          事件模型与 uwb_replay 一致: 帧到达即 uwb.update()，控制按 CONTROL_RATE_HZ 执行
+ *          follow.updateFromUwb()，时钟由 hostAdvanceTo() 推进 (电机斜坡定时器照常运行)。
+ *          --stall 使每个控制周期随机延后 0~MS 毫秒，检验滤波与延迟是否随负载变化。
+ *
+ *          指标 (每个场景 × 随机种子):
+ *          - track: 行人行走时 距离 - 停止距离 的 RMS (cm) 与平均距离
+ *          - catch: 行人起步到车速达到行人速度 80% 的时间 (s)
+ *          - over:  行人停下后 3 s 内车比停止距离更近的最大值 (cm)，min_gap 为全程最近距离
+ *          - path:  车偏离行人走过路径的最大距离 (cm)，反映转角处抄近路
+ *          - aim:   距离大于停止距离时，车头与行人真实方位的夹角 RMS (度)，反映转向滞后与摆动
+ *          - chatter: 两轮实际占空比变化量之和 (占空比/s)，flips 为每分钟转向方向反转次数，
+ *                     toggles 为停车/行驶切换次数
+ *          - cost:  排序用的综合代价 = track + 2 × over + path + 20 × catch + 0.02 × chatter
+ *                   (min_gap < 40 cm 视为碰撞，另加 200)
+ *
+ *          参数扫描: --sweep 给出若干参数的取值范围，取笛卡尔积；每个 (参数组合, 场景, 种子)
+ *          由干净的父进程 fork 一个子进程运行 (固件代码全是全局单例，子进程互不干扰)，
+ *          最多 -j 个并发 (默认全部核)，结果经管道返回。参数名见 --list
+ *
+ * 编译运行 (在仓库根目录):
+ *   g++ -O2 -std=gnu++11 -DUWB_RX_TASK_ENABLED=0 -DUWB_LOG_ENABLED=0 -DDEBUG_ENABLED=0 \
+ *       -Itools/host -Isrc tools/follow_sim.cpp src/uwb.cpp src/uwb_parser.cpp src/uwb_filter.cpp \
+ *       src/uwb_tags.cpp src/tracker.cpp src/follow.cpp src/motor.cpp -o /tmp/follow_sim
+ *   /tmp/follow_sim                                   全部场景 × 4 个种子，按场景输出指标
+ *   /tmp/follow_sim --sweep kpDist=0.5:2:0.25 --sweep ffGain=0:1:0.2 > sweep.csv
+ *   /tmp/follow_sim --trace corner > corner.csv       输出一次运行的时间序列 (真值位置、距离、占空比)
+ *   选项: --scenario NAME (可重复)  --seeds N (4)  -j N  --set NAME=V  --list
+ *         --noise CM (4)  --spike P (0.02)  --loss P (0.03)  --bursts N 每分钟遮挡次数 (3)  --wheel-err F (0.03)
+ *         --no-gyro  --gyro-bias DPS (0.2)  --stall MS (0)
+ */
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include "uwb.h"
+#include "follow.h"
+#include "motor.h"
+#include "control.h"
+
+// ==================== 场景 ====================
+
+struct WalkSeg {
+    float dur;      // s
+    float speed;    // cm/s
+    float turn;     // deg/s，正值向右转
+};
+
+struct Scenario {
+    const char* name;
+    const WalkSeg* segs;
+    size_t count;
+};
+
+// 行人起点在车前 1.5 m，与车同向；速度不超过车的最高速度 (约 85 cm/s)
+static const WalkSeg kStraight[] = {{2, 0, 0}, {8, 60, 0}, {3, 0, 0}};
+static const WalkSeg kStopGo[] = {{2, 0, 0}, {3, 70, 0}, {2, 0, 0}, {2, 50, 0}, {1.5f, 0, 0},
+                                  {3, 80, 0}, {3, 0, 0}};
+static const WalkSeg kCorner[] = {{2, 0, 0}, {4, 60, 0}, {1, 60, 90}, {4, 60, 0}, {3, 0, 0}};
+// 半径约 64 cm 的掉头，往回走时从车旁经过
+static const WalkSeg kUTurn[] = {{2, 0, 0}, {4, 50, 0}, {4, 50, 45}, {5, 50, 0}, {3, 0, 0}};
+// 左右折线前进 (每段偏 60°): 方位角大幅来回变化，车需频繁大角度转向，行人始终在车前方
+static const WalkSeg kZigzag[] = {{2, 0, 0}, {0.5f, 60, 120}, {2.5f, 60, 0}, {1, 60, -120},
+                                  {3, 60, 0}, {1, 60, 120}, {2.5f, 60, 0}, {3, 0, 0}};
+
+#define SCENARIO(n, s) {n, s, sizeof(s) / sizeof(s[0])}
+static const Scenario kScenarios[] = {SCENARIO("straight", kStraight), SCENARIO("stop_go", kStopGo),
+                                      SCENARIO("corner", kCorner), SCENARIO("uturn", kUTurn),
+                                      SCENARIO("zigzag", kZigzag)};
+static const int kScenarioCount = sizeof(kScenarios) / sizeof(kScenarios[0]);
+
+static float scenarioDuration(const Scenario& sc) {
+    float d = 0;
+    for (size_t i = 0; i < sc.count; i++) d += sc.segs[i].dur;
+    return d;
+}
+
+// ==================== 参数 ====================
+
+struct ParamDef {
+    const char* name;
+    float FollowParams::*field;
+};
+
+static const ParamDef kParams[] = {
+    {"kpDist", &FollowParams::kpDist},
+    {"kpAngle", &FollowParams::kpAngle},
+    {"kdAngle", &FollowParams::kdAngle},
+    {"angleDeadzone", &FollowParams::angleDeadzone},
+    {"speedMax", &FollowParams::speedMax},
+    {"turnMax", &FollowParams::turnMax},
+    {"arcAngle", &FollowParams::arcAngle},
+    {"filterTauMs", &FollowParams::filterTauMs},
+    {"lookahead", &FollowParams::lookahead},
+    {"ffGain", &FollowParams::ffGain},
+    {"brakeLatency", &FollowParams::brakeLatency},
+    {"coastMs", &FollowParams::coastMs},
+};
+
+static const ParamDef* findParam(const std::string& name) {
+    for (const ParamDef& p : kParams) {
+        if (name == p.name) return &p;
+    }
+    return nullptr;
+}
+
+struct Sweep {
+    const ParamDef* param;
+    std::vector<float> values;
+};
+
+// ==================== 仿真世界 ====================
+
+struct SimOptions {
+    float noise = 4.0f;         // 测距噪声标准差 (cm)
+    float spike = 0.02f;        // 多径尖峰概率 (每帧)
+    float loss = 0.03f;         // 单帧丢失概率
+    float bursts = 3.0f;        // 成段遮挡 (两基站同时无数据) 次数 / 分钟
+    float wheelErr = 0.03f;     // 左轮增益 +err、右轮 -err
+    bool gyro = IMU_GYRO_COMP_ENABLED;
+    float gyroBias = 0.2f;      // 标定后的残余零偏 (度/s)
+    float stallMs = 0.0f;       // 控制周期随机延后的最大值 (ms)，模拟显示/传感器阻塞
+};
+
+struct Body {
+    float x = 0, y = 0;         // cm，世界坐标: y 为初始车头方向，x 向右
+    float heading = 0;          // rad，正值向右转
+
+    void advance(float v, float w, float dt) {
+        float mid = heading + 0.5f * w * dt;
+        x += v * sinf(mid) * dt;
+        y += v * cosf(mid) * dt;
+        heading += w * dt;
+    }
+};
+
+struct RunResult {
+    float trackRms, meanGap, minGap;
+    float overshootMax, overshootAvg;
+    float catchAvg, catchMax;
+    float pathMax, pathRms;
+    float aimRms;
+    float chatter, flips, toggles;
+    float cost;
+    float simSec;
+    uint32_t dropouts, recovered, hardStops;
+};
+
+class World {
+public:
+    World(const Scenario& sc, const SimOptions& opt, uint32_t seed)
+        : _sc(sc), _opt(opt), _rng(seed), _noise(0, 1), _u(0, 1) {
+        _user.y = 150;
+        // 车起点到行人起点的直线也算作路径
+        for (float y = _cart.y; y < _user.y; y += kPathSpacing) _path.push_back(PathPoint{_cart.x, y});
+        _path.push_back(PathPoint{_user.x, _user.y});
+    }
+
+    RunResult run(FILE* trace);
+
+private:
+    struct PathPoint {
+        float x, y;
+    };
+    static constexpr float kPathSpacing = 2.0f;   // 路径记录间距 (cm)
+
+    const Scenario& _sc;
+    SimOptions _opt;
+    std::mt19937 _rng;
+    std::normal_distribution<float> _noise;
+    std::uniform_real_distribution<float> _u;
+    Body _user;
+    Body _cart;
+    std::vector<PathPoint> _path;
+    unsigned long _burstEndUs = 0;
+    float _gyroHeading = 0;     // 上次送入陀螺仪转角时的车头方向 (rad)
+
+    const WalkSeg& segAt(float t, float* segStart = nullptr) const {
+        float t0 = 0;
+        for (size_t i = 0; i + 1 < _sc.count; i++) {
+            if (t < t0 + _sc.segs[i].dur) {
+                if (segStart) *segStart = t0;
+                return _sc.segs[i];
+            }
+            t0 += _sc.segs[i].dur;
+        }
+        if (segStart) *segStart = t0;
+        return _sc.segs[_sc.count - 1];
+    }
+
+    void stepWorld(float t, float dt) {
+        const WalkSeg& s = segAt(t);
+        _user.advance(s.speed, s.turn * (float)M_PI / 180.0f, dt);
+        const PathPoint& last = _path.back();
+        float dx = _user.x - last.x, dy = _user.y - last.y;
+        if (dx * dx + dy * dy > kPathSpacing * kPathSpacing) _path.push_back(PathPoint{_user.x, _user.y});
+
+        int16_t left, right;
+        motor.getWheels(left, right);
+        float vl = left * CART_SPEED_PER_DUTY * (1 + _opt.wheelErr);
+        float vr = right * CART_SPEED_PER_DUTY * (1 - _opt.wheelErr);
+        _cart.advance(0.5f * (vl + vr), (vl - vr) / CART_TRACK_WIDTH, dt);
+    }
+
+    // 基站 a 测得的距离 (cm)；返回 false 表示该帧丢失
+    bool range(uint8_t a, unsigned long nowUs, float& out) {
+        static const AnchorPos anchors[] = UWB_ANCHOR_POSITIONS;
+        if ((long)(nowUs - _burstEndUs) < 0) return false;
+        if (_u(_rng) < _opt.loss) return false;
+        // 车体坐标 -> 世界坐标；UWB_ANGLE_INVERT 表示基站左右装反，物理位置取镜像
+        float bx = UWB_ANGLE_INVERT ? -anchors[a].x : anchors[a].x;
+        float by = anchors[a].y;
+        float s = sinf(_cart.heading), c = cosf(_cart.heading);
+        float wx = _cart.x + bx * c + by * s;
+        float wy = _cart.y - bx * s + by * c;
+        float d = sqrtf((_user.x - wx) * (_user.x - wx) + (_user.y - wy) * (_user.y - wy));
+        d += _opt.noise * _noise(_rng);
+        if (_u(_rng) < _opt.spike) d += 100.0f + 150.0f * _u(_rng);
+        out = d;
+        return true;
+    }
+
+    void maybeStartBurst(unsigned long nowUs, float dt) {
+        if ((long)(nowUs - _burstEndUs) < 0) return;
+        if (_u(_rng) < _opt.bursts / 60.0f * dt) {
+            _burstEndUs = nowUs + (unsigned long)(200000 + 1000000 * _u(_rng));
+        }
+    }
+
+    // 上个控制周期以来的陀螺仪转角 (度，右转为正)
+    float gyroDelta(float dt) {
+        float d = (_cart.heading - _gyroHeading) * 180.0f / (float)M_PI + _opt.gyroBias * dt;
+        _gyroHeading = _cart.heading;
+        return d;
+    }
+
+    float pathDistance() const {
+        float best = 1e9f;
+        for (const PathPoint& p : _path) {
+            float d = (p.x - _cart.x) * (p.x - _cart.x) + (p.y - _cart.y) * (p.y - _cart.y);
+            if (d < best) best = d;
+        }
+        return sqrtf(best);
+    }
+};
+
+static void feedFrame(uint8_t anchor, float cm) {
+    uint16_t v = (uint16_t)constrain(cm + 0.5f, 0.0f, 65535.0f);
+    const uint8_t frame[8] = {0xF0, 0x05, 0x01, 0x00, (uint8_t)v, (uint8_t)(v >> 8), 0x50, 0xAA};
+    HardwareSerial& port = (anchor == 0) ? Serial2 : Serial1;
+    port.hostFeed(frame, sizeof(frame));
+    uwb.update();
+}
+
+RunResult World::run(FILE* trace) {
+    const unsigned long tickUs = 1000;
+    const unsigned long frameUs = 50000;        // 每基站 20 Hz
+    const float kCatch = 0.8f, kHorizon = 3.0f;
+    float stopDist = FOLLOW_DIST_TARGET + FOLLOW_DIST_DEADZONE;
+    if (stopDist < FOLLOW_ENABLE_DISTANCE) stopDist = FOLLOW_ENABLE_DISTANCE;
+
+    // 与固件 setup() + setMode(MODE_FOLLOWING) 相同的初始化；时钟从 1 s 起，避免 0 被当作 "无数据"
+    const unsigned long startUs = 1000000UL;
+    hostMicros() = startUs;
+    motor.begin();
+    uwb.begin();
+    follow.begin();
+    motor.setSpeed(MOTOR_SPEED_FOLLOW_FORWARD, MOTOR_SPEED_FOLLOW_TURN);
+
+    RunResult r;
+    memset(&r, 0, sizeof(r));
+    bool catching = false, watchingStop = false;
+    float eventT = 0, overNow = 0;
+    r.minGap = 1e9f;
+    double trackSq = 0, gapSum = 0, pathSq = 0, aimSq = 0;
+    unsigned long walkTicks = 0, pathTicks = 0, aimTicks = 0;
+    float catchSum = 0, overSum = 0;
+    auto endCatch = [&](float t) {
+        catchSum += t - eventT;
+        if (t - eventT > r.catchMax) r.catchMax = t - eventT;
+    };
+    auto endStop = [&]() {
+        overSum += overNow;
+        if (overNow > r.overshootMax) r.overshootMax = overNow;
+    };
+    int starts = 0, stops = 0;
+    int16_t prevL = 0, prevR = 0;
+    int prevSteer = 0;
+    bool prevMoving = false;
+    float traveled = 0;
+
+    unsigned long nextFrame[UWB_ANCHOR_COUNT];
+    for (uint8_t a = 0; a < UWB_ANCHOR_COUNT; a++) nextFrame[a] = startUs + a * frameUs / UWB_ANCHOR_COUNT;
+    unsigned long nextLoop = startUs;
+    unsigned long lastLoop = startUs;
+    float duration = scenarioDuration(_sc);
+    const WalkSeg* prevSeg = nullptr;
+
+    if (trace) fprintf(trace, "t,user_x,user_y,cart_x,cart_y,cart_heading,gap,left,right,fix_distance,fix_angle\n");
+
+    for (unsigned long us = startUs; us < startUs + (unsigned long)(duration * 1e6f); us += tickUs) {
+        float t = (us - startUs) * 1e-6f;
+        stepWorld(t, tickUs * 1e-6f);
+        hostAdvanceTo(us + tickUs);
+        maybeStartBurst(micros(), tickUs * 1e-6f);
+
+        for (uint8_t a = 0; a < UWB_ANCHOR_COUNT; a++) {
+            if ((long)(micros() - nextFrame[a]) < 0) continue;
+            // 帧间隔 ±3 ms 抖动
+            nextFrame[a] += frameUs - 3000 + (unsigned long)(6000 * _u(_rng));
+            float d;
+            if (range(a, micros(), d)) feedFrame(a, d);
+        }
+
+        if ((long)(micros() - nextLoop) < 0) continue;
+        // 控制任务被阻塞时本周期延后执行，dt 取实际间隔
+        nextLoop = micros() + CONTROL_PERIOD_US;
+        if (_opt.stallMs > 0) nextLoop += (unsigned long)(_opt.stallMs * 1000.0f * _u(_rng));
+        float dt = (micros() - lastLoop) * 1e-6f;
+        lastLoop = micros();
+        uwb.update();
+        // 与固件 controlStep 相同: 每周期一次陀螺仪转角，先做直行航向保持再做跟随
+        float yaw = _opt.gyro ? gyroDelta(dt) : 0.0f;
+#if HEADING_HOLD_ENABLED
+        if (_opt.gyro && motor.isHoldingHeading()) motor.holdHeading(yaw, dt);
+#endif
+#if IMU_GYRO_COMP_ENABLED
+        if (_opt.gyro) follow.rotate(yaw);
+#endif
+        follow.updateFromUwb(dt);
+
+        // ---------- 指标 ----------
+        float segStart;
+        const WalkSeg& seg = segAt(t, &segStart);
+        float gap = sqrtf((_user.x - _cart.x) * (_user.x - _cart.x) + (_user.y - _cart.y) * (_user.y - _cart.y));
+        int16_t left, right;
+        motor.getWheels(left, right);
+        float cartSpeed = 0.5f * (left + right) * CART_SPEED_PER_DUTY;
+        traveled += fabsf(cartSpeed) * dt;
+
+        if (&seg != prevSeg) {
+            bool wasMoving = prevSeg != nullptr && prevSeg->speed > 0;
+            if (seg.speed > 0 && !wasMoving) {
+                if (catching) endCatch(t);
+                catching = true;
+                eventT = segStart;
+                starts++;
+            } else if (seg.speed == 0 && wasMoving) {
+                if (watchingStop) endStop();
+                watchingStop = true;
+                overNow = 0;
+                eventT = segStart;
+                stops++;
+            }
+            prevSeg = &seg;
+        }
+        if (catching && cartSpeed >= kCatch * seg.speed) {
+            catching = false;
+            endCatch(t);
+        }
+        if (watchingStop) {
+            if (t - eventT <= kHorizon) {
+                if (stopDist - gap > overNow) overNow = stopDist - gap;
+            } else {
+                endStop();
+                watchingStop = false;
+            }
+        }
+
+        if (gap < r.minGap) r.minGap = gap;
+        if (seg.speed > 0) {
+            trackSq += (gap - stopDist) * (gap - stopDist);
+            gapSum += gap;
+            walkTicks++;
+        }
+        if (gap > stopDist) {
+            float aim = atan2f(_user.x - _cart.x, _user.y - _cart.y) - _cart.heading;
+            aim = remainderf(aim, 2.0f * (float)M_PI) * 180.0f / (float)M_PI;
+            aimSq += aim * aim;
+            aimTicks++;
+        }
+        if (traveled > 30.0f) {
+            float dev = pathDistance();
+            if (dev > r.pathMax) r.pathMax = dev;
+            pathSq += dev * dev;
+            pathTicks++;
+        }
+
+        r.chatter += abs(left - prevL) + abs(right - prevR);
+        int diff = left - right;
+        int steer = (diff > 10) ? 1 : (diff < -10 ? -1 : 0);
+        if (steer != 0) {
+            if (prevSteer != 0 && steer != prevSteer) r.flips++;
+            prevSteer = steer;
+        }
+        bool moving = left != 0 || right != 0;
+        if (moving != prevMoving) r.toggles++;
+        prevMoving = moving;
+        prevL = left;
+        prevR = right;
+
+        if (trace) {
+            UWBData p = uwb.getPrediction(micros());
+            fprintf(trace, "%.3f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%d,%d,%.1f,%.1f\n", t, _user.x, _user.y, _cart.x,
+                    _cart.y, _cart.heading * 180.0f / (float)M_PI, gap, left, right, p.valid ? p.distance : 0.0f,
+                    p.valid ? p.angle : 0.0f);
+        }
+    }
+    // 结束时仍未追上/未满观察期的事件按已过时间计
+    if (catching) endCatch(duration);
+    if (watchingStop) endStop();
+
+    r.simSec = duration;
+    r.trackRms = walkTicks ? (float)sqrt(trackSq / walkTicks) : 0;
+    r.meanGap = walkTicks ? (float)(gapSum / walkTicks) : 0;
+    r.overshootAvg = stops ? overSum / stops : 0;
+    r.catchAvg = starts ? catchSum / starts : 0;
+    r.pathRms = pathTicks ? (float)sqrt(pathSq / pathTicks) : 0;
+    r.aimRms = aimTicks ? (float)sqrt(aimSq / aimTicks) : 0;
+    r.chatter /= duration;
+    r.flips *= 60.0f / duration;
+    FollowStats st = follow.getStats();
+    r.dropouts = st.dropouts;
+    r.recovered = st.recovered;
+    r.hardStops = st.hardStops;
+    r.cost = r.trackRms + 2 * r.overshootMax + r.pathMax + 20 * r.catchAvg + 0.02f * r.chatter;
+    if (r.minGap < 40.0f) r.cost += 200.0f;
+    return r;
+}
+
+// ==================== 并行运行 ====================
+
+struct Job {
+    int combo;
+    int scenario;
+    int seed;
+};
+
+static RunResult runJob(const Job& job, const FollowParams& params, const SimOptions& opt) {
+    follow.setParams(params);
+    World w(kScenarios[job.scenario], opt, 1000u * (uint32_t)job.seed + 17u * (uint32_t)job.scenario + 1u);
+    return w.run(nullptr);
+}
+
+// 每个任务 fork 一个子进程: 父进程从未运行过固件代码，子进程的全局状态都是初始值
+static bool runParallel(const std::vector<Job>& jobs, const std::vector<FollowParams>& combos,
+                        const SimOptions& opt, int workers, std::vector<RunResult>& results) {
+    results.assign(jobs.size(), RunResult());
+    std::vector<int> pipeOf(jobs.size(), -1);
+    std::vector<std::pair<pid_t, size_t>> running;
+    size_t next = 0;
+    bool ok = true;
+    fflush(stdout);
+    fflush(stderr);
+    while (next < jobs.size() || !running.empty()) {
+        while (next < jobs.size() && (int)running.size() < workers) {
+            int fd[2];
+            if (pipe(fd) != 0) {
+                perror("pipe");
+                return false;
+            }
+            pid_t pid = fork();
+            if (pid < 0) {
+                perror("fork");
+                return false;
+            }
+            if (pid == 0) {
+                close(fd[0]);
+                RunResult r = runJob(jobs[next], combos[jobs[next].combo], opt);
+                ssize_t n = write(fd[1], &r, sizeof(r));
+                _exit(n == (ssize_t)sizeof(r) ? 0 : 1);
+            }
+            close(fd[1]);
+            pipeOf[next] = fd[0];
+            running.push_back(std::make_pair(pid, next));
+            next++;
+        }
+        int status = 0;
+        pid_t done = wait(&status);
+        if (done < 0) break;
+        for (size_t i = 0; i < running.size(); i++) {
+            if (running[i].first != done) continue;
+            size_t j = running[i].second;
+            // 结果小于 PIPE_BUF，子进程退出前已整体写入
+            if (read(pipeOf[j], &results[j], sizeof(RunResult)) != (ssize_t)sizeof(RunResult) ||
+                !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                fprintf(stderr, "job %u (%s seed %d) failed\n", (unsigned)j, kScenarios[jobs[j].scenario].name,
+                        jobs[j].seed);
+                ok = false;
+            }
+            close(pipeOf[j]);
+            running.erase(running.begin() + i);
+            break;
+        }
+    }
+    return ok;
+}
+
+// ==================== 输出 ====================
+
+static void accumulate(RunResult& sum, const RunResult& r) {
+    sum.trackRms += r.trackRms;
+    sum.meanGap += r.meanGap;
+    sum.minGap = std::min(sum.minGap, r.minGap);
+    sum.overshootMax = std::max(sum.overshootMax, r.overshootMax);
+    sum.overshootAvg += r.overshootAvg;
+    sum.catchAvg += r.catchAvg;
+    sum.catchMax = std::max(sum.catchMax, r.catchMax);
+    sum.pathMax = std::max(sum.pathMax, r.pathMax);
+    sum.pathRms += r.pathRms;
+    sum.aimRms += r.aimRms;
+    sum.chatter += r.chatter;
+    sum.flips += r.flips;
+    sum.toggles += r.toggles;
+    sum.cost += r.cost;
+    sum.simSec += r.simSec;
+    sum.dropouts += r.dropouts;
+    sum.recovered += r.recovered;
+    sum.hardStops += r.hardStops;
+}
+
+// 平均值字段除以次数，最大/最小/计数字段保持累计
+static RunResult average(const std::vector<RunResult>& runs) {
+    RunResult s;
+    memset(&s, 0, sizeof(s));
+    s.minGap = 1e9f;
+    for (const RunResult& r : runs) accumulate(s, r);
+    float n = runs.empty() ? 1.0f : (float)runs.size();
+    s.trackRms /= n;
+    s.meanGap /= n;
+    s.overshootAvg /= n;
+    s.catchAvg /= n;
+    s.pathRms /= n;
+    s.aimRms /= n;
+    s.chatter /= n;
+    s.flips /= n;
+    s.toggles /= n;
+    s.cost /= n;
+    return s;
+}
+
+static void printRow(const char* name, const RunResult& r) {
+    printf("%-9s %6.1f %6.0f | %5.2f %5.2f | %5.1f %5.1f %6.1f | %5.1f %5.1f | %5.1f | %6.0f %5.1f %5.1f | %3u/%u/%u | %6.1f\n",
+           name, r.trackRms, r.meanGap, r.catchAvg, r.catchMax, r.overshootAvg, r.overshootMax, r.minGap,
+           r.pathMax, r.pathRms, r.aimRms, r.chatter, r.flips, r.toggles, (unsigned)r.dropouts, (unsigned)r.recovered,
+           (unsigned)r.hardStops, r.cost);
+}
+
+static void usage() {
+    fprintf(stderr,
+            "usage: follow_sim [--scenario NAME]... [--seeds N] [-j N] [--set NAME=V]... [--sweep NAME=LO:HI:STEP]...\n"
+            "                  [--noise CM] [--spike P] [--loss P] [--bursts N] [--wheel-err F] [--no-gyro] [--gyro-bias DPS]\n"
+            "                  [--stall MS] [--trace NAME] [--list]\n");
+}
+
+static bool parseAssign(const char* arg, std::string& name, std::string& value) {
+    const char* eq = strchr(arg, '=');
+    if (eq == nullptr) return false;
+    name.assign(arg, eq - arg);
+    value = eq + 1;
+    return true;
+}
+
+static int scenarioIndex(const char* name) {
+    for (int i = 0; i < kScenarioCount; i++) {
+        if (strcmp(kScenarios[i].name, name) == 0) return i;
+    }
+    fprintf(stderr, "unknown scenario %s\n", name);
+    return -1;
+}
+
+int main(int argc, char** argv) {
+    SimOptions opt;
+    FollowParams base;
+    std::vector<Sweep> sweeps;
+    std::vector<int> scenarios;
+    int seeds = 4;
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    int workers = cores > 0 ? (int)cores : 1;
+    const char* trace = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        bool hasValue = i + 1 < argc;
+        std::string name, value;
+        if (a == "--list") {
+            for (const ParamDef& p : kParams) printf("%-14s %g\n", p.name, base.*p.field);
+            for (const Scenario& s : kScenarios) printf("scenario %-8s %.0f s\n", s.name, scenarioDuration(s));
+            return 0;
+        } else if (a == "--scenario" && hasValue) {
+            int s = scenarioIndex(argv[++i]);
+            if (s < 0) return 1;
+            scenarios.push_back(s);
+        } else if (a == "--trace" && hasValue) {
+            trace = argv[++i];
+        } else if (a == "--seeds" && hasValue) {
+            seeds = std::max(1, atoi(argv[++i]));
+        } else if (a == "-j" && hasValue) {
+            workers = std::max(1, atoi(argv[++i]));
+        } else if (a == "--noise" && hasValue) {
+            opt.noise = atof(argv[++i]);
+        } else if (a == "--spike" && hasValue) {
+            opt.spike = atof(argv[++i]);
+        } else if (a == "--loss" && hasValue) {
+            opt.loss = atof(argv[++i]);
+        } else if (a == "--bursts" && hasValue) {
+            opt.bursts = atof(argv[++i]);
+        } else if (a == "--wheel-err" && hasValue) {
+            opt.wheelErr = atof(argv[++i]);
+        } else if (a == "--no-gyro") {
+            opt.gyro = false;
+        } else if (a == "--gyro-bias" && hasValue) {
+            opt.gyroBias = atof(argv[++i]);
+        } else if (a == "--stall" && hasValue) {
+            opt.stallMs = atof(argv[++i]);
+        } else if (a == "--set" && hasValue && parseAssign(argv[++i], name, value)) {
+            const ParamDef* p = findParam(name);
+            if (p == nullptr) {
+                fprintf(stderr, "unknown parameter %s (see --list)\n", name.c_str());
+                return 1;
+            }
+            base.*p->field = atof(value.c_str());
+        } else if (a == "--sweep" && hasValue && parseAssign(argv[++i], name, value)) {
+            Sweep sw;
+            sw.param = findParam(name);
+            float lo, hi, step;
+            if (sw.param == nullptr || sscanf(value.c_str(), "%f:%f:%f", &lo, &hi, &step) != 3 || step <= 0 || hi < lo) {
+                fprintf(stderr, "bad sweep %s (NAME=LO:HI:STEP, see --list)\n", argv[i]);
+                return 1;
+            }
+            for (int k = 0; lo + k * step <= hi + step * 1e-3f; k++) sw.values.push_back(lo + k * step);
+            sweeps.push_back(sw);
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    if (trace) {
+        int s = scenarioIndex(trace);
+        if (s < 0) return 1;
+        follow.setParams(base);
+        World w(kScenarios[s], opt, 1u + 17u * (uint32_t)s);
+        RunResult r = w.run(stdout);
+        fprintf(stderr, "%s: track %.1f cm, catch %.2f s, overshoot %.1f cm, min gap %.0f cm, path %.1f cm\n",
+                trace, r.trackRms, r.catchAvg, r.overshootMax, r.minGap, r.pathMax);
+        return 0;
+    }
+    if (scenarios.empty()) {
+        for (int i = 0; i < kScenarioCount; i++) scenarios.push_back(i);
+    }
+
+    // 参数组合: 各 --sweep 取值的笛卡尔积 (无扫描时只有基准参数一组)
+    std::vector<FollowParams> combos(1, base);
+    for (const Sweep& sw : sweeps) {
+        std::vector<FollowParams> expanded;
+        for (const FollowParams& c : combos) {
+            for (float v : sw.values) {
+                FollowParams p = c;
+                p.*sw.param->field = v;
+                expanded.push_back(p);
+            }
+        }
+        combos.swap(expanded);
+    }
+
+    std::vector<Job> jobs;
+    for (int c = 0; c < (int)combos.size(); c++) {
+        for (int s : scenarios) {
+            for (int k = 0; k < seeds; k++) jobs.push_back(Job{c, s, k});
+        }
+    }
+
+    auto wall0 = std::chrono::steady_clock::now();
+    std::vector<RunResult> results;
+    bool ok = runParallel(jobs, combos, opt, workers, results);
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall0).count();
+    double simSec = 0;
+    for (const RunResult& r : results) simSec += r.simSec;
+
+    if (sweeps.empty()) {
+        printf("noise %.1f cm, spike %.2f, loss %.2f, bursts %.1f/min, wheel err %.2f, gyro %s, stall %.0f ms, %d seeds\n",
+               opt.noise, opt.spike, opt.loss, opt.bursts, opt.wheelErr, opt.gyro ? "on" : "off", opt.stallMs, seeds);
+        printf("scenario   track    gap | catch   max |  over   max    min |  path   rms |   aim |  chatter flips tggl | drop/rec/hs |   cost\n");
+        std::vector<RunResult> all;
+        for (int s : scenarios) {
+            std::vector<RunResult> runs;
+            for (size_t j = 0; j < jobs.size(); j++) {
+                if (jobs[j].scenario == s) runs.push_back(results[j]);
+            }
+            printRow(kScenarios[s].name, average(runs));
+            all.insert(all.end(), runs.begin(), runs.end());
+        }
+        printRow("all", average(all));
+    } else {
+        for (const Sweep& sw : sweeps) printf("%s,", sw.param->name);
+        printf("track_rms,mean_gap,catch_avg,catch_max,over_avg,over_max,min_gap,path_max,path_rms,aim_rms,chatter,flips,"
+               "toggles,hard_stops,cost\n");
+        std::vector<std::pair<float, int>> ranking;
+        for (int c = 0; c < (int)combos.size(); c++) {
+            std::vector<RunResult> runs;
+            for (size_t j = 0; j < jobs.size(); j++) {
+                if (jobs[j].combo == c) runs.push_back(results[j]);
+            }
+            RunResult r = average(runs);
+            for (const Sweep& sw : sweeps) printf("%g,", combos[c].*sw.param->field);
+            printf("%.2f,%.1f,%.3f,%.3f,%.2f,%.2f,%.1f,%.2f,%.2f,%.2f,%.0f,%.2f,%.2f,%u,%.2f\n", r.trackRms, r.meanGap,
+                   r.catchAvg, r.catchMax, r.overshootAvg, r.overshootMax, r.minGap, r.pathMax, r.pathRms, r.aimRms,
+                   r.chatter,
+                   r.flips, r.toggles, (unsigned)r.hardStops, r.cost);
+            ranking.push_back(std::make_pair(r.cost, c));
+        }
+        std::sort(ranking.begin(), ranking.end());
+        fprintf(stderr, "best:\n");
+        for (size_t i = 0; i < ranking.size() && i < 5; i++) {
+            fprintf(stderr, "  cost %7.2f:", ranking[i].first);
+            for (const Sweep& sw : sweeps) fprintf(stderr, " %s=%g", sw.param->name, combos[ranking[i].second].*sw.param->field);
+            fprintf(stderr, "\n");
+        }
+    }
+    fprintf(stderr, "%u runs, %.0f simulated s in %.2f s wall on %d workers (%.0fx real time)\n",
+            (unsigned)jobs.size(), simSec, wall, workers, simSec / (wall > 0 ? wall : 1e-9));
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file Arduino.h
+ * @brief 主机端 (Linux) 最小 Arduino 兼容层
+ * @details 仅供 tools/ 下的主机工具编译 src/ 中与硬件无关的代码
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+#include <deque>
+
+#define SERIAL_8N1 0x800001c
+
+// 主机端时钟由工具程序推进 (回放时为日志时间)
+inline unsigned long& hostMicros() {
+    static unsigned long t = 0;
+    return t;
+}
+inline unsigned long micros() { return hostMicros(); }
+inline unsigned long millis() { return hostMicros() / 1000UL; }
+
+// ledcWrite 只记录各通道占空比，供回放工具读取电机指令
+inline uint32_t* hostLedcDuty() {
+    static uint32_t duty[16] = {0};
+    return duty;
+}
+// 可选回调: 按调用顺序观察每次写入 (电机后端对比用)
+typedef void (*HostLedcHook)(uint8_t channel, uint32_t duty);
+inline HostLedcHook& hostLedcHook() {
+    static HostLedcHook hook = nullptr;
+    return hook;
+}
+inline double ledcSetup(uint8_t, double freq, uint8_t) { return freq; }
+inline void ledcAttachPin(uint8_t, uint8_t) {}
+inline void ledcWrite(uint8_t channel, uint32_t duty) {
+    hostLedcDuty()[channel & 15] = duty;
+    if (hostLedcHook()) hostLedcHook()(channel, duty);
+}
+
+// 忙等待: 主机时钟直接前进 (不执行 esp_timer 回调)
+inline void delayMicroseconds(unsigned int us) { hostMicros() += us; }
+
+class Print {
+public:
+    template <typename... Args>
+    int printf(const char* fmt, Args... args) { return ::printf(fmt, args...); }
+    int print(const char* s) { return ::printf("%s", s); }
+    int println(const char* s = "") { return ::printf("%s\n", s); }
+};
+
+// 主机端串口输出直接写 stdout
+struct HostSerial : public Print {};
+static HostSerial Serial __attribute__((unused));
+
+// UWB 串口: 回放工具用 hostFeed() 写入字节，固件代码照常读取
+class HardwareSerial : public Print {
+public:
+    void begin(unsigned long, uint32_t = SERIAL_8N1, int8_t = -1, int8_t = -1) {}
+    int available() { return (int)_rx.size(); }
+    size_t readBytes(uint8_t* buffer, size_t length) {
+        size_t n = 0;
+        while (n < length && !_rx.empty()) {
+            buffer[n++] = _rx.front();
+            _rx.pop_front();
+        }
+        return n;
+    }
+    void hostFeed(const uint8_t* data, size_t length) { _rx.insert(_rx.end(), data, data + length); }
+
+private:
+    std::deque<uint8_t> _rx;
+};
+inline HardwareSerial& hostSerial1() {
+    static HardwareSerial s;
+    return s;
+}
+inline HardwareSerial& hostSerial2() {
+    static HardwareSerial s;
+    return s;
+}
+#define Serial1 hostSerial1()
+#define Serial2 hostSerial2()
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,151 @@
+/**
+ * @file mcpwm.h
+ * @brief 主机端 MCPWM (ESP-IDF 4.4 旧版驱动接口子集) 模拟
+ * @details 按硬件行为建模比较值影子寄存器: mcpwm_set_duty() 只写影子值，在该定时器下一次
+ *          计数器归零 (TEZ) 且更新使能 (MCPWM_UPDATE_CFG_REG 的 GLOBAL_UP_EN 与 OPn_UP_EN)
+ *          时才生效；定时器 1 可按定时器 0 的 TEZ 同步。时钟为 hostMicros()，每次调用接口时
+ *          先补算上次调用以来的 TEZ。生效的输出变化按时间记入 hostMcpwm().log，供工具检查
+ */
+
+#ifndef HOST_DRIVER_MCPWM_H
+#define HOST_DRIVER_MCPWM_H
+
+#include <Arduino.h>
+#include <esp_err.h>
+#include <vector>
+
+typedef enum { MCPWM_UNIT_0 = 0, MCPWM_UNIT_1, MCPWM_UNIT_MAX } mcpwm_unit_t;
+typedef enum { MCPWM_TIMER_0 = 0, MCPWM_TIMER_1, MCPWM_TIMER_2, MCPWM_TIMER_MAX } mcpwm_timer_t;
+typedef enum { MCPWM_GEN_A = 0, MCPWM_GEN_B, MCPWM_GEN_MAX } mcpwm_generator_t;
+typedef enum { MCPWM0A = 0, MCPWM0B, MCPWM1A, MCPWM1B, MCPWM2A, MCPWM2B } mcpwm_io_signals_t;
+typedef enum { MCPWM_DUTY_MODE_0 = 0, MCPWM_DUTY_MODE_1 } mcpwm_duty_type_t;
+typedef enum { MCPWM_FREEZE_COUNTER, MCPWM_UP_COUNTER, MCPWM_DOWN_COUNTER, MCPWM_UP_DOWN_COUNTER } mcpwm_counter_type_t;
+typedef enum { MCPWM_SELECT_NO_INPUT, MCPWM_SELECT_TIMER0_SYNC, MCPWM_SELECT_TIMER1_SYNC, MCPWM_SELECT_TIMER2_SYNC } mcpwm_sync_signal_t;
+typedef enum { MCPWM_TIMER_DIRECTION_UP, MCPWM_TIMER_DIRECTION_DOWN } mcpwm_timer_direction_t;
+typedef enum {
+    MCPWM_SWSYNC_SOURCE_SYNCIN,
+    MCPWM_SWSYNC_SOURCE_TEZ,
+    MCPWM_SWSYNC_SOURCE_TEP,
+    MCPWM_SWSYNC_SOURCE_DISABLED
+} mcpwm_timer_sync_trigger_t;
+
+typedef struct {
+    uint32_t frequency;
+    float cmpr_a;
+    float cmpr_b;
+    mcpwm_duty_type_t duty_mode;
+    mcpwm_counter_type_t counter_mode;
+} mcpwm_config_t;
+
+typedef struct {
+    mcpwm_sync_signal_t sync_sig;
+    uint32_t timer_val;         // 同步时装入的相位 (0~999 千分比)
+    mcpwm_timer_direction_t count_direction;
+} mcpwm_sync_config_t;
+
+struct HostMcpwmEvent {
+    unsigned long us;           // 生效时刻 (TEZ)
+    uint8_t timer;
+    float duty[2];              // 生效后 A/B 占空比 (%)
+};
+
+struct HostMcpwmTimer {
+    bool running;
+    unsigned long phaseUs;      // 某次 TEZ 的时刻
+    unsigned long periodUs;
+    unsigned long doneUs;       // 已处理到的时刻
+    float shadow[2];
+    float active[2];
+    int syncFrom;               // 同步源定时器，-1 = 不同步
+    uint32_t syncPhase;
+};
+
+struct HostMcpwm {
+    HostMcpwmTimer timer[3];
+    bool syncOutTez[3];
+    uint32_t updateCfg;         // 复位值: GLOBAL_UP_EN 与 OP0..2_UP_EN 置位
+    int gpio[6];
+    unsigned long setDutyUs;    // 每次 mcpwm_set_duty 的耗时，主机时钟随之前进 (默认 0)
+    std::vector<HostMcpwmEvent> log;
+};
+
+inline HostMcpwm& hostMcpwm() {
+    static HostMcpwm m = {{}, {false, false, false}, 0x55, {-1, -1, -1, -1, -1, -1}, 0, {}};
+    return m;
+}
+
+/**
+ * @brief 补算到当前时刻: 影子值在上次处理之后的第一次 TEZ 生效 (此后影子值未变，再次 TEZ 不产生变化)
+ */
+inline void hostMcpwmAdvance() {
+    HostMcpwm& m = hostMcpwm();
+    unsigned long now = hostMicros();
+    for (int i = 0; i < 3; i++) {
+        HostMcpwmTimer& t = m.timer[i];
+        if (!t.running) continue;
+        if (t.syncFrom >= 0 && m.syncOutTez[t.syncFrom] && m.timer[t.syncFrom].running) {
+            const HostMcpwmTimer& src = m.timer[t.syncFrom];
+            t.phaseUs = src.phaseUs + (unsigned long)((uint64_t)t.syncPhase * t.periodUs / 1000);
+            if ((long)(t.doneUs - t.phaseUs) < 0) t.phaseUs -= ((t.phaseUs - t.doneUs) / t.periodUs + 1) * t.periodUs;
+        }
+        unsigned long k = (t.doneUs - t.phaseUs) / t.periodUs + 1;
+        unsigned long tez = t.phaseUs + k * t.periodUs;
+        bool enabled = (m.updateCfg & 0x1) && (m.updateCfg & (0x4u << (2 * i)));
+        if ((long)(tez - now) <= 0 && enabled && (t.shadow[0] != t.active[0] || t.shadow[1] != t.active[1])) {
+            t.active[0] = t.shadow[0];
+            t.active[1] = t.shadow[1];
+            m.log.push_back(HostMcpwmEvent{tez, (uint8_t)i, {t.active[0], t.active[1]}});
+        }
+        t.doneUs = now;
+    }
+}
+
+inline esp_err_t mcpwm_gpio_init(mcpwm_unit_t, mcpwm_io_signals_t signal, int gpio) {
+    hostMcpwm().gpio[signal] = gpio;
+    return ESP_OK;
+}
+
+inline esp_err_t mcpwm_init(mcpwm_unit_t, mcpwm_timer_t timer, const mcpwm_config_t* cfg) {
+    if (cfg->frequency == 0) return ESP_ERR_INVALID_ARG;
+    hostMcpwmAdvance();
+    HostMcpwmTimer& t = hostMcpwm().timer[timer];
+    unsigned long now = hostMicros();
+    t.running = true;
+    t.phaseUs = now;
+    t.periodUs = 1000000UL / cfg->frequency;
+    t.doneUs = now;
+    t.shadow[0] = t.active[0] = cfg->cmpr_a;
+    t.shadow[1] = t.active[1] = cfg->cmpr_b;
+    t.syncFrom = -1;
+    hostMcpwm().log.push_back(HostMcpwmEvent{now, (uint8_t)timer, {t.active[0], t.active[1]}});
+    return ESP_OK;
+}
+
+inline esp_err_t mcpwm_set_duty(mcpwm_unit_t, mcpwm_timer_t timer, mcpwm_generator_t gen, float duty) {
+    hostMcpwmAdvance();
+    hostMcpwm().timer[timer].shadow[gen] = duty;
+    hostMicros() += hostMcpwm().setDutyUs;
+    return ESP_OK;
+}
+
+inline esp_err_t mcpwm_set_timer_sync_output(mcpwm_unit_t, mcpwm_timer_t timer, mcpwm_timer_sync_trigger_t trigger) {
+    hostMcpwmAdvance();
+    hostMcpwm().syncOutTez[timer] = (trigger == MCPWM_SWSYNC_SOURCE_TEZ);
+    return ESP_OK;
+}
+
+inline esp_err_t mcpwm_sync_configure(mcpwm_unit_t, mcpwm_timer_t timer, const mcpwm_sync_config_t* cfg) {
+    hostMcpwmAdvance();
+    HostMcpwmTimer& t = hostMcpwm().timer[timer];
+    t.syncFrom = (cfg->sync_sig >= MCPWM_SELECT_TIMER0_SYNC) ? (int)cfg->sync_sig - MCPWM_SELECT_TIMER0_SYNC : -1;
+    t.syncPhase = cfg->timer_val;
+    return ESP_OK;
+}
+
+// 寄存器访问 (soc/mcpwm_reg.h): 先补算，再返回寄存器本身
+inline uint32_t& hostMcpwmUpdateCfg() {
+    hostMcpwmAdvance();
+    return hostMcpwm().updateCfg;
+}
+
+#endif // HOST_DRIVER_MCPWM_H
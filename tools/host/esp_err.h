@@ -0,0 +1,14 @@
+/**
+ * @file esp_err.h
+ * @brief 主机端 ESP-IDF 错误码
+ */
+
+#ifndef HOST_ESP_ERR_H
+#define HOST_ESP_ERR_H
+
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_INVALID_ARG 0x102
+
+#endif // HOST_ESP_ERR_H
@@ -0,0 +1,80 @@
+/**
+ * @file esp_timer.h
+ * @brief 主机端 esp_timer 模拟
+ * @details 周期定时器不自行运行，工具程序用 hostAdvanceTo() 推进时钟，
+ *          途中按到期时刻依次执行回调，保证回放结果确定
+ */
+
+#ifndef HOST_ESP_TIMER_H
+#define HOST_ESP_TIMER_H
+
+#include <Arduino.h>
+#include <esp_err.h>
+#include <vector>
+
+typedef struct HostTimer* esp_timer_handle_t;
+typedef void (*esp_timer_cb_t)(void* arg);
+
+typedef enum { ESP_TIMER_TASK } esp_timer_dispatch_t;
+
+typedef struct {
+    esp_timer_cb_t callback;
+    void* arg;
+    esp_timer_dispatch_t dispatch_method;
+    const char* name;
+    bool skip_unhandled_events;
+} esp_timer_create_args_t;
+
+struct HostTimer {
+    esp_timer_cb_t callback;
+    void* arg;
+    unsigned long periodUs;
+    unsigned long nextUs;
+    bool active;
+};
+
+inline std::vector<HostTimer*>& hostTimers() {
+    static std::vector<HostTimer*> timers;
+    return timers;
+}
+
+inline int64_t esp_timer_get_time() { return (int64_t)hostMicros(); }
+
+inline esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* out) {
+    HostTimer* t = new HostTimer{args->callback, args->arg, 0, 0, false};
+    hostTimers().push_back(t);
+    *out = t;
+    return ESP_OK;
+}
+
+inline esp_err_t esp_timer_start_periodic(esp_timer_handle_t t, uint64_t periodUs) {
+    t->periodUs = (unsigned long)periodUs;
+    t->nextUs = hostMicros() + t->periodUs;
+    t->active = true;
+    return ESP_OK;
+}
+
+inline esp_err_t esp_timer_stop(esp_timer_handle_t t) {
+    t->active = false;
+    return ESP_OK;
+}
+
+/**
+ * @brief 把主机时钟推进到 us，途中按到期先后执行定时器回调 (回调内时钟为其到期时刻)
+ */
+inline void hostAdvanceTo(unsigned long us) {
+    for (;;) {
+        HostTimer* due = nullptr;
+        for (HostTimer* t : hostTimers()) {
+            if (!t->active || t->periodUs == 0 || (long)(t->nextUs - us) > 0) continue;
+            if (due == nullptr || (long)(t->nextUs - due->nextUs) < 0) due = t;
+        }
+        if (due == nullptr) break;
+        if ((long)(due->nextUs - hostMicros()) > 0) hostMicros() = due->nextUs;
+        due->nextUs += due->periodUs;
+        due->callback(due->arg);
+    }
+    hostMicros() = us;
+}
+
+#endif // HOST_ESP_TIMER_H
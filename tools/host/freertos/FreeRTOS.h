@@ -0,0 +1,18 @@
+/**
+ * @file FreeRTOS.h
+ * @brief 主机端 FreeRTOS 临界区占位
+ * @details 主机工具单线程运行 (定时器回调也在主线程中执行)，临界区为空操作
+ */
+
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+typedef struct {
+    int unused;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED {0}
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+
+#endif // HOST_FREERTOS_H
@@ -0,0 +1,16 @@
+/**
+ * @file mcpwm_reg.h
+ * @brief 主机端 MCPWM 寄存器定义 (只含电机驱动用到的更新配置寄存器)
+ */
+
+#ifndef HOST_SOC_MCPWM_REG_H
+#define HOST_SOC_MCPWM_REG_H
+
+#include <soc/soc.h>
+#include <driver/mcpwm.h>
+
+#define MCPWM_UPDATE_CFG_REG(i) (hostMcpwmUpdateCfg())
+#define MCPWM_GLOBAL_UP_EN (BIT(0))
+#define MCPWM_GLOBAL_FORCE_UP (BIT(1))
+
+#endif // HOST_SOC_MCPWM_REG_H
@@ -0,0 +1,18 @@
+/**
+ * @file soc.h
+ * @brief 主机端寄存器读写宏: 寄存器表达式为模拟外设中的 uint32_t 左值
+ */
+
+#ifndef HOST_SOC_SOC_H
+#define HOST_SOC_SOC_H
+
+#include <stdint.h>
+
+#ifndef BIT
+#define BIT(nr) (1UL << (nr))
+#endif
+#define REG_READ(_r) (_r)
+#define REG_SET_BIT(_r, _b) ((_r) |= (_b))
+#define REG_CLR_BIT(_r, _b) ((_r) &= ~(_b))
+
+#endif // HOST_SOC_SOC_H
@@ -0,0 +1,199 @@
+/**
+ * @file motion_profile_bench.cpp
+ * @brief 运动曲线正确性检查 (主机端)
+ * @details 对 src/motion_profile.h 按 config.h 的斜坡参数检查:
+ *            - 梯形 (jerk 0): 0 -> 全速、全速 -> 0 的耗时与 (差值 / 斜率) 相差不超过一个周期
+ *            - S 曲线: 每周期变化量 (rate()，未取整) 不超过斜率限制，相邻周期变化量之差不超过
+ *              jerk 限制，不过冲，耗时与理论值 (差值 / 斜率 + 斜率 / jerk) 相差不超过两个周期
+ *            - 换向: 先减到 0 (不由正直接跳到负)，再从起转最小占空比反向
+ *            - 随机目标序列: 输出始终在 ±MOTOR_DUTY_MAX 内，目标不变后在限定时间内到达且保持
+ *          并列出常用指令切换的耗时与期间的指令行程 (占空比·s)
+ *
+ * 编译运行 (在仓库根目录):
+ *   g++ -O2 -std=gnu++11 -Itools/host -Isrc tools/motion_profile_bench.cpp -o /tmp/motion_profile_bench
+ *   /tmp/motion_profile_bench
+ */
+
+#include <Arduino.h>
+#include <random>
+#include "config.h"
+#include "motion_profile.h"
+
+static const float kPeriod = MOTOR_RAMP_PERIOD_MS * 0.001f;
+static const int16_t kDutyMax = (1 << MOTOR_PWM_RESOLUTION) - 1;
+
+static MotionProfile makeProfile(float jerk) {
+    return MotionProfile(MOTOR_RAMP_ACCEL, MOTOR_RAMP_DECEL, jerk, kPeriod, MOTOR_DUTY_MIN);
+}
+
+static bool check(const char* name, bool ok, const char* fmt, double value) {
+    printf("  %-52s ", name);
+    printf(fmt, value);
+    printf(" %s\n", ok ? "OK" : "FAIL");
+    return ok;
+}
+
+struct Run {
+    int ticks = 0;              // 输出到达目标 (此后不再变化) 的周期数
+    float travel = 0;           // 期间输出累计 (占空比·s)
+    float maxStep = 0;          // 最大单周期变化量
+    float maxJerk = 0;          // 相邻周期变化量之差的最大值
+    bool overshoot = false;
+};
+
+// 从 from 稳定状态切到 to，推进到曲线完全停止
+static Run transition(float jerk, int16_t from, int16_t to) {
+    MotionProfile p = makeProfile(jerk);
+    p.reset(from);
+    Run r;
+    float prevRate = 0;
+    for (int i = 0; i < 2000 && !p.settled(to); i++) {
+        int16_t v = p.update(to);
+        float rate = p.rate();
+        r.maxStep = fmaxf(r.maxStep, fabsf(rate));
+        // 斜率从 0 建立、撤销到 0 (起转跳变、到达目标、换向停在 0) 之外，变化量之差受 jerk 限制
+        if (rate != 0 && prevRate != 0) r.maxJerk = fmaxf(r.maxJerk, fabsf(rate - prevRate));
+        if ((to - from) * (v - to) > 0) r.overshoot = true;
+        if (v != to) r.ticks = i + 1;
+        r.travel += v * kPeriod;
+        prevRate = rate;
+    }
+    r.ticks++;
+    return r;
+}
+
+static bool testTrapezoid() {
+    bool ok = true;
+    const int16_t top = MOTOR_SPEED_PATH_FORWARD;
+    Run up = transition(0, 0, top);
+    float expect = (top - MOTOR_DUTY_MIN) / (float)MOTOR_RAMP_ACCEL;
+    ok &= check("trapezoid 0 -> path speed time vs (dv / accel) (ms)", fabsf(up.ticks * kPeriod - expect) <= kPeriod + 1e-4f,
+                "%.0f", up.ticks * kPeriod * 1000);
+    Run down = transition(0, top, 0);
+    expect = top / (float)MOTOR_RAMP_DECEL;
+    ok &= check("trapezoid path speed -> 0 time vs (dv / decel) (ms)", fabsf(down.ticks * kPeriod - expect) <= kPeriod + 1e-4f,
+                "%.0f", down.ticks * kPeriod * 1000);
+    return ok;
+}
+
+// S 曲线理论耗时: 斜率按 jerk 建立到上限再撤销；差值不足以到达上限时为三角形
+static float sCurveTime(float dv, float accel, float jerk) {
+    if (dv >= accel * accel / jerk) return dv / accel + accel / jerk;
+    return 2.0f * sqrtf(dv / jerk);
+}
+
+static bool testSCurve() {
+    bool ok = true;
+    const float jerk = MOTOR_RAMP_JERK;
+    const int16_t top = MOTOR_SPEED_PATH_FORWARD;
+    const float tol = 2 * kPeriod;
+    const float stepTol = 1e-4f;
+    struct Case {
+        const char* name;
+        int16_t from, to;
+        float dv, limit;
+    } cases[] = {
+        {"s-curve 0 -> path speed", 0, top, (float)(top - MOTOR_DUTY_MIN), MOTOR_RAMP_ACCEL},
+        {"s-curve path speed -> 0", top, 0, (float)top, MOTOR_RAMP_DECEL},
+        {"s-curve path speed -> half", top, (int16_t)(top / 2), (float)(top - top / 2), MOTOR_RAMP_DECEL},
+        {"s-curve 0 -> -max", 0, (int16_t)-kDutyMax, (float)(kDutyMax - MOTOR_DUTY_MIN), MOTOR_RAMP_ACCEL},
+    };
+    for (const Case& c : cases) {
+        Run r = transition(jerk, c.from, c.to);
+        char name[96];
+        float expect = sCurveTime(c.dv, c.limit, jerk);
+        snprintf(name, sizeof(name), "%s time, theory %.0f ms (ms)", c.name, expect * 1000);
+        ok &= check(name, fabsf(r.ticks * kPeriod - expect) <= tol, "%.0f", r.ticks * kPeriod * 1000);
+        snprintf(name, sizeof(name), "%s max step / limit", c.name);
+        ok &= check(name, r.maxStep <= c.limit * kPeriod + stepTol, "%.2f", r.maxStep / (c.limit * kPeriod));
+        snprintf(name, sizeof(name), "%s max step change / jerk", c.name);
+        ok &= check(name, r.maxJerk <= jerk * kPeriod * kPeriod + stepTol, "%.2f",
+                    r.maxJerk / (jerk * kPeriod * kPeriod));
+        snprintf(name, sizeof(name), "%s overshoot", c.name);
+        ok &= check(name, !r.overshoot, "%.0f", (double)r.overshoot);
+    }
+    return ok;
+}
+
+static bool testReversal() {
+    MotionProfile p = makeProfile(MOTOR_RAMP_JERK);
+    p.reset(MOTOR_SPEED_PATH_FORWARD);
+    int zeros = 0;
+    int16_t firstNegative = 0;
+    bool crossedDirect = false;
+    int16_t prev = p.value();
+    for (int i = 0; i < 400; i++) {
+        int16_t v = p.update(-MOTOR_SPEED_PATH_FORWARD);
+        if (v == 0) zeros++;
+        if (prev > 0 && v < 0) crossedDirect = true;
+        if (v < 0 && firstNegative == 0) firstNegative = v;
+        prev = v;
+    }
+    bool ok = zeros >= 1 && !crossedDirect && firstNegative == -MOTOR_DUTY_MIN &&
+              p.value() == -MOTOR_SPEED_PATH_FORWARD;
+    return check("reversal: stops at 0, restarts at -min duty", ok, "%.0f", (double)firstNegative);
+}
+
+static bool testRandom() {
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int> target(-kDutyMax, kDutyMax);
+    std::uniform_int_distribution<int> hold(1, 120);
+    // 最坏情况: 先撤销反方向的残余斜率，再满速反向 (减速到 0 + 起步加速到满速)
+    const float worst = (float)MOTOR_RAMP_DECEL / MOTOR_RAMP_JERK +
+                        sCurveTime(kDutyMax, MOTOR_RAMP_DECEL, MOTOR_RAMP_JERK) +
+                        sCurveTime(kDutyMax - MOTOR_DUTY_MIN, MOTOR_RAMP_ACCEL, MOTOR_RAMP_JERK) + 2 * kPeriod;
+    const int worstTicks = (int)(worst / kPeriod) + 2;
+    MotionProfile p = makeProfile(MOTOR_RAMP_JERK);
+    bool inRange = true;
+    int late = 0, maxTicks = 0;
+    for (int n = 0; n < 20000; n++) {
+        int16_t t = (int16_t)target(rng);
+        // 多数目标在到达前就被替换，最后一个保持到稳定
+        int ticks = (n % 10 == 9) ? 2000 : hold(rng);
+        for (int i = 0; i < ticks; i++) {
+            int16_t v = p.update(t);
+            if (v > kDutyMax || v < -kDutyMax) inRange = false;
+            if (p.settled(t)) {
+                if (n % 10 == 9) maxTicks = std::max(maxTicks, i);
+                break;
+            }
+            if (n % 10 == 9 && i == ticks - 1) late++;
+        }
+    }
+    bool ok = check("random targets: output within +-max", inRange, "%.0f", (double)inRange);
+    ok &= check("random targets: never settled", late == 0, "%.0f", (double)late);
+    char name[96];
+    snprintf(name, sizeof(name), "random targets: max settle time, bound %.0f ms (ms)", worstTicks * kPeriod * 1000);
+    ok &= check(name, maxTicks <= worstTicks, "%.0f", maxTicks * kPeriod * 1000);
+    return ok;
+}
+
+static void table() {
+    const int16_t fwd = MOTOR_SPEED_PATH_FORWARD;
+    struct Case {
+        const char* name;
+        int16_t from, to;
+    } cases[] = {{"stop -> forward", 0, fwd}, {"forward -> stop", fwd, 0}, {"forward -> backward", fwd, (int16_t)-fwd},
+                 {"stop -> max", 0, kDutyMax}, {"max -> stop", kDutyMax, 0}};
+    printf("Transitions (accel %d, decel %d /s, jerk %d /s^2, every %d ms):\n", MOTOR_RAMP_ACCEL, MOTOR_RAMP_DECEL,
+           MOTOR_RAMP_JERK, MOTOR_RAMP_PERIOD_MS);
+    printf("  %-20s %14s %14s %16s %16s\n", "", "trapezoid ms", "s-curve ms", "trapezoid duty*s", "s-curve duty*s");
+    for (const Case& c : cases) {
+        Run t = transition(0, c.from, c.to);
+        Run s = transition(MOTOR_RAMP_JERK, c.from, c.to);
+        printf("  %-20s %14.0f %14.0f %16.1f %16.1f\n", c.name, t.ticks * kPeriod * 1000, s.ticks * kPeriod * 1000,
+               t.travel, s.travel);
+    }
+}
+
+int main() {
+    bool ok = true;
+    printf("Checks:\n");
+    ok &= testTrapezoid();
+    ok &= testSCurve();
+    ok &= testReversal();
+    ok &= testRandom();
+    table();
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,395 @@
+/**
+ * @file motor_bench.cpp
+ * @brief 电机输出后端对比: LEDC 逐路写入 vs MCPWM 同步更新 (主机端)
+ * @details 对 src/motor_driver.h 的两个后端下发同一串随机指令 (前进/后退/原地转向/弧线/停止/
+ *          直接换向)，按硬件的生效时机重建 4 路输入 (左IN1 左IN2 右IN1 右IN2) 的实际输出:
+ *            - LEDC: 每次 ledcWrite 在所属 LEDC 定时器的下一个周期生效，通道 0/1 与 2/3 分属两个
+ *              相位随机、互不同步的定时器；每次写入耗时 --write-us
+ *            - MCPWM: host/driver/mcpwm.h 按影子寄存器与 TEZ 装载建模，每次 mcpwm_set_duty 耗时同上
+ *          每条指令统计:
+ *            - mixed: 生效过程中出现既非旧指令也非新指令的输出组合 (只更新了一路或一个轮子)
+ *            - skew: 两轮都变化时，左右轮新输出生效的时间差
+ *            - latency: 下发到全部生效的时间
+ *            - both-high: 滑行模式下某轮两路输入同时为高
+ *          另外检查 MCPWM 的制动/滑行停止输出、换向时停止状态保持 >= 死区时间、相同指令跳过写入。
+ *          MCPWM 无中间状态、无左右轮时间差且上述检查通过时输出 PASS，否则 FAIL (退出码 1)
+ *
+ * 编译运行 (在仓库根目录):
+ *   g++ -O2 -std=gnu++11 -Itools/host -Isrc tools/motor_bench.cpp -o /tmp/motor_bench
+ *   /tmp/motor_bench
+ *   选项: --runs N (200，每次随机定时器相位)  --cmds N (200)  --write-us US (3)
+ */
+
+#include <Arduino.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "motor_driver.h"
+
+// ==================== 输出时间线 ====================
+
+// 4 路输入的实际输出 (占空比 %)
+struct Levels {
+    float ch[4];
+
+    bool wheelEquals(const Levels& o, int wheel) const {
+        return fabsf(ch[2 * wheel] - o.ch[2 * wheel]) < 1e-3f && fabsf(ch[2 * wheel + 1] - o.ch[2 * wheel + 1]) < 1e-3f;
+    }
+    bool operator==(const Levels& o) const { return wheelEquals(o, 0) && wheelEquals(o, 1); }
+};
+
+struct Applied {
+    unsigned long us;
+    Levels out;
+};
+
+struct Cmd {
+    unsigned long us;
+    int16_t left;
+    int16_t right;
+};
+
+static float level(int16_t duty) {
+    return duty * 100.0f / MOTOR_DUTY_MAX;
+}
+
+// 指令对应的输出 (占空比 0 按滑行: 两路同低)
+static Levels expected(int16_t left, int16_t right) {
+    return Levels{{level(left > 0 ? left : 0), level(left < 0 ? -left : 0),
+                   level(right > 0 ? right : 0), level(right < 0 ? -right : 0)}};
+}
+
+// 按时间排序的单路变化合并为时间线 (同一时刻的变化合成一个状态)
+struct Change {
+    unsigned long us;
+    int ch;
+    float value;
+};
+
+static std::vector<Applied> buildTimeline(std::vector<Change> changes) {
+    std::stable_sort(changes.begin(), changes.end(),
+                     [](const Change& a, const Change& b) { return (long)(a.us - b.us) < 0; });
+    std::vector<Applied> timeline;
+    Levels cur = {{0, 0, 0, 0}};
+    for (const Change& c : changes) {
+        cur.ch[c.ch] = c.value;
+        if (!timeline.empty() && timeline.back().us == c.us) {
+            timeline.back().out = cur;
+        } else {
+            timeline.push_back(Applied{c.us, cur});
+        }
+    }
+    return timeline;
+}
+
+// ==================== 统计 ====================
+
+struct Stats {
+    int cmds = 0;
+    int mixed = 0;              // 出现中间状态的指令数
+    double mixedUs = 0;         // 中间状态累计时长
+    unsigned long mixedMaxUs = 0;
+    int bothWheels = 0;         // 两轮都变化的指令数
+    double skewSum = 0;
+    unsigned long skewMax = 0;
+    double latencySum = 0;
+    unsigned long latencyMax = 0;
+    int bothHigh = 0;
+    int unsettled = 0;          // 下一条指令前仍未到达新输出
+
+    void add(const Stats& o) {
+        cmds += o.cmds;
+        mixed += o.mixed;
+        mixedUs += o.mixedUs;
+        mixedMaxUs = std::max(mixedMaxUs, o.mixedMaxUs);
+        bothWheels += o.bothWheels;
+        skewSum += o.skewSum;
+        skewMax = std::max(skewMax, o.skewMax);
+        latencySum += o.latencySum;
+        latencyMax = std::max(latencyMax, o.latencyMax);
+        bothHigh += o.bothHigh;
+        unsettled += o.unsettled;
+    }
+};
+
+static Stats analyze(const std::vector<Applied>& timeline, const std::vector<Cmd>& cmds, unsigned long endUs) {
+    Stats s;
+    size_t k = 0;
+    Levels prev = expected(0, 0);
+    for (size_t i = 0; i < cmds.size(); i++) {
+        unsigned long t0 = cmds[i].us;
+        unsigned long t1 = (i + 1 < cmds.size()) ? cmds[i + 1].us : endUs;
+        Levels from = prev;
+        Levels to = expected(cmds[i].left, cmds[i].right);
+        // 时间线中属于本指令窗口的状态 (此前的状态即为窗口开始时的输出)
+        while (k < timeline.size() && (long)(timeline[k].us - t0) < 0) from = timeline[k++].out;
+        Levels cur = from;
+        unsigned long changeAt[2] = {t0, t0};
+        unsigned long mixedUs = 0;
+        for (size_t j = k; j < timeline.size() && (long)(timeline[j].us - t1) < 0; j++) {
+            const Levels& out = timeline[j].out;
+            unsigned long until = (j + 1 < timeline.size() && (long)(timeline[j + 1].us - t1) < 0) ? timeline[j + 1].us : t1;
+            if (!(out == from) && !(out == to)) mixedUs += until - timeline[j].us;
+            for (int w = 0; w < 2; w++) {
+                if (!out.wheelEquals(cur, w)) changeAt[w] = timeline[j].us;
+                if (out.ch[2 * w] > 0 && out.ch[2 * w + 1] > 0) s.bothHigh++;
+            }
+            cur = out;
+        }
+        s.cmds++;
+        if (!(cur == to)) {
+            s.unsettled++;
+        } else if (!(from == to)) {
+            unsigned long latency = std::max(changeAt[0], changeAt[1]) - t0;
+            s.latencySum += latency;
+            s.latencyMax = std::max(s.latencyMax, latency);
+        }
+        if (mixedUs > 0) {
+            s.mixed++;
+            s.mixedUs += mixedUs;
+            s.mixedMaxUs = std::max(s.mixedMaxUs, mixedUs);
+        }
+        if (!from.wheelEquals(to, 0) && !from.wheelEquals(to, 1)) {
+            unsigned long skew = (changeAt[0] > changeAt[1]) ? changeAt[0] - changeAt[1] : changeAt[1] - changeAt[0];
+            s.bothWheels++;
+            s.skewSum += skew;
+            s.skewMax = std::max(s.skewMax, skew);
+        }
+        prev = cur;
+    }
+    return s;
+}
+
+// ==================== 指令序列 ====================
+
+static std::vector<Cmd> makeCommands(std::mt19937& rng, int count, unsigned long startUs) {
+    std::uniform_int_distribution<int> kind(0, 6);
+    std::uniform_int_distribution<int> duty(MOTOR_DUTY_MIN, MOTOR_DUTY_MAX);
+    std::uniform_int_distribution<int> trim(1, 40);
+    // 指令间隔远大于 PWM 周期，每条指令都能完全生效
+    std::uniform_int_distribution<unsigned long> gap(3000, 20000);
+    std::vector<Cmd> cmds;
+    unsigned long t = startUs;
+    int16_t left = 0, right = 0;
+    for (int i = 0; i < count; i++) {
+        t += gap(rng);
+        int16_t d = (int16_t)duty(rng);
+        switch (kind(rng)) {
+            case 0: left = right = d; break;
+            case 1: left = right = -d; break;
+            case 2: left = -d; right = d; break;
+            case 3: left = d; right = -d; break;
+            case 4: left = d; right = (int16_t)std::max(d - trim(rng), (int)MOTOR_DUTY_MIN); break;
+            case 5: left = right = 0; break;
+            default: left = -left; right = -right; break;    // 直接换向
+        }
+        cmds.push_back(Cmd{t, left, right});
+    }
+    return cmds;
+}
+
+// ==================== 后端 ====================
+
+struct LedcWrite {
+    unsigned long us;
+    uint8_t ch;
+    uint32_t duty;
+};
+
+static std::vector<LedcWrite> g_ledcWrites;
+static unsigned long g_writeUs = 3;
+
+static void ledcHook(uint8_t channel, uint32_t duty) {
+    g_ledcWrites.push_back(LedcWrite{hostMicros(), channel, duty});
+    hostMicros() += g_writeUs;
+}
+
+static Stats runLedc(const std::vector<Cmd>& cmds, unsigned long startUs, const unsigned long phase[2]) {
+    const unsigned long period = 1000000UL / MOTOR_PWM_FREQ;
+    g_ledcWrites.clear();
+    hostLedcHook() = ledcHook;
+    hostMicros() = startUs;
+    LedcMotorDriver driver;
+    driver.begin();
+    for (const Cmd& c : cmds) {
+        hostMicros() = c.us;
+        driver.write(c.left, c.right);
+    }
+    hostLedcHook() = nullptr;
+
+    // 通道 0/1 属 LEDC 定时器 0，2/3 属定时器 1；写入在所属定时器下一次溢出时生效
+    std::vector<Change> changes;
+    for (const LedcWrite& w : g_ledcWrites) {
+        unsigned long ph = phase[w.ch / 2];
+        unsigned long latch = ph + ((w.us - ph) / period + 1) * period;
+        changes.push_back(Change{latch, w.ch, level((int16_t)w.duty)});
+    }
+    return analyze(buildTimeline(changes), cmds, cmds.back().us + 20000);
+}
+
+// MCPWM 事件日志转为 4 路输出: 定时器 0 = 左轮 (A=IN1, B=IN2)，定时器 1 = 右轮
+static std::vector<Applied> mcpwmTimeline() {
+    std::vector<Change> changes;
+    for (const HostMcpwmEvent& e : hostMcpwm().log) {
+        if (e.timer > 1) continue;
+        changes.push_back(Change{e.us, 2 * e.timer, e.duty[0]});
+        changes.push_back(Change{e.us, 2 * e.timer + 1, e.duty[1]});
+    }
+    return buildTimeline(changes);
+}
+
+static void mcpwmReset(unsigned long startUs) {
+    hostMcpwm().log.clear();
+    hostMcpwm().updateCfg = 0x55;
+    hostMcpwm().setDutyUs = g_writeUs;
+    hostMicros() = startUs;
+}
+
+static Stats runMcpwm(const std::vector<Cmd>& cmds, unsigned long startUs) {
+    mcpwmReset(startUs);
+    McpwmMotorDriver driver(false, 0);
+    driver.begin();
+    for (const Cmd& c : cmds) {
+        hostMicros() = c.us;
+        driver.write(c.left, c.right);
+    }
+    unsigned long endUs = cmds.back().us + 20000;
+    hostMicros() = endUs;
+    hostMcpwmAdvance();
+    return analyze(mcpwmTimeline(), cmds, endUs);
+}
+
+static void printStats(const char* name, const Stats& s) {
+    printf("  %-6s %6d %7.2f%% %7.1f %5lu | %6.1f %5lu | %6.1f %5lu | %6d %6d\n", name, s.cmds,
+           100.0 * s.mixed / s.cmds, s.mixed ? s.mixedUs / s.mixed : 0.0, s.mixedMaxUs,
+           s.bothWheels ? s.skewSum / s.bothWheels : 0.0, s.skewMax,
+           s.latencySum / std::max(1, s.cmds - s.unsettled), s.latencyMax, s.bothHigh, s.unsettled);
+}
+
+// ==================== MCPWM 专项检查 ====================
+
+static bool check(const char* name, bool ok, const char* fmt, double value) {
+    printf("  %-48s ", name);
+    printf(fmt, value);
+    printf(" %s\n", ok ? "OK" : "FAIL");
+    return ok;
+}
+
+// 停止指令的输出: 制动两路同高，滑行两路同低
+static bool checkStop(bool brake) {
+    mcpwmReset(1000);
+    McpwmMotorDriver driver(brake, 0);
+    driver.begin();
+    hostMicros() += 5000;
+    driver.write(150, -150);
+    hostMicros() += 5000;
+    driver.write(0, 0);
+    hostMicros() += 5000;
+    hostMcpwmAdvance();
+    std::vector<Applied> timeline = mcpwmTimeline();
+    float want = brake ? 100.0f : 0.0f;
+    const Levels& out = timeline.back().out;
+    bool ok = out.ch[0] == want && out.ch[1] == want && out.ch[2] == want && out.ch[3] == want;
+    return check(brake ? "stop output, brake (IN1 = IN2 = 100%)" : "stop output, coast (IN1 = IN2 = 0%)", ok,
+                 "%.0f%%", out.ch[0]);
+}
+
+// 直接换向: 新方向生效前停止状态保持 >= 死区时间，且从未由正转直接切到反转
+static bool checkDeadtime(bool brake, uint32_t deadtimeUs) {
+    mcpwmReset(1000);
+    McpwmMotorDriver driver(brake, deadtimeUs);
+    driver.begin();
+    hostMicros() += 5000;
+    driver.write(200, 200);
+    hostMicros() += 5000;
+    driver.write(-200, 120);
+    hostMicros() += 5000;
+    hostMcpwmAdvance();
+    std::vector<Applied> timeline = mcpwmTimeline();
+    // 左轮: 前进 -> (停止) -> 后退
+    int state = 0;                  // 0 = 尚未前进, 1 = 前进, 2 = 停止, 3 = 后退
+    unsigned long stopAt = 0, stopHeld = 0;
+    bool direct = false;
+    for (const Applied& a : timeline) {
+        float in1 = a.out.ch[0], in2 = a.out.ch[1];
+        if (in1 > in2) {
+            state = 1;
+        } else if (in1 == in2 && state == 1) {
+            state = 2;
+            stopAt = a.us;
+        } else if (in1 < in2 && state >= 1 && state < 3) {
+            direct = (state == 1);
+            stopHeld = (state == 2) ? a.us - stopAt : 0;
+            state = 3;
+        }
+    }
+    char name[64];
+    snprintf(name, sizeof(name), "reversal stop held, %s, dead time %u us (us)", brake ? "brake" : "coast",
+             (unsigned)deadtimeUs);
+    return check(name, state == 3 && !direct && stopHeld >= deadtimeUs, "%.0f", (double)stopHeld);
+}
+
+static bool checkSkip() {
+    mcpwmReset(1000);
+    McpwmMotorDriver driver(false, 0);
+    driver.begin();
+    uint32_t before = driver.writes();
+    for (int i = 0; i < 10; i++) driver.write(100, 90);
+    bool ok = driver.writes() == before + 1 && driver.skipped() == 9;
+    return check("repeated command written once", ok, "%.0f", (double)(driver.writes() - before));
+}
+
+int main(int argc, char** argv) {
+    int runs = 200;
+    int count = 200;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+            runs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--cmds") == 0 && i + 1 < argc) {
+            count = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--write-us") == 0 && i + 1 < argc) {
+            g_writeUs = strtoul(argv[++i], nullptr, 10);
+        } else {
+            fprintf(stderr, "usage: %s [--runs N] [--cmds N] [--write-us US]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    const unsigned long period = 1000000UL / MOTOR_PWM_FREQ;
+    Stats ledc, mcpwm;
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<unsigned long> phase(0, period - 1);
+    for (int r = 0; r < runs; r++) {
+        const unsigned long start = 10 * period;
+        unsigned long ph[2] = {phase(rng), phase(rng)};
+        std::vector<Cmd> cmds = makeCommands(rng, count, start);
+        ledc.add(runLedc(cmds, start, ph));
+        mcpwm.add(runMcpwm(cmds, start + ph[0]));
+    }
+
+    printf("%d runs x %d commands, PWM %d Hz (period %lu us), %lu us per register write\n", runs, count,
+           MOTOR_PWM_FREQ, period, g_writeUs);
+    printf("  %-6s %6s %8s %7s %5s | %6s %5s | %6s %5s | %6s %6s\n", "", "cmds", "mixed", "avg us", "max",
+           "skew", "max", "lat", "max", "both", "unset");
+    printStats("LEDC", ledc);
+    printStats("MCPWM", mcpwm);
+
+    bool ok = true;
+    printf("Checks:\n");
+    ok &= check("MCPWM commands with mixed output", mcpwm.mixed == 0, "%.0f", (double)mcpwm.mixed);
+    ok &= check("MCPWM max left/right skew (us)", mcpwm.skewMax == 0, "%.0f", (double)mcpwm.skewMax);
+    // 写入期间恰好跨过计数归零时在下一个周期生效
+    ok &= check("MCPWM max latency (us)", mcpwm.latencyMax <= period + 4 * g_writeUs, "%.0f", (double)mcpwm.latencyMax);
+    ok &= check("MCPWM both inputs high while coasting", mcpwm.bothHigh == 0, "%.0f", (double)mcpwm.bothHigh);
+    ok &= check("unsettled commands (LEDC + MCPWM)", ledc.unsettled + mcpwm.unsettled == 0, "%.0f",
+                (double)(ledc.unsettled + mcpwm.unsettled));
+    ok &= checkStop(true);
+    ok &= checkStop(false);
+    ok &= checkDeadtime(false, MOTOR_MCPWM_DEADTIME_US);
+    ok &= checkDeadtime(true, MOTOR_MCPWM_DEADTIME_US);
+    ok &= checkDeadtime(false, 2000);
+    ok &= checkSkip();
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file multilat_bench.cpp
+ * @brief 多边定位解算耗时与精度 (主机端)
+ * @details 1) 测量 2 基站闭式解与 3/4 基站 Gauss-Newton 的单次解算耗时
+ *          2) 在车周围随机放置目标并加入测距噪声，统计位置误差、残差
+ *             以及前后侧判断正确率 (2 基站共线时车后目标必然被判到车前)
+ *
+ * 编译运行 (在仓库根目录):
+ *   g++ -O2 -std=gnu++11 -Itools/host -Isrc tools/multilat_bench.cpp -o /tmp/multilat_bench
+ *   /tmp/multilat_bench
+ */
+
+#include <Arduino.h>
+#include <chrono>
+#include <random>
+#include "multilat.h"
+
+static const AnchorPos kTwo[2] = {{-UWB_BASELINE / 2, 0}, {UWB_BASELINE / 2, 0}};
+static const AnchorPos kThree[3] = {{-UWB_BASELINE / 2, 0}, {UWB_BASELINE / 2, 0}, {0, -20}};
+static const AnchorPos kFour[4] = {{-UWB_BASELINE / 2, 0}, {UWB_BASELINE / 2, 0}, {0, -20}, {0, 20}};
+
+template <int N>
+static void ranges(const AnchorPos (&a)[N], float x, float y, float noise, std::mt19937& rng, float (&d)[N]) {
+    std::normal_distribution<float> n(0, noise);
+    for (int i = 0; i < N; i++) {
+        d[i] = sqrtf((x - a[i].x) * (x - a[i].x) + (y - a[i].y) * (y - a[i].y)) + (noise > 0 ? n(rng) : 0);
+    }
+}
+
+template <int N>
+static void run(const char* name, const AnchorPos (&a)[N]) {
+    Multilateration<N> solver;
+    solver.setAnchors(a);
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> ux(-150, 150);
+    std::uniform_real_distribution<float> uy(60, 300);
+
+    // 耗时: 预先生成测距，计时只包含 solve
+    const int cases = 1000;
+    const int rounds = 200;
+    static float d[cases][N];
+    for (int c = 0; c < cases; c++) {
+        ranges(a, ux(rng), (c & 1) ? uy(rng) : -uy(rng), 5, rng, d[c]);
+    }
+    MultilatFix fix = {};
+    float sink = 0;
+    unsigned long iters = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (int c = 0; c < cases; c++) {
+            solver.solve(d[c], 0, 1, fix);
+            sink += fix.x + fix.y;
+            iters += fix.iterations;
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    double us = std::chrono::duration<double, std::micro>(t1 - t0).count() / ((double)cases * rounds);
+
+    // 精度: 前方/后方各一半，参考点固定在车前方
+    const int trials = 20000;
+    double errFront = 0;
+    double resSum = 0;
+    int front = 0, back = 0, frontOk = 0, backOk = 0;
+    for (int t = 0; t < trials; t++) {
+        float x = ux(rng);
+        float y = (t & 1) ? -uy(rng) : uy(rng);
+        float dd[N];
+        ranges(a, x, y, 5, rng, dd);
+        solver.solve(dd, 0, 1, fix);
+        resSum += fix.residual;
+        bool sideOk = (fix.y > 0) == (y > 0);
+        if (y > 0) {
+            front++;
+            frontOk += sideOk;
+            errFront += (fix.x - x) * (fix.x - x) + (fix.y - y) * (fix.y - y);
+        } else {
+            back++;
+            backOk += sideOk;
+        }
+    }
+    printf("%-22s %6.3f us/solve  %4.1f iter  front ok %5.1f%%  back ok %5.1f%%  front rms %5.1f cm  residual %4.1f cm%s (sink=%.0f)\n",
+           name, us, (double)iters / ((double)cases * rounds), 100.0 * frontOk / front, 100.0 * backOk / back,
+           sqrt(errFront / front), resSum / trials, solver.isCollinear() ? "  [collinear]" : "", sink);
+}
+
+int main() {
+    printf("targets |x|<=150 cm, 60<=|y|<=300 cm, range noise 5 cm, hint = front\n");
+    run("2 anchors (closed)", kTwo);
+    run("3 anchors (GN)", kThree);
+    run("4 anchors (GN)", kFour);
+    return 0;
+}
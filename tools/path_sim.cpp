@@ -0,0 +1,388 @@
+/**
+ * @file path_sim.cpp
+ * @brief 路径示教/归位闭环仿真: 直行航向保持对回放重复性的影响 (主机端)
+ * @details 真实的 Path 与 Motor (斜坡、航向保持) 代码驱动差速车模型，先按脚本示教一条路线
+ *          (与 handleCommand 相同: motor.forward() 等 + path.recordStep())，再把车放回起点
+ *          执行 path.startReturning() 回放，比较两次的轨迹:
+ *          - 车: 轮速按一阶滞后 (--motor-tau) 跟随实际占空比 (斜坡之后) × CART_SPEED_PER_DUTY；
+ *                左右轮增益差 = --wheel-err + 每次运行不同的载重偏置 (--load-var × 高斯)，
+ *                示教与回放时不同；地面造成的偏航角速度为一阶马尔可夫过程 (--floor，相关时间 2 s)
+ *          - 陀螺仪: 每个控制周期的真实转角 + 零偏 (每个种子 --gyro-bias × 高斯，示教与回放相同) + 噪声，
+ *                    与固件相同先 motor.holdHeading() 再执行 path.updateReturning()
+ *          - 示教按键: 每条指令的时长加上 0~--press-jitter ms 的随机量 (按键时刻与控制周期不对齐)，
+ *                      回放只在控制周期检查步骤是否结束
+ *          同一种子分别在保持航向 (hold) 与不修正 (off，即两轮同占空比) 下运行，
+ *          各运行 fork 子进程执行，Motor/Path 全局状态互不影响。
+ *
+ *          指标 (回放相对示教):
+ *          - end:  终点位置差 (cm)
+ *          - dev:  回放轨迹偏离示教轨迹的最大距离 (cm)
+ *          - head: 终点航向差 (度)
+ *          - drift: 示教时直行段的横向漂移 (cm，相对该段起点航向的直线，各段最大值)
+ *          长直行场景 (straight/route) hold 的平均终点误差不到 off 的一半时输出 PASS，否则 FAIL (退出码 1)。
+ *          jog 场景为 0.6 s 的短直行与短转向交替，大部分时间处于加减速中，用于对比回放按指令行程
+ *          (PATH_REPLAY_BY_TRAVEL=1) 与按时长 (=0，重新编译) 结束步骤
+ *
+ * 编译运行 (在仓库根目录):
+ *   g++ -O2 -std=gnu++11 -DDEBUG_ENABLED=0 -Itools/host -Isrc tools/path_sim.cpp src/path.cpp src/motor.cpp \
+ *       -o /tmp/path_sim
+ *   /tmp/path_sim                         全部场景 × 8 个种子
+ *   /tmp/path_sim --trace route > r.csv   输出一次示教与回放的轨迹 (种子 0，hold)
+ *   选项: --scenario NAME  --seeds N (8)  --wheel-err F (0.01)  --load-var F (0.005)  --floor DPS (1)
+ *         --gyro-bias DPS (0.1)  --motor-tau S (0.08)  --press-jitter MS (20)
+ */
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+#include "path.h"
+#include "motor.h"
+#include "control.h"
+
+// ==================== 场景 ====================
+
+struct TeachCmd {
+    PathActionType action;
+    float dur;      // s
+};
+
+struct Scenario {
+    const char* name;
+    const TeachCmd* cmds;
+    size_t count;
+    bool holdCheck;     // 计入 PASS 判定 (hold 终点误差 < off 的一半)
+};
+
+// 示教速度 MOTOR_SPEED_PATH_FORWARD 约 82 cm/s，各场景直行合计约 20 m
+static const TeachCmd kStraight[] = {{ACTION_FORWARD, 25}, {ACTION_STOP, 2}};
+// 转向后先停一下再前进 (转向的惯性转动不计入直行段的漂移)
+static const TeachCmd kRoute[] = {{ACTION_FORWARD, 8}, {ACTION_STOP, 0.5f}, {ACTION_RIGHT, 0.3f},
+                                  {ACTION_STOP, 0.5f}, {ACTION_FORWARD, 7}, {ACTION_STOP, 0.5f},
+                                  {ACTION_LEFT, 0.3f}, {ACTION_STOP, 0.5f}, {ACTION_FORWARD, 7},
+                                  {ACTION_STOP, 0.5f}, {ACTION_BACKWARD, 3}, {ACTION_STOP, 2}};
+
+// 短距离挪动: 加减速占大部分时间
+static const TeachCmd kJog[] = {{ACTION_FORWARD, 0.6f}, {ACTION_STOP, 0.4f}, {ACTION_RIGHT, 0.25f},
+                                {ACTION_STOP, 0.4f},    {ACTION_FORWARD, 0.6f}, {ACTION_STOP, 0.4f},
+                                {ACTION_LEFT, 0.25f},   {ACTION_STOP, 0.4f},    {ACTION_FORWARD, 0.6f},
+                                {ACTION_STOP, 0.4f},    {ACTION_BACKWARD, 0.6f}, {ACTION_STOP, 0.4f},
+                                {ACTION_FORWARD, 0.6f}, {ACTION_LEFT, 0.25f},   {ACTION_FORWARD, 0.6f},
+                                {ACTION_STOP, 1}};
+
+#define SCENARIO(n, s, c) {n, s, sizeof(s) / sizeof(s[0]), c}
+static const Scenario kScenarios[] = {SCENARIO("straight", kStraight, true), SCENARIO("route", kRoute, true),
+                                      SCENARIO("jog", kJog, false)};
+static const int kScenarioCount = sizeof(kScenarios) / sizeof(kScenarios[0]);
+
+// ==================== 仿真世界 ====================
+
+struct SimOptions {
+    float wheelErr = 0.01f;     // 左轮增益 +err、右轮 -err (电机差异)
+    float loadVar = 0.005f;     // 载重造成的左右差，每次运行随机 (标准差)
+    float floorDps = 1.0f;      // 地面造成的偏航角速度标准差 (度/s，全速时)
+    float gyroBias = 0.1f;      // 标定后的残余零偏标准差 (度/s)
+    float motorTau = 0.08f;     // 轮速跟随占空比的时间常数 (s)
+    float pressJitterMs = 20;   // 示教指令时长附加的随机量上限 (ms)
+};
+
+struct Body {
+    float x = 0, y = 0;         // cm，世界坐标: y 为初始车头方向，x 向右
+    float heading = 0;          // rad，正值向右转
+
+    void advance(float v, float w, float dt) {
+        float mid = heading + 0.5f * w * dt;
+        x += v * sinf(mid) * dt;
+        y += v * cosf(mid) * dt;
+        heading += w * dt;
+    }
+};
+
+// 轨迹每 10 ms 记一个点 (1 s 不到 1 cm)
+struct TrackPoint {
+    float x, y, heading;
+};
+static const unsigned long kTrackUs = 10000;
+
+struct RunResult {
+    float endErr, devMax, headErr, drift;
+};
+
+class World {
+public:
+    World(const Scenario& sc, const SimOptions& opt, uint32_t seed, bool hold)
+        : _sc(sc), _opt(opt), _rng(seed), _n(0, 1), _hold(hold) {
+        _gyroBias = _opt.gyroBias * _n(_rng);
+    }
+
+    RunResult run(FILE* trace);
+
+private:
+    const Scenario& _sc;
+    SimOptions _opt;
+    std::mt19937 _rng;
+    std::normal_distribution<float> _n;
+    bool _hold;
+    float _gyroBias;
+
+    Body _cart;
+    float _vl = 0, _vr = 0;
+    float _wheelErr = 0;
+    float _floor = 0;           // 当前地面扰动 (rad/s，全速时)
+    float _gyroHeading = 0;
+
+    void startRun() {
+        _cart = Body();
+        _vl = _vr = 0;
+        _floor = 0;
+        _gyroHeading = 0;
+        _wheelErr = _opt.wheelErr + _opt.loadVar * _n(_rng);
+    }
+
+    void stepWorld(float dt) {
+        int16_t left, right;
+        motor.getWheels(left, right);
+        float a = dt / (_opt.motorTau + dt);
+        _vl += a * (left * CART_SPEED_PER_DUTY * (1 + _wheelErr) - _vl);
+        _vr += a * (right * CART_SPEED_PER_DUTY * (1 - _wheelErr) - _vr);
+        // 一阶马尔可夫过程，相关时间 2 s，稳态标准差 floorDps
+        const float tc = 2.0f;
+        float sigma = _opt.floorDps * (float)M_PI / 180.0f;
+        _floor += -_floor * dt / tc + sigma * sqrtf(2.0f * dt / tc) * _n(_rng);
+        float v = 0.5f * (_vl + _vr);
+        float vMax = MOTOR_DUTY_MAX * CART_SPEED_PER_DUTY;
+        _cart.advance(v, (_vl - _vr) / CART_TRACK_WIDTH + _floor * fabsf(v) / vMax, dt);
+    }
+
+    // 上个控制周期以来的陀螺仪转角 (度，右转为正)
+    float gyroDelta(float dt) {
+        float d = (_cart.heading - _gyroHeading) * 180.0f / (float)M_PI + _gyroBias * dt + 0.02f * _n(_rng);
+        _gyroHeading = _cart.heading;
+        return d;
+    }
+
+    // 推进 1 ms；到控制周期时执行与固件 controlStep 相同的航向保持 (returning 时再推进回放)
+    bool tick(unsigned long& nextLoop, unsigned long& lastLoop, bool returning) {
+        const unsigned long tickUs = 1000;
+        stepWorld(tickUs * 1e-6f);
+        hostAdvanceTo(micros() + tickUs);
+        if ((long)(micros() - nextLoop) < 0) return true;
+        nextLoop += CONTROL_PERIOD_US;
+        float dt = (micros() - lastLoop) * 1e-6f;
+        lastLoop = micros();
+        float yaw = gyroDelta(dt);
+        if (_hold && motor.isHoldingHeading()) motor.holdHeading(yaw, dt);
+        return returning ? path.updateReturning() : true;
+    }
+};
+
+static float nearest(const std::vector<TrackPoint>& track, float x, float y) {
+    float best = 1e18f;
+    for (const TrackPoint& p : track) {
+        float d = (p.x - x) * (p.x - x) + (p.y - y) * (p.y - y);
+        if (d < best) best = d;
+    }
+    return sqrtf(best);
+}
+
+RunResult World::run(FILE* trace) {
+    RunResult r = {0, 0, 0, 0};
+    // 时钟从 1 s 起，与 follow_sim 一致
+    hostMicros() = 1000000UL;
+    motor.begin();
+    path.begin();
+    motor.setSpeed(MOTOR_SPEED_PATH_FORWARD, MOTOR_SPEED_PATH_TURN);
+
+    // ---------- 示教 ----------
+    std::vector<TrackPoint> teach;
+    startRun();
+    path.startRecording();
+    unsigned long nextLoop = micros(), lastLoop = micros();
+    float segX = 0, segY = 0, segHeading = 0;
+    bool straight = false;
+    for (size_t i = 0; i < _sc.count; i++) {
+        const TeachCmd& c = _sc.cmds[i];
+        switch (c.action) {
+            case ACTION_FORWARD:  motor.forward(); break;
+            case ACTION_BACKWARD: motor.backward(); break;
+            case ACTION_LEFT:     motor.turnLeft(); break;
+            case ACTION_RIGHT:    motor.turnRight(); break;
+            default:              motor.stop(); break;
+        }
+        path.recordStep(c.action);
+        straight = (c.action == ACTION_FORWARD || c.action == ACTION_BACKWARD);
+        segX = _cart.x;
+        segY = _cart.y;
+        segHeading = _cart.heading;
+        float jitter = std::uniform_real_distribution<float>(0, _opt.pressJitterMs)(_rng);
+        unsigned long end = micros() + (unsigned long)(c.dur * 1e6f) + 1000UL * (unsigned long)jitter;
+        while ((long)(micros() - end) < 0) {
+            tick(nextLoop, lastLoop, false);
+            if (micros() % kTrackUs == 0) teach.push_back(TrackPoint{_cart.x, _cart.y, _cart.heading});
+            if (straight) {
+                // 相对段起点航向的横向偏移
+                float dx = _cart.x - segX, dy = _cart.y - segY;
+                float lateral = fabsf(dx * cosf(segHeading) - dy * sinf(segHeading));
+                if (lateral > r.drift) r.drift = lateral;
+            }
+        }
+    }
+    TrackPoint teachEnd = {_cart.x, _cart.y, _cart.heading};
+
+    // ---------- 回放: 与 setMode(MODE_RETURNING) 相同，先停车，停止录制后开始回放 ----------
+    motor.stop();
+    path.stopRecording();
+    startRun();
+    std::vector<TrackPoint> replay;
+    bool ok = path.startReturning();
+    while (ok) {
+        ok = tick(nextLoop, lastLoop, true);
+        if (micros() % kTrackUs != 0) continue;
+        replay.push_back(TrackPoint{_cart.x, _cart.y, _cart.heading});
+        float dev = nearest(teach, _cart.x, _cart.y);
+        if (dev > r.devMax) r.devMax = dev;
+    }
+    // 回放结束后停车滑行
+    for (int i = 0; i < 500; i++) tick(nextLoop, lastLoop, false);
+
+    r.endErr = sqrtf((_cart.x - teachEnd.x) * (_cart.x - teachEnd.x) + (_cart.y - teachEnd.y) * (_cart.y - teachEnd.y));
+    r.headErr = fabsf(_cart.heading - teachEnd.heading) * 180.0f / (float)M_PI;
+
+    if (trace) {
+        fprintf(trace, "run,i,x,y,heading_deg\n");
+        for (size_t i = 0; i < teach.size(); i += 5) {
+            fprintf(trace, "teach,%u,%.1f,%.1f,%.2f\n", (unsigned)i, teach[i].x, teach[i].y,
+                    teach[i].heading * 180.0f / (float)M_PI);
+        }
+        for (size_t i = 0; i < replay.size(); i += 5) {
+            fprintf(trace, "replay,%u,%.1f,%.1f,%.2f\n", (unsigned)i, replay[i].x, replay[i].y,
+                    replay[i].heading * 180.0f / (float)M_PI);
+        }
+    }
+    return r;
+}
+
+// 每次运行 fork 一个子进程: Motor 的积分项、Path 的步骤表等全局状态都从初始值开始
+static bool runIsolated(const Scenario& sc, const SimOptions& opt, uint32_t seed, bool hold, RunResult& out) {
+    int fd[2];
+    if (pipe(fd) != 0) {
+        perror("pipe");
+        return false;
+    }
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        return false;
+    }
+    if (pid == 0) {
+        close(fd[0]);
+        World w(sc, opt, seed, hold);
+        RunResult r = w.run(nullptr);
+        ssize_t n = write(fd[1], &r, sizeof(r));
+        _exit(n == (ssize_t)sizeof(r) ? 0 : 1);
+    }
+    close(fd[1]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    bool ok = read(fd[0], &out, sizeof(out)) == (ssize_t)sizeof(out) && WIFEXITED(status) &&
+              WEXITSTATUS(status) == 0;
+    close(fd[0]);
+    return ok;
+}
+
+static const Scenario* findScenario(const std::string& name) {
+    for (const Scenario& s : kScenarios) {
+        if (name == s.name) return &s;
+    }
+    return nullptr;
+}
+
+int main(int argc, char** argv) {
+    SimOptions opt;
+    int seeds = 8;
+    const char* trace = nullptr;
+    std::vector<const Scenario*> scenarios;
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (a == "--seeds" && hasValue) seeds = atoi(argv[++i]);
+        else if (a == "--wheel-err" && hasValue) opt.wheelErr = (float)atof(argv[++i]);
+        else if (a == "--load-var" && hasValue) opt.loadVar = (float)atof(argv[++i]);
+        else if (a == "--floor" && hasValue) opt.floorDps = (float)atof(argv[++i]);
+        else if (a == "--gyro-bias" && hasValue) opt.gyroBias = (float)atof(argv[++i]);
+        else if (a == "--motor-tau" && hasValue) opt.motorTau = (float)atof(argv[++i]);
+        else if (a == "--press-jitter" && hasValue) opt.pressJitterMs = (float)atof(argv[++i]);
+        else if (a == "--trace" && hasValue) trace = argv[++i];
+        else if (a == "--scenario" && hasValue) {
+            const Scenario* s = findScenario(argv[++i]);
+            if (s == nullptr) {
+                fprintf(stderr, "unknown scenario %s\n", argv[i]);
+                return 2;
+            }
+            scenarios.push_back(s);
+        } else {
+            fprintf(stderr, "usage: %s [--scenario NAME] [--seeds N] [--wheel-err F] [--load-var F] [--floor DPS]\n"
+                            "       [--gyro-bias DPS] [--motor-tau S] [--press-jitter MS] [--trace NAME]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (trace) {
+        const Scenario* s = findScenario(trace);
+        if (s == nullptr) {
+            fprintf(stderr, "unknown scenario %s\n", trace);
+            return 2;
+        }
+        World w(*s, opt, 0, true);
+        RunResult r = w.run(stdout);
+        fprintf(stderr, "%s: end %.1f cm, dev %.1f cm, heading %.2f deg, teach drift %.1f cm\n", trace, r.endErr,
+                r.devMax, r.headErr, r.drift);
+        return 0;
+    }
+    if (scenarios.empty()) {
+        for (const Scenario& s : kScenarios) scenarios.push_back(&s);
+    }
+
+    printf("wheel err %.3f, load var %.3f, floor %.1f deg/s, gyro bias %.2f deg/s, motor tau %.2f s, "
+           "press jitter %.0f ms, %d seeds, replay by %s\n",
+           opt.wheelErr, opt.loadVar, opt.floorDps, opt.gyroBias, opt.motorTau, opt.pressJitterMs, seeds,
+           PATH_REPLAY_BY_TRAVEL && MOTOR_RAMP_ENABLED ? "travel" : "time");
+    printf("scenario  mode |   end    max |   dev    max |  head    max | drift    max\n");
+    bool ok = true, pass = true;
+    for (const Scenario* sc : scenarios) {
+        float endMean[2] = {0, 0};
+        for (int hold = 0; hold < 2; hold++) {
+            RunResult sum = {0, 0, 0, 0}, worst = {0, 0, 0, 0};
+            for (int k = 0; k < seeds; k++) {
+                RunResult r;
+                if (!runIsolated(*sc, opt, 1000u * (uint32_t)k + 1u, hold != 0, r)) {
+                    fprintf(stderr, "%s seed %d failed\n", sc->name, k);
+                    ok = false;
+                    continue;
+                }
+                sum.endErr += r.endErr;
+                sum.devMax += r.devMax;
+                sum.headErr += r.headErr;
+                sum.drift += r.drift;
+                worst.endErr = std::max(worst.endErr, r.endErr);
+                worst.devMax = std::max(worst.devMax, r.devMax);
+                worst.headErr = std::max(worst.headErr, r.headErr);
+                worst.drift = std::max(worst.drift, r.drift);
+            }
+            float n = (float)seeds;
+            endMean[hold] = sum.endErr / n;
+            printf("%-9s %-4s | %5.1f  %5.1f | %5.1f  %5.1f | %5.2f  %5.2f | %5.1f  %5.1f\n", sc->name,
+                   hold ? "hold" : "off", sum.endErr / n, worst.endErr, sum.devMax / n, worst.devMax, sum.headErr / n,
+                   worst.headErr, sum.drift / n, worst.drift);
+        }
+        if (sc->holdCheck && !(endMean[1] < 0.5f * endMean[0])) pass = false;
+    }
+    printf("%s\n", ok && pass ? "PASS" : "FAIL");
+    return ok && pass ? 0 : 1;
+}
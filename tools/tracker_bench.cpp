@@ -0,0 +1,209 @@
+/**
+ * @file tracker_bench.cpp
+ * @brief 目标跟踪器基准与回放对比 (主机端)
+ * @details 1) 测量 TargetTracker 单次测距更新与预测的耗时 (us)
+ *          2) 用合成的行走轨迹与带噪测距回放，对比
+ *             "几何解算 + 每次loop固定系数 EMA" 与跟踪器预测的
+ *             误差与滞后 (滞后 = 使估计与真值 RMS 误差最小的时间平移)
+ *          3) 车原地转向 (目标静止)，对比不旋转与按陀螺仪转角 rotate() 时预测方位角的误差
+ *
+ * 编译运行 (在仓库根目录):
+ *   g++ -O2 -std=gnu++11 -Itools/host -Isrc tools/tracker_bench.cpp src/tracker.cpp -o /tmp/tracker_bench
+ *   /tmp/tracker_bench
+ */
+
+#include <Arduino.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "fast_math.h"
+#include "tracker.h"
+
+static const float kAnchorX[2] = {-UWB_BASELINE / 2, UWB_BASELINE / 2};
+
+// 行走轨迹: 分段匀速 (走-停-横移-后退)
+static void truthAt(float t, float& x, float& y) {
+    struct Seg { float dur, vx, vy; };
+    static const Seg segs[] = {
+        {2.0f, 0, 100}, {1.5f, 0, 0}, {2.0f, 60, 40}, {1.0f, 0, 0}, {2.0f, -80, -30}, {1.5f, 0, 60}};
+    x = 0;
+    y = 120;
+    for (const Seg& s : segs) {
+        float d = (t < s.dur) ? t : s.dur;
+        x += s.vx * d;
+        y += s.vy * d;
+        t -= d;
+        if (t <= 0) break;
+    }
+}
+
+static const float kDuration = 10.0f;
+static const float kOldEmaAlpha = 0.1f;  // 旧方案每次loop的滤波系数 (原 FOLLOW_FILTER_ALPHA)
+
+static float geomY(float d0, float d1, float& x) {
+    float L = UWB_BASELINE;
+    x = (d0 * d0 - d1 * d1) / (2 * L);
+    float ysq = d0 * d0 - (x + L / 2) * (x + L / 2);
+    return ysq > 0 ? sqrtf(ysq) : 0;
+}
+
+struct Trace {
+    std::vector<float> t, y;
+};
+
+static void lagAndRms(const Trace& tr, float& bestLag, float& rms0) {
+    bestLag = 0;
+    float best = 1e30f;
+    for (int lagMs = 0; lagMs <= 1000; lagMs += 5) {
+        float lag = lagMs * 1e-3f;
+        double acc = 0;
+        int n = 0;
+        for (size_t i = 0; i < tr.t.size(); i++) {
+            if (tr.t[i] < 1.0f) continue;
+            float x, y;
+            truthAt(tr.t[i] - lag, x, y);
+            acc += (tr.y[i] - y) * (tr.y[i] - y);
+            n++;
+        }
+        float rms = sqrtf((float)(acc / n));
+        if (lagMs == 0) rms0 = rms;
+        if (rms < best) {
+            best = rms;
+            bestLag = lag;
+        }
+    }
+}
+
+static void replay(float loopHz, float rangeHz, float noiseCm) {
+    std::mt19937 rng(42);
+    std::normal_distribution<float> noise(0, noiseCm);
+
+    TargetTracker tracker;
+    float d[2] = {0, 0};
+    float ema = 0;
+    bool emaInit = false;
+    Trace oldTr, newTr;
+
+    float rangeDt = 1.0f / rangeHz;
+    float nextRange[2] = {0, rangeDt / 2};  // 两基站交替测距
+    float loopDt = 1.0f / loopHz;
+
+    for (float t = 0; t < kDuration; t += loopDt) {
+        for (int a = 0; a < 2; a++) {
+            while (nextRange[a] <= t) {
+                float x, y;
+                truthAt(nextRange[a], x, y);
+                float r = sqrtf((x - kAnchorX[a]) * (x - kAnchorX[a]) + y * y) + noise(rng);
+                unsigned long us = (unsigned long)(nextRange[a] * 1e6f);
+                d[a] = r;
+                if (tracker.isInitialized()) {
+                    tracker.updateRange(kAnchorX[a], 0, r, us);
+                } else if (d[0] > 0 && d[1] > 0) {
+                    float gx;
+                    float gy = geomY(d[0], d[1], gx);
+                    tracker.init(gx, gy, us);
+                }
+                nextRange[a] += rangeDt;
+            }
+        }
+        if (d[0] <= 0 || d[1] <= 0) continue;
+
+        // 旧方案: 最新 d0/d1 几何解算 + 每次loop一次 EMA
+        float gx;
+        float gy = geomY(d[0], d[1], gx);
+        if (!emaInit) {
+            ema = gy;
+            emaInit = true;
+        }
+        ema += kOldEmaAlpha * (gy - ema);
+        oldTr.t.push_back(t);
+        oldTr.y.push_back(ema);
+
+        TrackState st;
+        if (tracker.predict((unsigned long)(t * 1e6f), st)) {
+            newTr.t.push_back(t);
+            newTr.y.push_back(st.y);
+        }
+    }
+
+    float lagOld, lagNew, rmsOld, rmsNew;
+    lagAndRms(oldTr, lagOld, rmsOld);
+    lagAndRms(newTr, lagNew, rmsNew);
+    printf("  loop %5.0f Hz, range %4.0f Hz, noise %4.1f cm | EMA: lag %4.0f ms rms %5.1f cm | Kalman: lag %4.0f ms rms %5.1f cm\n",
+           loopHz, rangeHz, noiseCm, lagOld * 1e3f, rmsOld, lagNew * 1e3f, rmsNew);
+}
+
+static void benchCost() {
+    TargetTracker tracker;
+    tracker.init(10, 150, 0);
+    const int n = 1000000;
+    float sink = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; i++) {
+        unsigned long us = (unsigned long)i * 25000UL;
+        tracker.updateRange(kAnchorX[i & 1], 0, 150.0f + (float)(i % 7), us);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    TrackState st;
+    for (int i = 0; i < n; i++) {
+        tracker.predict((unsigned long)i * 1000UL, st);
+        sink += st.y;
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    double upd = std::chrono::duration<double, std::micro>(t1 - t0).count() / n;
+    double pred = std::chrono::duration<double, std::micro>(t2 - t1).count() / n;
+    printf("updateRange: %.3f us/call, predict: %.3f us/call (sink=%.0f)\n", upd, pred, sink);
+}
+
+// 目标静止在前方 1.5 m，车以 rateDps 右转 90° 后停住；控制 50 Hz，测距每基站 20 Hz
+static void spin(float rateDps, float noiseCm, bool useGyro, float& rms, float& maxErr) {
+    std::mt19937 rng(3);
+    std::normal_distribution<float> noise(0, noiseCm);
+    TargetTracker tracker;
+    tracker.init(0, 150, 0);
+    const float turn = 90.0f * FAST_DEG_TO_RAD;
+    float heading = 0;
+    double sq = 0;
+    int n = 0;
+    maxErr = 0;
+    for (unsigned long us = 0; us < 2000000UL; us += 5000UL) {
+        float prev = heading;
+        heading = std::min(rateDps * FAST_DEG_TO_RAD * us * 1e-6f, turn);
+        // 车右转 heading 后，目标在车体坐标系中的位置
+        float bx = -150.0f * sinf(heading);
+        float by = 150.0f * cosf(heading);
+        if (useGyro) tracker.rotate(heading - prev);
+        if (us % 25000UL == 0) {
+            int a = (us / 25000UL) & 1;
+            float dx = bx - kAnchorX[a];
+            tracker.updateRange(kAnchorX[a], 0, sqrtf(dx * dx + by * by) + noise(rng), us);
+        }
+        if (us % 20000UL == 0) {
+            TrackState st;
+            tracker.predict(us, st);
+            float err = fabsf(atan2f(st.x, st.y) - atan2f(bx, by)) * FAST_RAD_TO_DEG;
+            sq += err * err;
+            n++;
+            if (err > maxErr) maxErr = err;
+        }
+    }
+    rms = (float)sqrt(sq / n);
+}
+
+int main() {
+    benchCost();
+    printf("Replay (forward distance y):\n");
+    replay(200, 20, 5);
+    replay(50, 20, 5);
+    replay(20, 20, 5);
+    replay(50, 10, 8);
+    printf("Spin in place 90 deg, static target at 150 cm (bearing error):\n");
+    for (float rate : {90.0f, 180.0f}) {
+        float rms0, max0, rms1, max1;
+        spin(rate, 5, false, rms0, max0);
+        spin(rate, 5, true, rms1, max1);
+        printf("  %3.0f deg/s | no gyro: rms %5.1f max %5.1f deg | rotate(): rms %5.1f max %5.1f deg\n", rate, rms0,
+               max0, rms1, max1);
+    }
+    return 0;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file trail_bench.cpp
+ * @brief 面包屑轨迹跟随耗时与转角偏离 (主机端)
+ * @details 1) 测量每个控制周期的 航位推算 + 写入轨迹 + 求前视点 耗时 (ns)
+ *          2) 用户直行 3 m 后右转 90° 再走 3 m，车以简化的差速运动学跟随，
+ *             对比 "直接朝用户" 与 "沿轨迹纯追踪" 时车偏离用户路径的最大距离
+ *             (转角处抄近路的程度) 与平均跟随距离
+ *
+ * 编译运行 (在仓库根目录):
+ *   g++ -O2 -std=gnu++11 -Itools/host -Isrc tools/trail_bench.cpp -o /tmp/trail_bench
+ *   /tmp/trail_bench
+ */
+
+#include <Arduino.h>
+#include <chrono>
+#include <random>
+#include "fast_math.h"
+#include "odometry.h"
+#include "trail.h"
+
+static const float kDt = 1.0f / CONTROL_RATE_HZ;
+
+// 用户路径: (0,0) -> (0,300) -> (300,300)，速度 70 cm/s (车最高约 FOLLOW_SPEED_MAX × CART_SPEED_PER_DUTY)
+static void userAt(float t, float& x, float& y) {
+    float s = t * 70.0f;
+    if (s < 300) {
+        x = 0;
+        y = s;
+    } else {
+        x = (s < 600) ? s - 300 : 300;
+        y = 300;
+    }
+}
+
+static float distToPath(float x, float y) {
+    float d1 = fabsf(x) + ((y > 300) ? y - 300 : (y < 0 ? -y : 0));
+    float d2 = fabsf(y - 300) + ((x < 0) ? -x : (x > 300 ? x - 300 : 0));
+    return (d1 < d2) ? d1 : d2;
+}
+
+struct Result {
+    float maxDeviation;
+    float meanGap;
+};
+
+static Result simulate(bool useTrail, float noise) {
+    std::mt19937 rng(11);
+    std::normal_distribution<float> n(0, noise);
+    Odometry odo;
+    BreadcrumbTrail<FOLLOW_TRAIL_CAPACITY> trail;
+    int16_t left = 0, right = 0;
+    Result r = {0, 0};
+    int samples = 0;
+
+    // 车从用户后方 1 m 出发；用户起步前先停 0.5 s
+    for (float t = 0; t < 12.0f; t += kDt) {
+        // 真实位姿 = 航位推算 (仿真中轮速没有误差)
+        odo.update(left, right, kDt);
+        const Pose& p = odo.pose();
+        float ux, uy;
+        userAt(t > 0.5f ? t - 0.5f : 0, ux, uy);
+        uy += 100.0f;   // 用户初始在车前 1 m
+        float bx, by;
+        odo.toBody(ux, uy, bx, by);
+        bx += n(rng);
+        by += n(rng);
+
+        float gap = fastSqrt(bx * bx + by * by);
+        float bearing = fastAtan2Deg(bx, by);
+        if (useTrail) {
+            float ox, oy;
+            odo.toOdom(bx, by, ox, oy);
+            trail.push(ox, oy, FOLLOW_TRAIL_SPACING);
+            TrailPoint tp;
+            if (trail.lookahead(p.x, p.y, FOLLOW_LOOKAHEAD, tp)) {
+                float tx, ty;
+                odo.toBody(tp.x, tp.y, tx, ty);
+                bearing = fastAtan2Deg(tx, ty);
+            }
+        }
+
+        // 与 Follow 连续控制相同形状的控制律 (无滤波)
+        float v = constrain(FOLLOW_KP_DIST * (gap - FOLLOW_ENABLE_DISTANCE), 0.0f, (float)FOLLOW_SPEED_MAX);
+        float w = constrain(FOLLOW_KP_ANGLE * bearing, -(float)FOLLOW_TURN_MAX, (float)FOLLOW_TURN_MAX);
+        v *= constrain(1.0f - fabsf(bearing) / FOLLOW_ARC_ANGLE, 0.0f, 1.0f);
+        left = (int16_t)constrain(v + w, -255.0f, 255.0f);
+        right = (int16_t)constrain(v - w, -255.0f, 255.0f);
+
+        float dev = distToPath(p.x, p.y - 100.0f);
+        if (p.y > 100.0f && dev > r.maxDeviation) r.maxDeviation = dev;
+        r.meanGap += gap;
+        samples++;
+    }
+    r.meanGap /= samples;
+    return r;
+}
+
+int main() {
+    // 耗时: 随机行走的用户，每周期完整执行一次
+    Odometry odo;
+    BreadcrumbTrail<FOLLOW_TRAIL_CAPACITY> trail;
+    std::mt19937 rng(5);
+    std::normal_distribution<float> step(0, 3);
+    const int cycles = 2000000;
+    float ux = 0, uy = 100, sink = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < cycles; i++) {
+        ux += step(rng);
+        uy += 0.8f + step(rng);
+        odo.update(120, 110, kDt);
+        float bx, by;
+        odo.toBody(ux, uy, bx, by);
+        float ox, oy;
+        odo.toOdom(bx, by, ox, oy);
+        trail.push(ox, oy, FOLLOW_TRAIL_SPACING);
+        TrailPoint tp;
+        if (trail.lookahead(odo.pose().x, odo.pose().y, FOLLOW_LOOKAHEAD, tp)) {
+            float tx, ty;
+            odo.toBody(tp.x, tp.y, tx, ty);
+            sink += fastAtan2Deg(tx, ty);
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / cycles;
+    // 随机数生成也在计时内，单独扣除
+    auto t2 = std::chrono::steady_clock::now();
+    for (int i = 0; i < cycles; i++) {
+        ux += step(rng);
+        uy += step(rng);
+    }
+    auto t3 = std::chrono::steady_clock::now();
+    ns -= std::chrono::duration<double, std::nano>(t3 - t2).count() / cycles;
+    printf("Trail step (odometry + push + lookahead): %.1f ns/cycle, capacity %d, overflows %lu (sink=%.0f)\n",
+           ns, FOLLOW_TRAIL_CAPACITY, (unsigned long)trail.overflows(), sink + ux + uy);
+    printf("Memory: %u bytes trail + %u bytes odometry\n", (unsigned)sizeof(trail), (unsigned)sizeof(odo));
+
+    printf("90 deg corner, user 70 cm/s, lookahead %.0f cm:\n", FOLLOW_LOOKAHEAD);
+    for (float noise : {0.0f, 5.0f, 10.0f}) {
+        Result direct = simulate(false, noise);
+        Result trailR = simulate(true, noise);
+        printf("  noise %4.1f cm | direct: max deviation %5.1f cm gap %5.1f cm | trail: max deviation %5.1f cm gap %5.1f cm\n",
+               noise, direct.maxDeviation, direct.meanGap, trailR.maxDeviation, trailR.meanGap);
+    }
+    return 0;
+}
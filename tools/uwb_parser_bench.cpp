@@ -0,0 +1,343 @@
+/**
+ * @file uwb_parser_bench.cpp
+ * @brief UWB串口解析吞吐量基准 (主机端)
+ * @details 对比旧版 String 行缓冲解析、兼容格式 (Mixed) 与编译期选定的
+ *          单一格式策略 (uwb_format.h) 的每字节耗时、吞吐量与每帧堆分配次数，
+ *          语料覆盖三种格式：ASCII 十进制、MK8000 二进制帧 (F0..AA)、AT 十六进制；
+ *          并检查 UwbChannel 为同一批读出的多帧倒推的到达时刻 (按帧后字节数与串口字节时间)
+ *
+ * 编译运行 (在仓库根目录):
+ *   g++ -O2 -std=gnu++11 -Itools/host -Isrc tools/uwb_parser_bench.cpp src/uwb_parser.cpp -o /tmp/uwb_parser_bench
+ *   /tmp/uwb_parser_bench
+ */
+
+#include <Arduino.h>
+#include <stdlib.h>
+#include <chrono>
+#include <new>
+#include <vector>
+#include "uwb_channel.h"
+
+// ==================== 堆分配计数 ====================
+
+static unsigned long g_allocs = 0;
+
+void* operator new(size_t n) {
+    g_allocs++;
+    void* p = malloc(n);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+// ==================== 旧版实现 (String) ====================
+
+// 模拟 Arduino String (不含 SSO): 按需 realloc 增长，substring 产生新对象
+class LegacyString {
+public:
+    LegacyString() {}
+    LegacyString(const char* s, size_t n) { assign(s, n); }
+    LegacyString(const LegacyString& o) { assign(o._buf, o._len); }
+    ~LegacyString() { free(_buf); }
+    LegacyString& operator=(const char*) { _len = 0; return *this; }
+    LegacyString& operator+=(char c) {
+        reserve(_len + 1);
+        _buf[_len++] = c;
+        _buf[_len] = '\0';
+        return *this;
+    }
+    unsigned int length() const { return (unsigned int)_len; }
+    char charAt(unsigned int i) const { return _buf[i]; }
+    void trim() {
+        size_t b = 0;
+        while (b < _len && _buf[b] == ' ') b++;
+        size_t e = _len;
+        while (e > b && _buf[e - 1] == ' ') e--;
+        memmove(_buf, _buf + b, e - b);
+        _len = e - b;
+        if (_buf) _buf[_len] = '\0';
+    }
+    LegacyString substring(unsigned int b, unsigned int e) const { return LegacyString(_buf + b, e - b); }
+    float toFloat() const { return _buf ? (float)atof(_buf) : 0; }
+
+private:
+    void assign(const char* s, size_t n) {
+        reserve(n);
+        memcpy(_buf, s, n);
+        _len = n;
+        _buf[_len] = '\0';
+    }
+    void reserve(size_t n) {
+        if (_buf && n <= _cap) return;
+        g_allocs++;
+        _buf = (char*)realloc(_buf, n + 1);
+        _cap = n;
+    }
+    char* _buf = nullptr;
+    size_t _len = 0;
+    size_t _cap = 0;
+};
+
+static int legacyHex(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// 与旧版 UWB::parseDistance() 相同的算法
+static float legacyParseDistance(LegacyString& line) {
+    line.trim();
+    if (line.length() == 0) return 0;
+    int len = line.length();
+    float value = 0;
+    bool found = false;
+    int lastEnd = -1;
+    for (int i = 0; i < len; i++) {
+        char c = line.charAt(i);
+        if ((c >= '0' && c <= '9') || c == '.' || c == '-' || c == '+') {
+            int j = i;
+            bool hasDigit = false;
+            if (line.charAt(j) == '-' || line.charAt(j) == '+') j++;
+            while (j < len) {
+                char cj = line.charAt(j);
+                if (cj >= '0' && cj <= '9') { hasDigit = true; j++; }
+                else if (cj == '.') { j++; }
+                else break;
+            }
+            if (hasDigit) {
+                value = line.substring(i, j).toFloat();
+                found = true;
+                lastEnd = j;
+            }
+            i = j - 1;
+        }
+    }
+    if (found && value > 0) {
+        int k = lastEnd;
+        while (k < len && line.charAt(k) == ' ') k++;
+        if (k < len) {
+            char c0 = line.charAt(k) | 0x20;
+            char c1 = (k + 1 < len) ? (line.charAt(k + 1) | 0x20) : '\0';
+            if (c0 == 'm' && c1 == 'm') return value * 0.1f;
+            if (c0 == 'c' && c1 == 'm') return value;
+            if (c0 == 'm') return value * 100.0f;
+        }
+        return value * UWB_DISTANCE_SCALE;
+    }
+    unsigned long hexValue = 0;
+    bool hexFound = false;
+    for (int i = 0; i < len; i++) {
+        int j = i;
+        if (line.charAt(j) == '0' && j + 1 < len && (line.charAt(j + 1) | 0x20) == 'x') j += 2;
+        unsigned long v = 0;
+        bool hasHex = false;
+        while (j < len && legacyHex(line.charAt(j)) >= 0) {
+            v = (v << 4) + (unsigned long)legacyHex(line.charAt(j));
+            hasHex = true;
+            j++;
+        }
+        if (hasHex) { hexValue = v; hexFound = true; i = j - 1; }
+    }
+    if (!hexFound || hexValue == 0) return 0;
+    return (float)hexValue * UWB_HEX_SCALE;
+}
+
+// ==================== 逐字节解析循环 (同 UWB::update) ====================
+
+static bool isPrintable(uint8_t b) { return b >= 0x20 && b <= 0x7E; }
+
+struct LegacyChannel {
+    FrameParser parser;
+    LegacyString line;
+    float feed(uint8_t b) {
+        uint16_t addr, dist;
+        uint8_t rssi;
+        if (parseFrame(parser, b, addr, dist, rssi)) return (float)dist;
+        if (parser.state != 0) return 0;
+        if (b == '\n' || b == '\r') {
+            float d = 0;
+            if (line.length() > 0) {
+                d = legacyParseDistance(line);
+                line = "";
+            }
+            return d;
+        }
+        if (isPrintable(b)) line += (char)b;
+        else if (line.length() > 0) line = "";
+        return 0;
+    }
+};
+
+// ==================== 语料 ====================
+
+enum CorpusKind { CORPUS_ASCII, CORPUS_BINARY, CORPUS_HEX };
+
+static std::vector<uint8_t> buildCorpus(CorpusKind kind, int frames) {
+    std::vector<uint8_t> out;
+    char line[64];
+    for (int i = 0; i < frames; i++) {
+        unsigned dist = 50 + (unsigned)(i * 37) % 900;
+        int n = 0;
+        switch (kind) {
+            case CORPUS_ASCII:
+                if (i % 3 == 0) n = snprintf(line, sizeof(line), "d: %ucm\r\n", dist);
+                else if (i % 3 == 1) n = snprintf(line, sizeof(line), "DIST: %u.%02um\r\n", dist / 100, dist % 100);
+                else n = snprintf(line, sizeof(line), "%u\r\n", dist);
+                out.insert(out.end(), line, line + n);
+                break;
+            case CORPUS_HEX:
+                n = snprintf(line, sizeof(line), "mc 0f %08x\r\n", dist * 10);
+                out.insert(out.end(), line, line + n);
+                break;
+            case CORPUS_BINARY: {
+                uint8_t f[9] = {0xF0, 0x05, 0x01, 0x00, (uint8_t)(dist & 0xFF), (uint8_t)(dist >> 8), 0x50, 0xAA, 0};
+                out.insert(out.end(), f, f + 8);
+                break;
+            }
+        }
+    }
+    return out;
+}
+
+static void report(const char* name, double sec, size_t corpusBytes, int frames, int rounds,
+                   unsigned long allocs, int parsed, float sink) {
+    double bytes = (double)corpusBytes * rounds;
+    double totalFrames = (double)frames * rounds;
+    printf("  %-8s %6.2f ns/byte %8.1f MB/s  %6.2f allocs/frame  parsed=%d/%.0f  (sink=%.0f)\n",
+           name, sec * 1e9 / bytes, bytes / sec / 1e6, (double)allocs / totalFrames,
+           parsed, totalFrames, sink);
+}
+
+// 旧版: 逐字节 String 行缓冲
+static void runLegacy(const std::vector<uint8_t>& corpus, int frames, int rounds) {
+    LegacyChannel ch;
+    unsigned long allocsBefore = g_allocs;
+    int parsed = 0;
+    float sink = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < corpus.size(); i++) {
+            float d = ch.feed(corpus[i]);
+            if (d > 0) {
+                parsed++;
+                sink += d;
+            }
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    report("String", std::chrono::duration<double>(t1 - t0).count(), corpus.size(), frames, rounds,
+           g_allocs - allocsBefore, parsed, sink);
+}
+
+// 格式策略: 与 UwbChannel::poll 相同，按 UWB_READ_CHUNK 字节分块送入
+template <typename FormatT>
+static void runFormat(const char* name, const std::vector<uint8_t>& corpus, int frames, int rounds) {
+    const size_t chunk = 64;
+    FormatT fmt;
+    unsigned long allocsBefore = g_allocs;
+    int parsed = 0;
+    float sink = 0;
+    auto onRange = [&](const UwbReading& r, size_t) {
+        parsed++;
+        sink += r.distance;
+    };
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < corpus.size(); i += chunk) {
+            size_t n = (corpus.size() - i < chunk) ? corpus.size() - i : chunk;
+            fmt.feed(&corpus[i], n, 0, onRange);
+            fmt.idle(0, onRange);
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    report(name, std::chrono::duration<double>(t1 - t0).count(), corpus.size(), frames, rounds,
+           g_allocs - allocsBefore, parsed, sink);
+}
+
+// ==================== 到达时刻 ====================
+
+// 一次性写入整批字节的流，available() 返回尚未读出的字节数
+struct BatchStream {
+    std::vector<uint8_t> bytes;
+    size_t pos = 0;
+    int available() { return (int)(bytes.size() - pos); }
+    size_t readBytes(uint8_t* buffer, size_t length) {
+        size_t n = 0;
+        while (n < length && pos < bytes.size()) buffer[n++] = bytes[pos++];
+        return n;
+    }
+};
+
+// 整批字节在读出时刻 (hostMicros) 之前刚好收完: 每帧时刻 = 读出时刻 - 帧后字节数 x 字节时间
+template <typename FormatT>
+static bool checkArrival(const char* name, CorpusKind kind, int warmup, int frames) {
+    BatchStream stream;
+    UwbChannel<BatchStream, FormatT> channel(stream, 0);
+    std::vector<unsigned long> got;
+    auto onRange = [&](const UwbReading&, unsigned long timeUs) { got.push_back(timeUs); };
+
+    // 自动检测先用若干帧锁定格式
+    hostMicros() = 1000000;
+    stream.bytes = buildCorpus(kind, warmup);
+    channel.poll(millis(), onRange);
+    got.clear();
+
+    // 一批多帧 (跨越多个读取块)，记录每帧最后一个字节在批中的位置
+    std::vector<uint8_t> batch = buildCorpus(kind, frames);
+    std::vector<size_t> ends;
+    for (size_t i = 0; i < batch.size(); i++) {
+        bool binaryEnd = kind == CORPUS_BINARY && batch[i] == 0xAA;
+        bool lineEnd = kind != CORPUS_BINARY && batch[i] == '\n' && i > 0 && batch[i - 1] != '\r';
+        bool crEnd = kind != CORPUS_BINARY && batch[i] == '\r';
+        if (binaryEnd || lineEnd || crEnd) ends.push_back(i + 1);
+    }
+    stream.bytes = batch;
+    stream.pos = 0;
+    hostMicros() = 2000000;
+    channel.poll(millis(), onRange);
+
+    bool ok = got.size() == ends.size();
+    long maxErr = 0;
+    for (size_t i = 0; ok && i < got.size(); i++) {
+        unsigned long expect = hostMicros() - uwbByteTimeUs(batch.size() - ends[i]);
+        long err = labs((long)(got[i] - expect));
+        if (err > maxErr) maxErr = err;
+    }
+    ok = ok && maxErr <= 1;
+    printf("  %-8s %3zu frames in %4zu bytes: first %6.2f ms before read, max error %ld us %s\n", name,
+           got.size(), batch.size(), got.empty() ? 0.0 : (hostMicros() - got[0]) / 1000.0, maxErr,
+           ok ? "OK" : "FAIL");
+    return ok;
+}
+
+int main() {
+    bool ok = true;
+    printf("Arrival time (%d baud, %lu us/byte):\n", UWB_BAUD_RATE, uwbByteTimeUs(1));
+    ok &= checkArrival<UwbBinaryFormat>("Binary", CORPUS_BINARY, 0, 20);
+    ok &= checkArrival<UwbAsciiFormat>("Ascii", CORPUS_ASCII, 0, 12);
+    ok &= checkArrival<UwbMixedFormat>("Mixed", CORPUS_BINARY, 0, 20);
+    ok &= checkArrival<UwbAutoFormat>("Auto", CORPUS_BINARY, UWB_FORMAT_DETECT_FRAMES + 2, 20);
+    ok &= checkArrival<UwbAutoFormat>("Auto", CORPUS_HEX, UWB_FORMAT_DETECT_FRAMES + 2, 12);
+
+    const int frames = 10000;
+    const int rounds = 50;
+    const char* names[] = {"ASCII", "Binary", "Hex"};
+    CorpusKind kinds[] = {CORPUS_ASCII, CORPUS_BINARY, CORPUS_HEX};
+
+    for (int k = 0; k < 3; k++) {
+        std::vector<uint8_t> corpus = buildCorpus(kinds[k], frames);
+        printf("%s corpus: %zu bytes, %d frames\n", names[k], corpus.size(), frames);
+        runLegacy(corpus, frames, rounds);
+        runFormat<UwbMixedFormat>("Mixed", corpus, frames, rounds);
+        switch (kinds[k]) {
+            case CORPUS_ASCII:  runFormat<UwbAsciiFormat>("Ascii", corpus, frames, rounds); break;
+            case CORPUS_BINARY: runFormat<UwbBinaryFormat>("Binary", corpus, frames, rounds); break;
+            case CORPUS_HEX:    runFormat<UwbHexFormat>("Hex", corpus, frames, rounds); break;
+        }
+        runFormat<UwbAutoFormat>("Auto", corpus, frames, rounds);
+    }
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,494 @@
+/**
+ * @file uwb_replay.cpp
+ * @brief UWB飞行记录主机端回放 (主机端)
+ * @details 读取 G 命令导出的飞行记录 (串口文本或二进制)，按记录时间戳把原始字节
+ *          写入 Serial2/Serial1，驱动真实的 UWB 解析、定位、跟踪与 Follow 控制代码，
+ *          输出每次电机指令变化 (CSV)。时钟由回放推进，结果完全确定，
+ *          可把现场问题固化为回归用例 (对比两次输出的 CSV 即可)。
+ *
+ *          事件模型与固件一致: 每条记录到达时调用一次 uwb.update()
+ *          (对应后台接收任务)，另按 --loop-ms 周期执行跟随模式的控制 (对应控制任务)
+ *
+ *          --closed-loop 用于车静止时录下的记录 (如 --synth-follow): 车按电机输出朝用户前进，
+ *          每帧二进制测距按缩短后的距离改写 (方位角不变)，控制效果反馈到后续测距；
+ *          结束时输出跟随指标: 追赶时间 (用户起步到车速达到用户速度的 80%) 与
+ *          超调 (用户停下后车比停止距离更近的最大值)
+ *
+ * 编译运行 (在仓库根目录):
+ *   g++ -O2 -std=gnu++11 -DUWB_RX_TASK_ENABLED=0 -DUWB_LOG_ENABLED=0 -DDEBUG_ENABLED=0 \
+ *       -Itools/host -Isrc tools/uwb_replay.cpp src/uwb.cpp src/uwb_parser.cpp src/uwb_filter.cpp \
+ *       src/uwb_tags.cpp src/tracker.cpp src/follow.cpp src/motor.cpp -o /tmp/uwb_replay
+ *   /tmp/uwb_replay capture.txt > motor.csv     回放串口监视器保存的导出内容
+ *   /tmp/uwb_replay --synth walk.txt            生成一段合成的行走记录
+ *   /tmp/uwb_replay --synth-follow follow.txt   生成走开-停下交替的记录 (用于 --closed-loop)
+ *   选项: --loop-ms N  控制周期 (默认 1000/CONTROL_RATE_HZ ms)    --summary  只输出统计 (含 U 命令的链路统计)
+ *         --closed-loop  车随控制输出移动并改写测距, 输出追赶时间与超调
+ *         --drop T:MS    丢弃记录开始后 T 秒起 MS 毫秒内的数据, 模拟定位中断 (可重复)
+ */
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include "uwb.h"
+#include "uwb_log.h"
+#include "follow.h"
+#include "motor.h"
+
+struct Record {
+    uint32_t timeUs;
+    uint8_t channel;
+    std::vector<uint8_t> data;
+};
+
+// ==================== 读取日志 ====================
+
+static int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// 文本导出: 取最后一个完整的 UWBLOG BEGIN..END 块 (允许行首带终端时间戳)
+static bool decodeText(const std::string& text, std::vector<uint8_t>& out) {
+    std::vector<uint8_t> block;
+    bool inBlock = false;
+    bool complete = false;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = text.find('\n', pos);
+        if (end == std::string::npos) end = text.size();
+        std::string line = text.substr(pos, end - pos);
+        pos = end + 1;
+
+        size_t tag = line.find("UWBLOG ");
+        if (tag == std::string::npos) continue;
+        std::string body = line.substr(tag + 7);
+        if (body.compare(0, 5, "BEGIN") == 0) {
+            block.clear();
+            inBlock = true;
+        } else if (body.compare(0, 3, "END") == 0) {
+            if (inBlock) {
+                out = block;
+                complete = true;
+            }
+            inBlock = false;
+        } else if (inBlock) {
+            for (size_t i = 0; i + 1 < body.size(); i += 2) {
+                int hi = hexValue(body[i]);
+                int lo = hexValue(body[i + 1]);
+                if (hi < 0 || lo < 0) break;
+                block.push_back((uint8_t)(hi << 4 | lo));
+            }
+        }
+    }
+    return complete;
+}
+
+static bool loadLog(const char* path, std::vector<Record>& records) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return false;
+    }
+    std::string raw;
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) raw.append(buf, n);
+    fclose(f);
+
+    std::vector<uint8_t> bin;
+    // 文本导出以 "UWBLOG" 开头，二进制文件头第 5 字节为版本号
+    if (raw.size() > 4 && raw.compare(0, 4, UWB_LOG_MAGIC) == 0 && raw[4] == UWB_LOG_VERSION) {
+        bin.assign(raw.begin(), raw.end());
+    } else if (!decodeText(raw, bin)) {
+        fprintf(stderr, "%s: no complete UWBLOG BEGIN..END block\n", path);
+        return false;
+    }
+
+    if (bin.size() < UWB_LOG_FILE_HEADER_SIZE || memcmp(bin.data(), UWB_LOG_MAGIC, 4) != 0 ||
+        bin[4] != UWB_LOG_VERSION) {
+        fprintf(stderr, "%s: bad log header\n", path);
+        return false;
+    }
+    if (bin[5] != UWB_ANCHOR_COUNT) {
+        fprintf(stderr, "warning: log has %u anchors, build has %u\n", bin[5], UWB_ANCHOR_COUNT);
+    }
+
+    size_t i = UWB_LOG_FILE_HEADER_SIZE;
+    while (i + UWB_LOG_RECORD_HEADER_SIZE <= bin.size()) {
+        Record r;
+        r.timeUs = (uint32_t)bin[i] | (uint32_t)bin[i + 1] << 8 | (uint32_t)bin[i + 2] << 16 |
+                   (uint32_t)bin[i + 3] << 24;
+        r.channel = bin[i + 4];
+        uint8_t len = bin[i + 5];
+        i += UWB_LOG_RECORD_HEADER_SIZE;
+        if (i + len > bin.size()) break;
+        r.data.assign(bin.begin() + i, bin.begin() + i + len);
+        i += len;
+        records.push_back(r);
+    }
+    // 两路接收任务交替写入，按时间稳定排序
+    std::stable_sort(records.begin(), records.end(),
+                     [](const Record& a, const Record& b) { return (int32_t)(a.timeUs - b.timeUs) < 0; });
+    return !records.empty();
+}
+
+// ==================== 合成日志 ====================
+
+static void writeHexDump(FILE* f, const std::vector<uint8_t>& bin) {
+    fprintf(f, "UWBLOG BEGIN %u\n", (unsigned)bin.size());
+    for (size_t i = 0; i < bin.size(); i += 32) {
+        fprintf(f, "UWBLOG ");
+        for (size_t j = i; j < i + 32 && j < bin.size(); j++) fprintf(f, "%02x", bin[j]);
+        fprintf(f, "\n");
+    }
+    fprintf(f, "UWBLOG END\n");
+}
+
+struct SynthSeg {
+    float dur, vx, vy;
+};
+
+// 目标 (相对车体，车不动): 站在前方 1.5 m，向前走远，横移到大角度，
+// 停下，再斜向走回车前 1 m 以内
+static const SynthSeg kWalk[] = {{2, 0, 0}, {3, 0, 60}, {2, 120, 0}, {2, 0, 0}, {3, -80, -80}, {2, 0, 0}};
+
+// 供 --closed-loop 使用: 用户以不同速度向前走开并停下，始终在车前方，
+// 速度不超过车的最高速度 (约 FOLLOW_SPEED_MAX 对应的 85 cm/s)
+static const SynthSeg kFollow[] = {{2, 0, 0}, {4, 0, 50}, {3, 0, 0}, {3, 0, 75}, {3, 0, 0},
+                                   {3, 30, 60}, {3, 0, 0}, {3, 0, 80}, {3, 0, 0}};
+
+template <size_t N>
+static void synthTruth(const SynthSeg (&segs)[N], float t, float& x, float& y) {
+    x = 0;
+    y = 150;
+    for (const SynthSeg& s : segs) {
+        float d = (t < s.dur) ? t : s.dur;
+        x += s.vx * d;
+        y += s.vy * d;
+        t -= d;
+        if (t <= 0) break;
+    }
+}
+
+template <size_t N>
+static int synth(const char* path, const SynthSeg (&segs)[N]) {
+    static const AnchorPos anchors[] = UWB_ANCHOR_POSITIONS;
+    std::mt19937 rng(1);
+    std::normal_distribution<float> noise(0, 4);
+    std::uniform_real_distribution<float> u(0, 1);
+
+    std::vector<uint8_t> bin = {'U', 'W', 'B', 'L', UWB_LOG_VERSION, UWB_ANCHOR_COUNT, 0, 0};
+    float duration = 0;
+    for (const SynthSeg& seg : segs) duration += seg.dur;
+    const float period = 0.05f;  // 每基站 20 Hz
+    for (float t = 0.5f; t < duration; t += period) {
+        for (uint8_t a = 0; a < UWB_ANCHOR_COUNT; a++) {
+            float ts = t + a * period / UWB_ANCHOR_COUNT;
+            float x, y;
+            synthTruth(segs, ts, x, y);
+            float d = sqrtf((x - anchors[a].x) * (x - anchors[a].x) + (y - anchors[a].y) * (y - anchors[a].y));
+            d += noise(rng);
+            if (u(rng) < 0.02f) d += 150;  // 偶发多径尖峰
+            uint16_t cm = (uint16_t)(d > 0 ? d : 0);
+            uint32_t us = (uint32_t)(ts * 1e6f);
+            uint8_t rec[UWB_LOG_RECORD_HEADER_SIZE + 8] = {
+                (uint8_t)us, (uint8_t)(us >> 8), (uint8_t)(us >> 16), (uint8_t)(us >> 24), a, 8,
+                0xF0, 0x05, 0x01, 0x00, (uint8_t)cm, (uint8_t)(cm >> 8), 0x50, 0xAA};
+            bin.insert(bin.end(), rec, rec + sizeof(rec));
+        }
+    }
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "cannot write %s\n", path);
+        return 1;
+    }
+    writeHexDump(f, bin);
+    fclose(f);
+    fprintf(stderr, "wrote %s: %.0f s, %u bytes\n", path, duration, (unsigned)bin.size());
+    return 0;
+}
+
+// ==================== 闭环 ====================
+
+// 只模拟径向: 车朝用户前进 s 后，用户到车的距离缩短 s，方位角保持记录值。
+// 每帧测距 r 按基站横向坐标 ax 拆成沿车头的距离 rho = sqrt(r^2 - ax^2)，
+// 改写为 sqrt(ax^2 + (rho - s)^2)；两基站之差随距离等比缩小，解算出的角度不变，
+// 记录中的噪声与尖峰原样保留。车速按实际占空比估计，转向不计入位移
+class ClosedLoop {
+public:
+    void step(float dt) {
+        int16_t left, right;
+        motor.getWheels(left, right);
+        _travel += 0.5f * (left + right) * CART_SPEED_PER_DUTY * dt;
+    }
+
+    void rewrite(Record& r) {
+        static const AnchorPos anchors[] = UWB_ANCHOR_POSITIONS;
+        if (r.channel >= UWB_ANCHOR_COUNT) return;
+        float ax = anchors[r.channel].x;
+        std::vector<uint8_t>& d = r.data;
+        // 二进制帧: F0 05 addr(2) dist(2) rssi AA
+        for (size_t i = 0; i + 8 <= d.size(); i++) {
+            if (d[i] != 0xF0 || d[i + 1] != 0x05 || d[i + 7] != 0xAA) continue;
+            float raw = (float)(d[i + 4] | (d[i + 5] << 8));
+            float rho = sqrtf(std::max(raw * raw - ax * ax, 0.0f));
+            track(r.channel, rho);
+            float ahead = rho - _travel;
+            uint16_t v = (uint16_t)constrain(sqrtf(ax * ax + ahead * ahead) + 0.5f, 0.0f, 65535.0f);
+            d[i + 4] = (uint8_t)v;
+            d[i + 5] = (uint8_t)(v >> 8);
+            _rewritten++;
+            i += 7;
+        }
+    }
+
+    float travel() const { return _travel; }
+    bool haveUser() const { return _count[0] >= 3; }
+    // 用户沿录制时车头方向的距离: 基站 0 最近 3 次的中值，去掉多径尖峰
+    float userRange() const {
+        const float* v = _rho;
+        return std::max(std::min(v[0], v[1]), std::min(std::max(v[0], v[1]), v[2]));
+    }
+    unsigned long rewritten() const { return _rewritten; }
+
+private:
+    float _travel = 0;
+    float _rho[3] = {};
+    uint8_t _count[1] = {};
+    unsigned long _rewritten = 0;
+
+    void track(uint8_t anchor, float rho) {
+        if (anchor != 0) return;
+        _rho[0] = _rho[1];
+        _rho[1] = _rho[2];
+        _rho[2] = rho;
+        if (_count[0] < 3) _count[0]++;
+    }
+};
+
+struct FollowSample {
+    float t;            // s
+    float user;         // 用户沿录制时车头方向的距离 (cm)
+    float gap;          // 用户与车的距离 (cm)
+    float cartSpeed;    // 车前进速度 (cm/s)，按实际占空比估计
+};
+
+// 用户速度取前后 0.5 s 的距离差，距离取前后 0.25 s 的均值 (离线可用非因果估计，去掉测距噪声)。
+// 用户速度超过 30 cm/s 记一次起步，低于 10 cm/s 记一次停下；
+// 追赶时间 = 起步到车速达到用户速度 80%，超调 = 停下后 3 s 内车比停止距离更近的最大值
+static void printFollowMetrics(const std::vector<FollowSample>& s, float loopSec) {
+    const float kMoving = 30.0f, kStopped = 10.0f, kCatch = 0.8f, kHorizon = 3.0f;
+    int half = (int)(0.5f / loopSec + 0.5f);
+    float stopDist = FOLLOW_DIST_TARGET + FOLLOW_DIST_DEADZONE;
+    if (stopDist < FOLLOW_ENABLE_DISTANCE) stopDist = FOLLOW_ENABLE_DISTANCE;
+
+    std::vector<float> speed(s.size(), 0.0f);
+    std::vector<float> gap(s.size(), 0.0f);
+    for (int i = 0; i < (int)s.size(); i++) {
+        if (i >= half && i + half < (int)s.size()) {
+            speed[i] = (s[i + half].user - s[i - half].user) / (2 * half * loopSec);
+        }
+        int lo = std::max(i - half / 2, 0), hi = std::min(i + half / 2, (int)s.size() - 1);
+        for (int j = lo; j <= hi; j++) gap[i] += s[j].gap;
+        gap[i] /= (hi - lo + 1);
+    }
+
+    bool moving = false;
+    int starts = 0, caught = 0, stops = 0;
+    float stall = 0;    // 用户在走而车停着的时长
+    float catchSum = 0, catchMax = 0, overSum = 0, overMax = 0, minGapAll = 1e9f;
+    int horizon = (int)(kHorizon / loopSec);
+    for (int i = 0; i < (int)s.size(); i++) {
+        if (speed[i] > kMoving && s[i].cartSpeed <= 0) stall += loopSec;
+        if (!moving && speed[i] > kMoving) {
+            moving = true;
+            starts++;
+            for (int j = i; j < (int)s.size() && j < i + horizon; j++) {
+                if (s[j].cartSpeed >= kCatch * speed[j] && speed[j] > kMoving) {
+                    float t = s[j].t - s[i].t;
+                    catchSum += t;
+                    if (t > catchMax) catchMax = t;
+                    caught++;
+                    break;
+                }
+            }
+        } else if (moving && speed[i] < kStopped) {
+            moving = false;
+            stops++;
+            float minGap = 1e9f;
+            for (int j = i; j < (int)s.size() && j < i + horizon; j++) {
+                if (gap[j] < minGap) minGap = gap[j];
+            }
+            float over = (minGap < stopDist) ? stopDist - minGap : 0;
+            overSum += over;
+            if (over > overMax) overMax = over;
+            if (minGap < minGapAll) minGapAll = minGap;
+        }
+    }
+    fprintf(stderr, "follow: starts=%d caught=%d catch_up avg=%.2f s max=%.2f s | stops=%d overshoot avg=%.1f cm max=%.1f cm "
+            "(stop distance %.0f cm, min gap %.1f cm) | stalled while user walks %.1f s\n",
+            starts, caught, caught ? catchSum / caught : 0.0f, catchMax, stops, stops ? overSum / stops : 0.0f, overMax,
+            stopDist, stops ? minGapAll : 0.0f, stall);
+}
+
+// ==================== 回放 ====================
+
+static const char* motorCommand(const uint32_t* d) {
+    // 通道 0..3 = 左IN1 左IN2 右IN1 右IN2 (LEDC 后端，见 motor_driver.h)
+    bool lf = d[0] > 0, lb = d[1] > 0, rf = d[2] > 0, rb = d[3] > 0;
+    if (!lf && !lb && !rf && !rb) return "STOP";
+    if (lf && rf) return (d[0] == d[2]) ? "FORWARD" : (d[0] > d[2]) ? "ARC_RIGHT" : "ARC_LEFT";
+    if (lb && rb) return "BACKWARD";
+    if (lb && rf) return "LEFT";
+    if (lf && rb) return "RIGHT";
+    if (lf) return "PIVOT_RIGHT";
+    if (rf) return "PIVOT_LEFT";
+    return "OTHER";
+}
+
+int main(int argc, char** argv) {
+    const char* path = nullptr;
+    unsigned long loopUs = 1000000UL / CONTROL_RATE_HZ;
+    bool summaryOnly = false;
+    bool closedLoop = false;
+    std::vector<std::pair<float, float>> drops;  // (起点 s, 时长 ms)
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--synth" && i + 1 < argc) return synth(argv[i + 1], kWalk);
+        if (arg == "--synth-follow" && i + 1 < argc) return synth(argv[i + 1], kFollow);
+        if (arg == "--loop-ms" && i + 1 < argc) loopUs = (unsigned long)(atof(argv[++i]) * 1000);
+        else if (arg == "--summary") summaryOnly = true;
+        else if (arg == "--closed-loop") closedLoop = true;
+        else if (arg == "--drop" && i + 1 < argc) {
+            float t = 0, ms = 0;
+            if (sscanf(argv[++i], "%f:%f", &t, &ms) == 2) drops.push_back(std::make_pair(t, ms));
+        }
+        else path = argv[i];
+    }
+    if (!path || loopUs == 0) {
+        fprintf(stderr, "usage: %s [--loop-ms N] [--summary] [--closed-loop] [--drop T:MS] <log>\n       %s --synth|--synth-follow <out>\n", argv[0], argv[0]);
+        return 2;
+    }
+
+    std::vector<Record> records;
+    if (!loadLog(path, records)) return 1;
+    // 丢弃的记录不送入 UWB，闭环时仍用于统计用户的真实运动
+    std::vector<bool> dropped(records.size(), false);
+    unsigned droppedCount = 0;
+    for (size_t i = 0; i < records.size(); i++) {
+        float t = (uint32_t)(records[i].timeUs - records.front().timeUs) * 1e-6f;
+        for (const auto& d : drops) {
+            if (t >= d.first && t < d.first + d.second * 1e-3f) dropped[i] = true;
+        }
+        if (dropped[i]) droppedCount++;
+    }
+    if (!drops.empty()) fprintf(stderr, "dropped %u records\n", droppedCount);
+
+    // 与固件 setup() + setMode(MODE_FOLLOWING) 相同的初始化
+    hostMicros() = records.front().timeUs;
+    motor.begin();
+    uwb.begin();
+    follow.begin();
+    motor.setSpeed(MOTOR_SPEED_FOLLOW_FORWARD, MOTOR_SPEED_FOLLOW_TURN);
+
+    if (!summaryOnly) printf("time_ms,left_in1,left_in2,right_in1,right_in2,command,distance,angle\n");
+
+    uint32_t last[4] = {0xFFFFFFFF, 0, 0, 0};
+    unsigned long changes = 0;
+    unsigned long loops = 0;
+    unsigned long fixes = 0;
+    unsigned long lastFix = 0;
+    unsigned long stopUs = 0;     // 停车时长
+    unsigned long spinUs = 0;     // 原地转向时长 (两轮反向且前进分量 < 20%)
+    unsigned long nearUs = 0;     // 目标在停止距离内时车仍在转向的时长 (两轮不等)
+    ClosedLoop sim;
+    std::vector<FollowSample> samples;
+    unsigned long nextLoop = records.front().timeUs;
+    unsigned long endUs = records.back().timeUs + 500000UL;
+    size_t next = 0;
+
+    auto wall0 = std::chrono::steady_clock::now();
+    while (next < records.size() || (long)(nextLoop - endUs) < 0) {
+        bool recordFirst = next < records.size() && (long)(records[next].timeUs - nextLoop) <= 0;
+        if (recordFirst) {
+            // 后台接收任务: 字节到达即解析
+            bool skip = dropped[next];
+            Record& r = records[next++];
+            hostAdvanceTo(r.timeUs);
+            if (closedLoop) sim.rewrite(r);
+            if (skip) continue;
+            HardwareSerial& port = (r.channel == 0) ? Serial2 : Serial1;
+            port.hostFeed(r.data.data(), r.data.size());
+            uwb.update();
+            continue;
+        }
+
+        // 控制任务: 跟随模式
+        hostAdvanceTo(nextLoop);
+        nextLoop += loopUs;
+        loops++;
+        uwb.update();
+        follow.updateFromUwb(loopUs * 1e-6f);
+
+        UWBData ud = uwb.getData();
+        if (ud.valid && ud.lastUpdate != lastFix) {
+            fixes++;
+            lastFix = ud.lastUpdate;
+        }
+        if (closedLoop) {
+            sim.step(loopUs * 1e-6f);
+            if (sim.haveUser()) {
+                int16_t wl, wr;
+                motor.getWheels(wl, wr);
+                samples.push_back(FollowSample{micros() * 1e-6f, sim.userRange(), sim.userRange() - sim.travel(),
+                                               0.5f * (wl + wr) * CART_SPEED_PER_DUTY});
+            }
+        }
+        const uint32_t* duty = hostLedcDuty();
+        const char* cmd = motorCommand(duty);
+        if (strcmp(cmd, "STOP") == 0) stopUs += loopUs;
+        int wl = (int)duty[0] - (int)duty[1];
+        int wr = (int)duty[2] - (int)duty[3];
+        if (wl * wr < 0 && 5 * abs(wl + wr) < abs(wl) + abs(wr)) spinUs += loopUs;
+        if (wl != wr && ud.valid && uwb.getPrediction(micros()).distance <= FOLLOW_ENABLE_DISTANCE) {
+            nearUs += loopUs;
+        }
+        if (memcmp(duty, last, sizeof(last)) != 0) {
+            memcpy(last, duty, sizeof(last));
+            changes++;
+            if (!summaryOnly) {
+                UWBData p = uwb.getPrediction(micros());
+                printf("%.1f,%u,%u,%u,%u,%s,%.1f,%.1f\n", micros() / 1000.0, duty[0], duty[1], duty[2], duty[3],
+                       cmd, p.distance, p.angle);
+            }
+        }
+    }
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall0).count();
+    double logSec = (double)(uint32_t)(records.back().timeUs - records.front().timeUs) * 1e-6;
+
+    fprintf(stderr, "records=%u loops=%lu fixes=%lu motor_changes=%lu stop=%.1f s spin=%.1f s near_turn=%.1f s log=%.1f s "
+            "wall=%.3f ms speed=%.0fx\n",
+            (unsigned)records.size(), loops, fixes, changes, stopUs * 1e-6, spinUs * 1e-6, nearUs * 1e-6, logSec,
+            wall * 1e3,
+            logSec / (wall > 0 ? wall : 1e-9));
+    MotorStats ms = motor.getStats();
+    fprintf(stderr, "motor: pwm_writes=%lu skipped=%lu ramp_ticks=%lu\n", (unsigned long)ms.writes,
+            (unsigned long)ms.skipped, (unsigned long)ms.rampTicks);
+    if (closedLoop) {
+        fprintf(stderr, "closed loop: ranges_rewritten=%lu cart travel=%.0f cm\n", sim.rewritten(), sim.travel());
+        printFollowMetrics(samples, loopUs * 1e-6f);
+    }
+    // 与固件 U 命令相同的链路/滤波统计
+    if (summaryOnly) {
+        uwb.printStats(Serial);
+        follow.printStats(Serial);
+    }
+    return 0;
+}